@@ -8,6 +8,9 @@
 static hb_mc_device_t *dev = nullptr;
 static std::vector<int> pkt_data;
 
+// later launches run on a recycled barrier config buffer
+#define NUM_LAUNCHES 2
+
 
 //////////////////////////////////////////////////////
 // Responder to check for packets from the manycore //
@@ -69,17 +72,19 @@ int barrier_test_main(int argc, char *argv[])
     gd = hb_mc_dimension(1,1);
     tgd = hb_mc_dimension(tgx, tgy);
 
-    BSG_CUDA_CALL(hb_mc_kernel_enqueue(dev, gd, tgd, kname, 0, nullptr));
-    BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(dev));
+    for (int launch = 0; launch < NUM_LAUNCHES; launch++) {
+        BSG_CUDA_CALL(hb_mc_kernel_enqueue(dev, gd, tgd, kname, 0, nullptr));
+        BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(dev));
+    }
 
     // cleanup
     BSG_CUDA_CALL(hb_mc_device_program_finish(dev));
     BSG_CUDA_CALL(hb_mc_device_finish(dev));
 
     // check that we got the right number of packets
-    if (static_cast<int>(pkt_data.size()) != tgx*tgy) {
+    if (static_cast<int>(pkt_data.size()) != NUM_LAUNCHES*tgx*tgy) {
         bsg_pr_err("Expected %d packets from %3d X %3d group, received %d\n"
-                   , tgx*tgy
+                   , NUM_LAUNCHES*tgx*tgy
                    , tgx
                    , tgy
                    , static_cast<int>(pkt_data.size()));
@@ -88,22 +93,24 @@ int barrier_test_main(int argc, char *argv[])
 
     // validate results by checking that the expected packets arrived in-order
     int id = 0;
-    for (int x = 0; x < tgx; x++) {
-        for (int y = 0; y < tgy; y++) {
-            int data = pkt_data[id];
-            int dx = (data >> 16) & 0xffff;
-            int dy = data & 0xffff;
-
-            if (x != dx || y != dy) {
-                bsg_pr_err("Packet %d: expected from (%d,%d) but found (%d,%d)\n"
-                           , id
-                           , x
-                           , y
-                           , dx
-                           , dy);
-                return HB_MC_FAIL;
+    for (int launch = 0; launch < NUM_LAUNCHES; launch++) {
+        for (int x = 0; x < tgx; x++) {
+            for (int y = 0; y < tgy; y++) {
+                int data = pkt_data[id];
+                int dx = (data >> 16) & 0xffff;
+                int dy = data & 0xffff;
+
+                if (x != dx || y != dy) {
+                    bsg_pr_err("Packet %d: expected from (%d,%d) but found (%d,%d)\n"
+                               , id
+                               , x
+                               , y
+                               , dx
+                               , dy);
+                    return HB_MC_FAIL;
+                }
+                id++;
             }
-            id++;
         }
     }
     return HB_MC_SUCCESS;
@@ -0,0 +1,170 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <stdio.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+
+#define LOOKUP_ITERATIONS 1000
+#define LAUNCH_ITERATIONS 4
+
+/*!
+ * Measures the host-side cost of launching kernels.
+ *
+ * First, the symbols written by the CUDA runtime on every launch are
+ * looked up repeatedly, once by scanning the ELF symbol tables and
+ * once through a program symbol index. Then a grid of empty tile
+ * groups is launched several times and the wall-clock time per tile
+ * group is reported.
+ */
+
+static const char *runtime_symbols[] = {
+        "cuda_argc", "cuda_argv_ptr", "cuda_finish_signal_addr",
+        "cuda_kernel_ptr", "cuda_finish_signal_val", "cuda_kernel_not_loaded_val",
+        "__bsg_grp_org_x", "__bsg_grp_org_y", "__bsg_x", "__bsg_y", "__bsg_id",
+        "__bsg_tile_group_id_x", "__bsg_tile_group_id_y", "__bsg_tile_group_id",
+        "__bsg_grid_dim_x", "__bsg_grid_dim_y", "kernel_launch_overhead",
+};
+
+#define NUM_RUNTIME_SYMBOLS (sizeof(runtime_symbols)/sizeof(runtime_symbols[0]))
+
+static double now_sec(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int benchmark_symbol_lookup(const char *bin_path)
+{
+        unsigned char *bin;
+        size_t bin_size;
+        hb_mc_loader_symbol_index_t *index;
+        hb_mc_eva_t eva, eva_indexed;
+        double start, scan_sec, index_sec, build_sec;
+        int rc;
+
+        rc = hb_mc_loader_read_program_file(bin_path, &bin, &bin_size);
+        if (rc != HB_MC_SUCCESS)
+                return rc;
+
+        start = now_sec();
+        rc = hb_mc_loader_symbol_index_init(bin, bin_size, &index);
+        build_sec = now_sec() - start;
+        if (rc != HB_MC_SUCCESS) {
+                free(bin);
+                return rc;
+        }
+
+        // Check that both lookups agree before timing them
+        for (int s = 0; s < NUM_RUNTIME_SYMBOLS; s++) {
+                rc = hb_mc_loader_symbol_to_eva(bin, bin_size, runtime_symbols[s], &eva);
+                if (rc != HB_MC_SUCCESS)
+                        goto cleanup;
+                rc = hb_mc_loader_symbol_index_to_eva(index, runtime_symbols[s], &eva_indexed);
+                if (rc != HB_MC_SUCCESS)
+                        goto cleanup;
+                if (eva != eva_indexed) {
+                        bsg_pr_test_err("Symbol '%s': scan found 0x%08x, index found 0x%08x\n",
+                                        runtime_symbols[s], eva, eva_indexed);
+                        rc = HB_MC_FAIL;
+                        goto cleanup;
+                }
+        }
+
+        start = now_sec();
+        for (int i = 0; i < LOOKUP_ITERATIONS; i++)
+                for (int s = 0; s < NUM_RUNTIME_SYMBOLS; s++)
+                        hb_mc_loader_symbol_to_eva(bin, bin_size, runtime_symbols[s], &eva);
+        scan_sec = now_sec() - start;
+
+        start = now_sec();
+        for (int i = 0; i < LOOKUP_ITERATIONS; i++)
+                for (int s = 0; s < NUM_RUNTIME_SYMBOLS; s++)
+                        hb_mc_loader_symbol_index_to_eva(index, runtime_symbols[s], &eva);
+        index_sec = now_sec() - start;
+
+        bsg_pr_test_info("Symbol index build: %.3f us\n", build_sec * 1e6);
+        bsg_pr_test_info("Symbol lookup (ELF scan): %.1f ns/lookup\n",
+                         scan_sec * 1e9 / (LOOKUP_ITERATIONS * NUM_RUNTIME_SYMBOLS));
+        bsg_pr_test_info("Symbol lookup (index):    %.1f ns/lookup\n",
+                         index_sec * 1e9 / (LOOKUP_ITERATIONS * NUM_RUNTIME_SYMBOLS));
+
+cleanup:
+        hb_mc_loader_symbol_index_exit(index);
+        free(bin);
+        return rc;
+}
+
+int kernel_launch_overhead (int argc, char **argv) {
+        int rc;
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Launch Overhead Benchmark.\n\n");
+
+        BSG_CUDA_CALL(benchmark_symbol_lookup(bin_path));
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        hb_mc_dimension_t grid_dim = { .x = 4, .y = 2};
+        hb_mc_dimension_t tg_dim = { .x = 2, .y = 2};
+        uint32_t cuda_argv[1];
+
+        double start = now_sec();
+        for (int i = 0; i < LAUNCH_ITERATIONS; i++) {
+                BSG_CUDA_CALL(hb_mc_kernel_enqueue (&device, grid_dim, tg_dim, "kernel_launch_overhead", 0, cuda_argv));
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+        }
+        double launch_sec = now_sec() - start;
+
+        bsg_pr_test_info("Launched %d tile groups of %dx%d in %.3f s: %.3f ms/tile group\n",
+                         LAUNCH_ITERATIONS * grid_dim.x * grid_dim.y, tg_dim.x, tg_dim.y,
+                         launch_sec, launch_sec * 1e3 / (LAUNCH_ITERATIONS * grid_dim.x * grid_dim.y));
+
+        BSG_CUDA_CALL(hb_mc_device_program_finish(&device));
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_launch_overhead", kernel_launch_overhead);
@@ -77,6 +77,10 @@ _REPO_ROOT ?= $(shell git rev-parse --show-toplevel)
 BSG_MANYCORE_SPMD_PATH = $(BSG_MANYCORE_DIR)/software/spmd/
 BSG_MANYCORE_CUDALITE_PATH = $(BSG_MANYCORE_SPMD_PATH)/bsg_cuda_lite_runtime/
 BSG_MANYCORE_CUDALITE_MAIN_PATH = $(BSG_MANYCORE_CUDALITE_PATH)/main
+# The CUDA-Lite runtime loop linked into every kernel. Kernels that
+# bring their own runtime (e.g. one that reads the launch descriptor)
+# set this before including riscv.mk.
+BSG_MANYCORE_CUDALITE_MAIN ?= $(BSG_MANYCORE_CUDALITE_MAIN_PATH)/main.c
 
 BSG_MANYCORE_LIB_PATH    = $(BSG_MANYCORE_DIR)/software/bsg_manycore_lib
 BSG_MANYCORE_COMMON_PATH = $(BSG_MANYCORE_SPMD_PATH)/common/
@@ -286,7 +290,7 @@ $(filter %.c.rvo,$(LIBBSG_MANYCORE_OBJECTS)): %.c.rvo:$(BSG_MANYCORE_LIB_PATH)/%
 $(filter %.S.rvo,$(LIBBSG_MANYCORE_OBJECTS)): %.S.rvo:$(BSG_MANYCORE_LIB_PATH)/%.S
 	$(_RISCV_GCC) $(RISCV_CFLAGS) $(RISCV_DEFINES) -D__ASSEMBLY__=1 $(RISCV_INCLUDES) -c $< -o $@
 
-main.rvo: $(BSG_MANYCORE_CUDALITE_MAIN_PATH)/main.c
+main.rvo: $(BSG_MANYCORE_CUDALITE_MAIN)
 	$(_RISCV_GCC) $(RISCV_CFLAGS) $(RISCV_DEFINES) $(RISCV_INCLUDES) -c $< -o $@
 
 %.rvo: %.c
@@ -0,0 +1,14 @@
+// Add one to every element of A, so the host can tell that the
+// kernel ran after the checkpoint was restored.
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+extern "C" __attribute__ ((noinline))
+int kernel_checkpoint(int *A, int n) {
+
+    for (int i = __bsg_id; i < n; i += bsg_tiles_X * bsg_tiles_Y)
+        A[i] += 1;
+
+    return 0;
+}
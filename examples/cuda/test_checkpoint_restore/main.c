@@ -0,0 +1,180 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Save a checkpoint in one process and restore it in another. The
+// save step writes an array to DRAM and saves; the restore step is
+// started with --checkpoint-restore, checks the array right after
+// hb_mc_device_init() and then loads a program and launches a kernel
+// on the restored hardware. The Makefile's checkpoint.log runs both.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_cuda.h>
+#include <bsg_manycore_vcache.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+// Must match CHECKPOINT in the Makefile
+#define CHECKPOINT "test_checkpoint_restore.ckpt"
+
+#define ARRAY_LEN  256
+#define BASE_ADDR HB_MC_VCACHE_EPA_BASE
+#define SEED       0x1000
+
+static hb_mc_npa_t checkpoint_npa(hb_mc_device_t *device)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(device->mc);
+        hb_mc_coordinate_t pod = {0, 0};
+        return hb_mc_npa(hb_mc_config_pod_dram_start(cfg, pod), BASE_ADDR);
+}
+
+static int checkpoint_save(hb_mc_device_t *device)
+{
+        uint32_t data[ARRAY_LEN];
+        for (size_t i = 0; i < ARRAY_LEN; i++)
+                data[i] = SEED + i;
+
+        hb_mc_npa_t npa = checkpoint_npa(device);
+        BSG_CUDA_CALL(hb_mc_manycore_write_mem(device->mc, &npa, data, sizeof(data)));
+        BSG_CUDA_CALL(hb_mc_manycore_flush_vcache(device->mc));
+
+        int err = hb_mc_manycore_checkpoint_save(device->mc, CHECKPOINT);
+        if (err == HB_MC_NOIMPL) {
+                bsg_pr_test_info("%s: checkpoints are not supported on this platform\n",
+                                 __func__);
+                return HB_MC_SUCCESS;
+        }
+        return err;
+}
+
+static int checkpoint_check(hb_mc_device_t *device, char *bin_path)
+{
+        /*********************************/
+        /* DRAM matches the save process */
+        /*********************************/
+        uint32_t data[ARRAY_LEN];
+        hb_mc_npa_t npa = checkpoint_npa(device);
+        BSG_CUDA_CALL(hb_mc_manycore_read_mem(device->mc, &npa, data, sizeof(data)));
+
+        int rc = HB_MC_SUCCESS;
+        for (size_t i = 0; i < ARRAY_LEN; i++) {
+                if (data[i] != SEED + i) {
+                        bsg_pr_err("%s: DRAM mismatch @ index %zu: "
+                                   "read 0x%08" PRIx32 ", expected 0x%08zx\n",
+                                   __func__, i, data[i], SEED + i);
+                        rc = HB_MC_FAIL;
+                }
+        }
+        if (rc != HB_MC_SUCCESS)
+                return rc;
+
+        /********************************/
+        /* Kernels launch after restore */
+        /********************************/
+        hb_mc_dimension_t tg_dim = { .x = 2, .y = 2 };
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1 };
+
+        BSG_CUDA_CALL(hb_mc_device_program_init(device, bin_path, ALLOC_NAME, 0));
+
+        int A_host[ARRAY_LEN], A_result[ARRAY_LEN];
+        for (int i = 0; i < ARRAY_LEN; i++)
+                A_host[i] = i * 7;
+
+        hb_mc_eva_t A_dev;
+        BSG_CUDA_CALL(hb_mc_device_malloc(device, sizeof(A_host), &A_dev));
+        BSG_CUDA_CALL(hb_mc_device_memcpy(device, (void *) ((intptr_t) A_dev), A_host,
+                                          sizeof(A_host), HB_MC_MEMCPY_TO_DEVICE));
+
+        hb_mc_eva_t kernel_argv[] = {A_dev, ARRAY_LEN};
+        BSG_CUDA_CALL(hb_mc_kernel_enqueue (device, grid_dim, tg_dim, "kernel_checkpoint",
+                                            ARRAY_SIZE(kernel_argv), kernel_argv));
+        BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(device));
+
+        BSG_CUDA_CALL(hb_mc_device_memcpy(device, A_result, (void *) ((intptr_t) A_dev),
+                                          sizeof(A_result), HB_MC_MEMCPY_TO_HOST));
+
+        for (int i = 0; i < ARRAY_LEN; i++) {
+                if (A_result[i] != A_host[i] + 1) {
+                        bsg_pr_err("%s: Mismatch: A[%d] = %d, Expected %d\n",
+                                   __func__, i, A_result[i], A_host[i] + 1);
+                        rc = HB_MC_FAIL;
+                }
+        }
+        return rc;
+}
+
+int test_checkpoint_restore (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Checkpoint Restore test (%s step)\n\n", test_name);
+
+        int restore = !strcmp(test_name, "restore");
+        if (!restore && strcmp(test_name, "save")) {
+                bsg_pr_err("%s: unknown step '%s', expected save or restore\n",
+                           __func__, test_name);
+                return HB_MC_FAIL;
+        }
+
+        // The save step passes without a checkpoint on platforms
+        // that cannot save one, so there is nothing to restore
+        if (restore && (args.checkpoint_restore == NULL ||
+                        access(args.checkpoint_restore, R_OK) != 0)) {
+                bsg_pr_test_info("%s: no checkpoint to restore\n", __func__);
+                return HB_MC_SUCCESS;
+        }
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+
+        int rc = restore ?
+                checkpoint_check(&device, bin_path) :
+                checkpoint_save(&device);
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        if (restore) {
+                remove(args.checkpoint_restore);
+                remove(CHECKPOINT ".dram");
+        }
+
+        return rc;
+}
+
+declare_program_main("Checkpoint Restore", test_checkpoint_restore);
@@ -13,3 +13,15 @@ int kernel_dma(int *A, int *B, int n) {
 
     return 0;
 }
+
+// Leaves B dirty in the victim caches for the host to DMA over
+extern "C" __attribute__ ((noinline))
+int kernel_dma_fill(int *B, int n, int val) {
+
+    if (__bsg_id == 0) {
+        for (int i = 0; i < n; i++)
+            B[i] = val;
+    }
+
+    return 0;
+}
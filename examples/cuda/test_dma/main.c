@@ -36,6 +36,7 @@
 #include <unistd.h>
 #include <sys/ioctl.h>
 #include <stdio.h>
+#include <inttypes.h>
 #include <bsg_manycore_regression.h>
 #include <sys/stat.h>
 
@@ -43,6 +44,44 @@
 #define ARRAY_SIZE(x)                           \
     (sizeof(x)/sizeof(x[0]))
 
+/*
+ * Dirty every line of B from a kernel, DMA A over B, and read B back
+ * through the caches. A line left dirty or valid in a victim cache
+ * by the DMA would show up as the fill value.
+ */
+static int test_dma_over_dirty(hb_mc_device_t *device, hb_mc_eva_t B_dev,
+                               int *A_host, int N, const char *path)
+{
+        int B_host[N];
+        hb_mc_dimension_t tg_dim = { .x = 1, .y = 1 };
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1 };
+        hb_mc_eva_t kernel_argv[] = {B_dev, (hb_mc_eva_t)N, (hb_mc_eva_t)-1};
+
+        BSG_CUDA_CALL(hb_mc_kernel_enqueue (device, grid_dim, tg_dim, "kernel_dma_fill",
+                                            ARRAY_SIZE(kernel_argv), kernel_argv));
+        BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(device));
+
+        hb_mc_dma_htod_t htod = {
+                .d_addr = B_dev,
+                .h_addr = A_host,
+                .size   = sizeof(int) * N
+        };
+        BSG_CUDA_CALL(hb_mc_device_dma_to_device(device, &htod, 1));
+        BSG_CUDA_CALL(hb_mc_device_memcpy_to_host(device, B_host, B_dev, sizeof(B_host)));
+
+        int rc = HB_MC_SUCCESS;
+        for (int i = 0; i < N; i++) {
+                if (A_host[i] != B_host[i]) {
+                        bsg_pr_err("%s: Mismatch after %s DMA over dirty lines: "
+                                   "B_host[%d] = %d, Expected %d\n",
+                                   __func__, path, i, B_host[i], A_host[i]);
+                        rc = HB_MC_FAIL;
+                }
+        }
+
+        return rc;
+}
+
 int test_dma (int argc, char **argv) {
         char *bin_path, *test_name;
         struct arguments_path args = {NULL, NULL};
@@ -120,6 +159,8 @@ int test_dma (int argc, char **argv) {
                         .size   = sizeof(A_host)
                 };
 
+                hb_mc_dma_stats_t before, stats;
+                BSG_CUDA_CALL(hb_mc_device_pod_dma_stats(&device, pod, &before));
                 BSG_CUDA_CALL(hb_mc_device_dma_to_device(&device, &htod, 1));
 
                 /**********************************************************************/
@@ -165,6 +206,47 @@ int test_dma (int argc, char **argv) {
                         }
                 }
 
+                /*****************************************************/
+                /* Both batches are small: only their lines are      */
+                /* maintained. Forcing a sweep must give the same B. */
+                /*****************************************************/
+                BSG_CUDA_CALL(hb_mc_device_pod_dma_stats(&device, pod, &stats));
+                if (stats.targeted_batches - before.targeted_batches != 2 ||
+                    stats.swept_batches != before.swept_batches) {
+                        bsg_pr_err("%s: expected 2 targeted and 0 swept batches, got %" PRIu64 " and %" PRIu64 "\n",
+                                   __func__, stats.targeted_batches - before.targeted_batches,
+                                   stats.swept_batches - before.swept_batches);
+                        rc = HB_MC_FAIL;
+                }
+
+                BSG_CUDA_CALL(hb_mc_device_pod_set_dma_sweep_threshold(&device, pod, 0));
+                memset(B_host, 0, sizeof(B_host));
+                BSG_CUDA_CALL(hb_mc_device_dma_to_host(&device, &dtoh, 1));
+                BSG_CUDA_CALL(hb_mc_device_pod_dma_stats(&device, pod, &stats));
+                if (stats.swept_batches - before.swept_batches != 1) {
+                        bsg_pr_err("%s: expected 1 swept batch, got %" PRIu64 "\n",
+                                   __func__, stats.swept_batches - before.swept_batches);
+                        rc = HB_MC_FAIL;
+                }
+
+                for (int i = 0; i < N; i++) {
+                        if (A_host[i] != B_host[i]) {
+                                bsg_pr_err("%s: Mismatch after sweep: B_host[%d] = %d, Expected %d\n",
+                                           __func__, i, B_host[i], A_host[i]);
+                                rc = HB_MC_FAIL;
+                        }
+                }
+
+                /******************************************************/
+                /* DMA over lines a kernel left dirty, on both paths. */
+                /******************************************************/
+                if (test_dma_over_dirty(&device, B_dev, A_host, N, "swept") != HB_MC_SUCCESS)
+                        rc = HB_MC_FAIL;
+
+                BSG_CUDA_CALL(hb_mc_device_pod_set_dma_sweep_threshold(&device, pod, before.sweep_threshold));
+                if (test_dma_over_dirty(&device, B_dev, A_host, N, "targeted") != HB_MC_SUCCESS)
+                        rc = HB_MC_FAIL;
+
                 if (rc != HB_MC_SUCCESS) {
                         BSG_CUDA_CALL(hb_mc_device_finish(&device));
                         return rc;
@@ -0,0 +1,182 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Load an array from a file into device DRAM through the DMA backdoor,
+// copy it on the device, dump the copy back to a file and compare.
+// The Makefile also passes --dram-load and --dram-dump: the runtime
+// loads DRAM_LOAD_FILE when the program is loaded, the kernel copies it
+// to DRAM_DUMP_EVA, and the runtime dumps that to DRAM_DUMP_FILE when
+// the program finishes.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_cuda.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+#define A_FILE "test_dma_file_A.bin"
+#define B_FILE "test_dma_file_B.bin"
+
+#define DRAM_WORDS (DRAM_DUMP_SIZE / sizeof(int))
+
+static int write_file(const char *path, const void *data, size_t size)
+{
+        FILE *f = fopen(path, "wb");
+        if (f == NULL || fwrite(data, size, 1, f) != 1) {
+                bsg_pr_err("%s: failed to write %s\n", __func__, path);
+                if (f != NULL)
+                        fclose(f);
+                return HB_MC_FAIL;
+        }
+        fclose(f);
+        return HB_MC_SUCCESS;
+}
+
+static int read_file(const char *path, void *data, size_t size)
+{
+        FILE *f = fopen(path, "rb");
+        if (f == NULL || fread(data, size, 1, f) != 1) {
+                bsg_pr_err("%s: failed to read %s\n", __func__, path);
+                if (f != NULL)
+                        fclose(f);
+                return HB_MC_FAIL;
+        }
+        fclose(f);
+        return HB_MC_SUCCESS;
+}
+
+int test_dma_file (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA DMA File test %s\n\n", test_name);
+
+        hb_mc_dimension_t tg_dim = { .x = 1, .y = 1 };
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1 };
+
+        // --dram-load reads this when the program is loaded
+        int C_host[DRAM_WORDS], D_host[DRAM_WORDS];
+        for (int i = 0; i < DRAM_WORDS; i++)
+                C_host[i] = i * 7 + 5;
+        BSG_CUDA_CALL(write_file(DRAM_LOAD_FILE, C_host, sizeof(C_host)));
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        /**********************************************/
+        /* Write A to a file and load it onto the pod */
+        /**********************************************/
+        // Span every victim cache of the pod
+        int N = device.mc->config.pod_shape.x * 2 * device.mc->config.vcache_block_words;
+        int A_host[N], B_host[N];
+        for (int i = 0; i < N; i++)
+                A_host[i] = i * 3 + 1;
+
+        BSG_CUDA_CALL(write_file(A_FILE, A_host, sizeof(A_host)));
+
+        hb_mc_eva_t A_dev, B_dev;
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, sizeof(A_host), &A_dev));
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, sizeof(B_host), &B_dev));
+
+        size_t size;
+        BSG_CUDA_CALL(hb_mc_device_dma_file_to_device(&device, A_dev, A_FILE, &size));
+        if (size != sizeof(A_host)) {
+                bsg_pr_err("%s: loaded %zu bytes, expected %zu\n", __func__, size, sizeof(A_host));
+                return HB_MC_FAIL;
+        }
+
+        /***********************/
+        /* Copy A to B on pod  */
+        /***********************/
+        hb_mc_eva_t kernel_argv[] = {A_dev, B_dev, (hb_mc_eva_t)N};
+        BSG_CUDA_CALL(hb_mc_kernel_enqueue (&device, grid_dim, tg_dim, "kernel_dma",
+                                            ARRAY_SIZE(kernel_argv), kernel_argv));
+        BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+        /*****************************************************/
+        /* Copy the --dram-load range to the --dram-dump one */
+        /*****************************************************/
+        hb_mc_eva_t dram_argv[] = {DRAM_LOAD_EVA, DRAM_DUMP_EVA, (hb_mc_eva_t)DRAM_WORDS};
+        BSG_CUDA_CALL(hb_mc_kernel_enqueue (&device, grid_dim, tg_dim, "kernel_dma",
+                                            ARRAY_SIZE(dram_argv), dram_argv));
+        BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+        /***********************************/
+        /* Dump B to a file and compare it */
+        /***********************************/
+        BSG_CUDA_CALL(hb_mc_device_dma_device_to_file(&device, B_dev, sizeof(B_host), B_FILE));
+
+        BSG_CUDA_CALL(read_file(B_FILE, B_host, sizeof(B_host)));
+
+        int rc = HB_MC_SUCCESS;
+        for (int i = 0; i < N; i++) {
+                if (A_host[i] != B_host[i]) {
+                        bsg_pr_err("%s: Mismatch: B_host[%d] = %d, Expected %d\n",
+                                   __func__, i, B_host[i], A_host[i]);
+                        rc = HB_MC_FAIL;
+                }
+        }
+
+        remove(A_FILE);
+        remove(B_FILE);
+
+        // --dram-dump writes its file here, named per pod if there are several
+        char dump_file[256];
+        if (device.num_pods > 1)
+                snprintf(dump_file, sizeof(dump_file), "%s.pod%d", DRAM_DUMP_FILE, device.default_pod_id);
+        else
+                snprintf(dump_file, sizeof(dump_file), "%s", DRAM_DUMP_FILE);
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        BSG_CUDA_CALL(read_file(dump_file, D_host, sizeof(D_host)));
+        for (int i = 0; i < DRAM_WORDS; i++) {
+                if (C_host[i] != D_host[i]) {
+                        bsg_pr_err("%s: Mismatch: %s[%d] = %d, Expected %d\n",
+                                   __func__, dump_file, i, D_host[i], C_host[i]);
+                        rc = HB_MC_FAIL;
+                }
+        }
+
+        remove(DRAM_LOAD_FILE);
+        remove(dump_file);
+
+        return rc;
+}
+
+declare_program_main("DMA File", test_dma_file);
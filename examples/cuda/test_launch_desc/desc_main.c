@@ -0,0 +1,66 @@
+// A minimal CUDA-Lite runtime loop that takes its configuration from
+// the launch descriptor instead of the per-symbol configuration.
+//
+// Defining __cuda_launch_desc opts the program in: the host writes one
+// descriptor per tile and no longer writes __bsg_x, cuda_argc, etc.
+// The loop copies the descriptor into the variables the manycore
+// library reads, calls the kernel, and signals the host when it returns.
+
+#include "bsg_manycore.h"
+#include "launch_desc.h"
+
+#define MAX_ARGS 8
+
+volatile cuda_launch_desc_t __cuda_launch_desc __attribute__((used));
+volatile uint32_t cuda_kernel_ptr __attribute__((used)) = 0x1;
+
+// defined in bsg_tile_config_vars.c
+extern int __bsg_grp_org_x;
+extern int __bsg_grp_org_y;
+extern int __bsg_x;
+extern int __bsg_y;
+extern int __bsg_id;
+extern int __bsg_tile_group_id_x;
+extern int __bsg_tile_group_id_y;
+extern int __bsg_tile_group_id;
+extern int __bsg_grid_dim_x;
+extern int __bsg_grid_dim_y;
+
+typedef int (*cuda_kernel_t)(uint32_t, uint32_t, uint32_t, uint32_t,
+                             uint32_t, uint32_t, uint32_t, uint32_t);
+
+int main()
+{
+        for (;;) {
+                uint32_t kernel;
+                while ((kernel = cuda_kernel_ptr) == __cuda_launch_desc.kernel_not_loaded_val)
+                        ;
+
+                __bsg_grp_org_x       = __cuda_launch_desc.grp_org_x;
+                __bsg_grp_org_y       = __cuda_launch_desc.grp_org_y;
+                __bsg_x               = __cuda_launch_desc.x;
+                __bsg_y               = __cuda_launch_desc.y;
+                __bsg_id              = __cuda_launch_desc.id;
+                __bsg_tile_group_id_x = __cuda_launch_desc.tile_group_id_x;
+                __bsg_tile_group_id_y = __cuda_launch_desc.tile_group_id_y;
+                __bsg_tile_group_id   = __cuda_launch_desc.tile_group_id;
+                __bsg_grid_dim_x      = __cuda_launch_desc.grid_dim_x;
+                __bsg_grid_dim_y      = __cuda_launch_desc.grid_dim_y;
+
+                uint32_t args[MAX_ARGS] = {0};
+                const uint32_t *argv = (const uint32_t *)__cuda_launch_desc.argv_ptr;
+                for (uint32_t i = 0; i < __cuda_launch_desc.argc && i < MAX_ARGS; i++)
+                        args[i] = argv[i];
+
+                ((cuda_kernel_t)kernel)(args[0], args[1], args[2], args[3],
+                                        args[4], args[5], args[6], args[7]);
+
+                // re-arm before signalling: the host may relaunch right away
+                cuda_kernel_ptr = __cuda_launch_desc.kernel_not_loaded_val;
+                bsg_fence();
+                *(volatile uint32_t *)__cuda_launch_desc.finish_signal_addr
+                        = __cuda_launch_desc.finish_signal_val;
+        }
+
+        return 0;
+}
@@ -0,0 +1,35 @@
+// Records each tile's launch descriptor for the host to check.
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+#include "launch_desc.h"
+
+// words each tile records; must match main.c
+#define RECORD_WORDS 12
+
+extern "C" __attribute__ ((noinline))
+int kernel_launch_desc(uint32_t *records, uint32_t tiles_per_group, uint32_t magic) {
+
+    volatile cuda_launch_desc_t *desc = &__cuda_launch_desc;
+    uint32_t *r = records + (desc->tile_group_id * tiles_per_group + desc->id) * RECORD_WORDS;
+
+    r[0]  = desc->x;
+    r[1]  = desc->y;
+    r[2]  = desc->id;
+    r[3]  = desc->tile_group_id_x;
+    r[4]  = desc->tile_group_id_y;
+    r[5]  = desc->tile_group_id;
+    r[6]  = desc->grid_dim_x;
+    r[7]  = desc->grid_dim_y;
+    r[8]  = desc->grp_org_x;
+    r[9]  = desc->grp_org_y;
+    // the runtime must have handed the same values to the library
+    r[10] = ((uint32_t)__bsg_x == desc->x && (uint32_t)__bsg_y == desc->y
+             && (uint32_t)__bsg_id == desc->id
+             && (uint32_t)__bsg_tile_group_id_x == desc->tile_group_id_x
+             && (uint32_t)__bsg_tile_group_id_y == desc->tile_group_id_y
+             && (uint32_t)__bsg_tile_group_id == desc->tile_group_id);
+    r[11] = magic;
+
+    return 0;
+}
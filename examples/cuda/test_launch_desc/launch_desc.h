@@ -0,0 +1,38 @@
+// Kernel-side copy of hb_mc_cuda_launch_desc_t (see bsg_manycore_cuda.h).
+// The layout must match the host's word for word.
+
+#ifndef LAUNCH_DESC_H
+#define LAUNCH_DESC_H
+
+#include <stdint.h>
+
+typedef struct {
+        uint32_t grp_org_x;
+        uint32_t grp_org_y;
+        uint32_t x;
+        uint32_t y;
+        uint32_t id;
+        uint32_t tile_group_id_x;
+        uint32_t tile_group_id_y;
+        uint32_t tile_group_id;
+        uint32_t grid_dim_x;
+        uint32_t grid_dim_y;
+        uint32_t finish_signal_val;
+        uint32_t kernel_not_loaded_val;
+        uint32_t argc;
+        uint32_t argv_ptr;
+        uint32_t finish_signal_addr;
+        uint32_t barrier_cfg;
+} cuda_launch_desc_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern volatile cuda_launch_desc_t __cuda_launch_desc;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,143 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+#define ARRAY_SIZE(x)                           \
+    (sizeof(x)/sizeof(x[0]))
+
+// words each tile records; must match kernel.cpp
+#define RECORD_WORDS 12
+#define MAGIC 0xCAFE
+
+/*
+ * The kernel binary defines __cuda_launch_desc and links its own
+ * runtime loop (desc_main.c), so every launch goes through the
+ * launch descriptor. Each tile of a 2x2 grid of 2x2 tile groups
+ * records its descriptor; check every record against the launch.
+ */
+int test_launch_desc (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running the CUDA Launch Descriptor Kernel %s "
+                         "on a grid of 2x2 tile groups\n\n", test_name);
+
+        hb_mc_dimension_t tg_dim = { .x = 2, .y = 2 };
+        hb_mc_dimension_t grid_dim = { .x = 2, .y = 2 };
+        uint32_t tiles_per_group = tg_dim.x * tg_dim.y;
+        uint32_t tiles = tiles_per_group * grid_dim.x * grid_dim.y;
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+
+        hb_mc_pod_id_t pod;
+        hb_mc_device_foreach_pod_id(&device, pod)
+        {
+                bsg_pr_test_info("Loading program for %s onto pod %d\n",
+                                 test_name, pod);
+
+                BSG_CUDA_CALL(hb_mc_device_set_default_pod(&device, pod));
+                BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+                /*****************************************************/
+                /* Fill the records with a value no field can take.  */
+                /*****************************************************/
+                size_t records_sz = sizeof(uint32_t) * RECORD_WORDS * tiles;
+                uint32_t *records = (uint32_t *) malloc(records_sz);
+                if (records == NULL) {
+                        bsg_pr_err("%s: failed to allocate records\n", __func__);
+                        return HB_MC_NOMEM;
+                }
+                memset(records, 0xff, records_sz);
+
+                hb_mc_eva_t records_dev;
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, records_sz, &records_dev));
+                BSG_CUDA_CALL(hb_mc_device_memcpy_to_device(&device, records_dev, records, records_sz));
+
+                hb_mc_eva_t kernel_argv[] = {records_dev, tiles_per_group, MAGIC};
+                BSG_CUDA_CALL(hb_mc_kernel_enqueue (&device, grid_dim, tg_dim, "kernel_launch_desc",
+                                                    ARRAY_SIZE(kernel_argv), kernel_argv));
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+                BSG_CUDA_CALL(hb_mc_device_memcpy_to_host(&device, records, records_dev, records_sz));
+
+                /*****************************************************/
+                /* Record (g, t) must come from tile t of group g.   */
+                /*****************************************************/
+                int rc = HB_MC_SUCCESS;
+                for (uint32_t g = 0; g < grid_dim.x * grid_dim.y; g++) {
+                        const uint32_t *first = &records[g * tiles_per_group * RECORD_WORDS];
+                        for (uint32_t t = 0; t < tiles_per_group; t++) {
+                                const uint32_t *r = &records[(g * tiles_per_group + t) * RECORD_WORDS];
+                                uint32_t expected[RECORD_WORDS] = {
+                                        t % tg_dim.x, t / tg_dim.x, t,
+                                        g % grid_dim.x, g / grid_dim.x, g,
+                                        grid_dim.x, grid_dim.y,
+                                        first[8], first[9],
+                                        1, MAGIC
+                                };
+                                for (int w = 0; w < RECORD_WORDS; w++) {
+                                        if (r[w] != expected[w]) {
+                                                bsg_pr_err("%s: tile group %" PRIu32 " tile %" PRIu32
+                                                           ": word %d = 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                                                           __func__, g, t, w, r[w], expected[w]);
+                                                rc = HB_MC_FAIL;
+                                        }
+                                }
+                        }
+                }
+
+                free(records);
+
+                if (rc != HB_MC_SUCCESS) {
+                        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+                        return rc;
+                }
+
+                BSG_CUDA_CALL(hb_mc_device_program_finish(&device));
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("CUDA Launch Descriptor", test_launch_desc);
@@ -0,0 +1,68 @@
+// A persistent dispatcher and a small kernel for it to run.
+// The dispatcher stays resident and runs each work descriptor the host
+// pushes, instead of being relaunched for every kernel invocation.
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+#include "bsg_cuda_lite_barrier.h"
+
+#define WORK_MAX_ARGS 8
+
+// must match hb_mc_cuda_work_desc_t
+typedef struct {
+        unsigned kernel_ptr;
+        unsigned argc;
+        unsigned argv[WORK_MAX_ARGS];
+        unsigned seq;
+        unsigned reserved;
+} work_desc_t;
+
+// must match hb_mc_cuda_work_queue_t
+typedef struct {
+        unsigned capacity;
+        unsigned done_addr;
+        unsigned reserved[2];
+} work_queue_t;
+
+typedef int (*work_fn_t)(unsigned, unsigned, unsigned, unsigned,
+                         unsigned, unsigned, unsigned, unsigned);
+
+extern "C" __attribute__ ((noinline))
+int kernel_dispatch(work_queue_t *queue) {
+        volatile work_desc_t *slots = (volatile work_desc_t *) (queue + 1);
+        volatile unsigned *done = (volatile unsigned *) queue->done_addr;
+        unsigned capacity = queue->capacity;
+
+        bsg_barrier_hw_tile_group_init();
+
+        for (unsigned n = 0; ; n++) {
+                volatile work_desc_t *desc = &slots[n % capacity];
+
+                // descriptor n is valid once its sequence number is n + 1
+                while (desc->seq != n + 1)
+                        ;
+
+                if (desc->kernel_ptr == 0)
+                        return 0;
+
+                // unused argument registers are harmless
+                work_fn_t fn = (work_fn_t) desc->kernel_ptr;
+                fn(desc->argv[0], desc->argv[1], desc->argv[2], desc->argv[3],
+                   desc->argv[4], desc->argv[5], desc->argv[6], desc->argv[7]);
+
+                // make every tile's stores visible, and let every tile
+                // finish with the slot, before one of them reports
+                bsg_fence();
+                bsg_barrier_hw_tile_group_sync();
+                if (__bsg_id == 0)
+                        *done = n + 1;
+        }
+}
+
+extern "C" __attribute__ ((noinline))
+int kernel_add_one(int *A, int N) {
+        for (int i = __bsg_id; i < N; i += bsg_tiles_X * bsg_tiles_Y)
+                A[i] += 1;
+
+        return 0;
+}
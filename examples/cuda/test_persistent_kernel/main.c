@@ -0,0 +1,113 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+
+#define NUM_LAUNCHES 64
+#define QUEUE_CAPACITY 16
+#define N 256
+
+/*!
+ * Runs a short kernel NUM_LAUNCHES times on a 2x2 tile group, first with
+ * a regular launch per invocation, then by pushing work descriptors to a
+ * persistent dispatcher. Both runs increment every element of A once per
+ * invocation. Prints the cycles each run took.
+*/
+
+int kernel_persistent_kernel (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running %d kernel invocations with regular launches and a persistent dispatcher.\n\n",
+                         NUM_LAUNCHES);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        eva_t A_device;
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(int), &A_device));
+        BSG_CUDA_CALL(hb_mc_device_memset(&device, &A_device, 0, N * sizeof(int)));
+
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1};
+        hb_mc_dimension_t tg_dim = { .x = 2, .y = 2};
+        uint32_t cuda_argv[2] = {A_device, N};
+
+        /* Regular launches: configure, launch and finish a tile group per invocation. */
+        uint64_t launch_start, launch_end;
+        BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device.mc, &launch_start));
+        for (int i = 0; i < NUM_LAUNCHES; i++) {
+                BSG_CUDA_CALL(hb_mc_kernel_enqueue(&device, grid_dim, tg_dim, "kernel_add_one", 2, cuda_argv));
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+        }
+        BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device.mc, &launch_end));
+
+        /* Persistent: push one descriptor per invocation to a resident dispatcher. */
+        hb_mc_persistent_t *persistent;
+        uint64_t persistent_start, persistent_end;
+        BSG_CUDA_CALL(hb_mc_device_pod_persistent_start(&device, device.default_pod_id, tg_dim,
+                                                        "kernel_dispatch", QUEUE_CAPACITY, &persistent));
+        BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device.mc, &persistent_start));
+        for (int i = 0; i < NUM_LAUNCHES; i++) {
+                BSG_CUDA_CALL(hb_mc_persistent_push(persistent, "kernel_add_one", 2, cuda_argv, NULL));
+        }
+        BSG_CUDA_CALL(hb_mc_persistent_synchronize(persistent));
+        BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device.mc, &persistent_end));
+        BSG_CUDA_CALL(hb_mc_persistent_stop(persistent));
+
+        int A_host[N];
+        BSG_CUDA_CALL(hb_mc_device_memcpy_to_host(&device, A_host, A_device, sizeof(A_host)));
+        for (int i = 0; i < N; i++) {
+                if (A_host[i] != 2 * NUM_LAUNCHES) {
+                        bsg_pr_test_err("A[%d] = %d, expected %d\n", i, A_host[i], 2 * NUM_LAUNCHES);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        bsg_pr_test_info("Regular launches: %" PRIu64 " cycles\n", launch_end - launch_start);
+        bsg_pr_test_info("Persistent:       %" PRIu64 " cycles\n", persistent_end - persistent_start);
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_persistent_kernel", kernel_persistent_kernel);
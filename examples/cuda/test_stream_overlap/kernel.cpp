@@ -0,0 +1,13 @@
+// Adds one batch of vectors. Each batch runs on its own tile group,
+// so tile groups from different streams run side by side.
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+extern "C" __attribute__ ((noinline))
+int kernel_vec_add(int *A, int *B, int *C, int N) {
+        for (int i = __bsg_id; i < N; i += bsg_tiles_X * bsg_tiles_Y)
+                C[i] = A[i] + B[i];
+
+        return 0;
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+
+#define NUM_BATCHES 8
+#define NUM_STREAMS 2
+#define N 1024
+
+/*!
+ * Runs NUM_BATCHES vector additions on 2x2 tile groups, first one batch
+ * at a time with blocking copies, then spread over NUM_STREAMS streams.
+ * With streams, the host copies batch i+1 to the device while batch i
+ * is still running, so the streamed run should take fewer cycles.
+*/
+
+static int A_host[NUM_BATCHES][N];
+static int B_host[NUM_BATCHES][N];
+static int C_host[NUM_BATCHES][N];
+
+static int check_results(void)
+{
+        for (int b = 0; b < NUM_BATCHES; b++) {
+                for (int i = 0; i < N; i++) {
+                        if (C_host[b][i] != A_host[b][i] + B_host[b][i]) {
+                                bsg_pr_test_err("Batch %d: C[%d] = %d, expected %d\n",
+                                                b, i, C_host[b][i], A_host[b][i] + B_host[b][i]);
+                                return HB_MC_FAIL;
+                        }
+                }
+        }
+        return HB_MC_SUCCESS;
+}
+
+int kernel_stream_overlap (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running %d batches of vector addition serially and on %d streams.\n\n",
+                         NUM_BATCHES, NUM_STREAMS);
+
+        srand(0);
+        for (int b = 0; b < NUM_BATCHES; b++) {
+                for (int i = 0; i < N; i++) {
+                        A_host[b][i] = rand() & 0xFFFF;
+                        B_host[b][i] = rand() & 0xFFFF;
+                }
+        }
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        eva_t A_device[NUM_BATCHES], B_device[NUM_BATCHES], C_device[NUM_BATCHES];
+        for (int b = 0; b < NUM_BATCHES; b++) {
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(int), &A_device[b]));
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(int), &B_device[b]));
+                BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(int), &C_device[b]));
+        }
+
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1};
+        hb_mc_dimension_t tg_dim = { .x = 2, .y = 2};
+
+        /* Serial: copy in, run, copy out, one batch at a time. */
+        uint64_t serial_start, serial_end;
+        BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device.mc, &serial_start));
+        for (int b = 0; b < NUM_BATCHES; b++) {
+                uint32_t cuda_argv[4] = {A_device[b], B_device[b], C_device[b], N};
+                BSG_CUDA_CALL(hb_mc_device_memcpy_to_device(&device, A_device[b], A_host[b], sizeof(A_host[b])));
+                BSG_CUDA_CALL(hb_mc_device_memcpy_to_device(&device, B_device[b], B_host[b], sizeof(B_host[b])));
+                BSG_CUDA_CALL(hb_mc_kernel_enqueue(&device, grid_dim, tg_dim, "kernel_vec_add", 4, cuda_argv));
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+                BSG_CUDA_CALL(hb_mc_device_memcpy_to_host(&device, C_host[b], C_device[b], sizeof(C_host[b])));
+        }
+        BSG_CUDA_CALL(hb_mc_manycore_get_cycle(device.mc, &serial_end));
+
+        if (check_results() != HB_MC_SUCCESS)
+                return HB_MC_FAIL;
+        memset(C_host, 0, sizeof(C_host));
+
+        /* Streamed: batch b runs on stream b % NUM_STREAMS. */
+        hb_mc_stream_t *streams[NUM_STREAMS];
+        hb_mc_event_t *start, *done[NUM_STREAMS];
+        BSG_CUDA_CALL(hb_mc_event_create(&start));
+        for (int s = 0; s < NUM_STREAMS; s++) {
+                BSG_CUDA_CALL(hb_mc_stream_create(&device, &streams[s]));
+                BSG_CUDA_CALL(hb_mc_event_create(&done[s]));
+        }
+
+        BSG_CUDA_CALL(hb_mc_event_record(start, streams[0]));
+        for (int b = 0; b < NUM_BATCHES; b++) {
+                hb_mc_stream_t *stream = streams[b % NUM_STREAMS];
+                uint32_t cuda_argv[4] = {A_device[b], B_device[b], C_device[b], N};
+                BSG_CUDA_CALL(hb_mc_stream_memcpy_async(stream, (void *) ((intptr_t) A_device[b]), A_host[b],
+                                                        sizeof(A_host[b]), HB_MC_MEMCPY_TO_DEVICE));
+                BSG_CUDA_CALL(hb_mc_stream_memcpy_async(stream, (void *) ((intptr_t) B_device[b]), B_host[b],
+                                                        sizeof(B_host[b]), HB_MC_MEMCPY_TO_DEVICE));
+                BSG_CUDA_CALL(hb_mc_stream_kernel_enqueue(stream, grid_dim, tg_dim, "kernel_vec_add", 4, cuda_argv));
+                BSG_CUDA_CALL(hb_mc_stream_memcpy_async(stream, C_host[b], (void *) ((intptr_t) C_device[b]),
+                                                        sizeof(C_host[b]), HB_MC_MEMCPY_TO_HOST));
+        }
+
+        uint64_t streamed = 0;
+        for (int s = 0; s < NUM_STREAMS; s++) {
+                uint64_t cycles;
+                BSG_CUDA_CALL(hb_mc_event_record(done[s], streams[s]));
+                BSG_CUDA_CALL(hb_mc_event_synchronize(done[s]));
+                BSG_CUDA_CALL(hb_mc_event_elapsed_cycles(start, done[s], &cycles));
+                streamed = cycles > streamed ? cycles : streamed;
+        }
+
+        for (int s = 0; s < NUM_STREAMS; s++) {
+                BSG_CUDA_CALL(hb_mc_stream_destroy(streams[s]));
+                BSG_CUDA_CALL(hb_mc_event_destroy(done[s]));
+        }
+        BSG_CUDA_CALL(hb_mc_event_destroy(start));
+
+        if (check_results() != HB_MC_SUCCESS)
+                return HB_MC_FAIL;
+
+        bsg_pr_test_info("Serial:   %" PRIu64 " cycles\n", serial_end - serial_start);
+        bsg_pr_test_info("Streamed: %" PRIu64 " cycles\n", streamed);
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_stream_overlap", kernel_stream_overlap);
@@ -0,0 +1,12 @@
+// Adds two vectors on one tile group.
+
+#include "bsg_manycore.h"
+#include "bsg_set_tile_x_y.h"
+
+extern "C" __attribute__ ((noinline))
+int kernel_vec_add(int *A, int *B, int *C, int N) {
+        for (int i = __bsg_id; i < N; i += bsg_tiles_X * bsg_tiles_Y)
+                C[i] = A[i] + B[i];
+
+        return 0;
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+
+#define N 1024
+
+/*!
+ * Runs a vector addition on a stream and waits for it only by polling
+ * hb_mc_stream_query() and hb_mc_event_query(), never by synchronizing.
+ * The queries must handle the kernel's finish packet themselves.
+*/
+
+static int A_host[N];
+static int B_host[N];
+static int C_host[N];
+
+int kernel_stream_query (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running vector addition on a polled stream.\n\n");
+
+        srand(0);
+        for (int i = 0; i < N; i++) {
+                A_host[i] = rand() & 0xFFFF;
+                B_host[i] = rand() & 0xFFFF;
+        }
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        eva_t A_device, B_device, C_device;
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(int), &A_device));
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(int), &B_device));
+        BSG_CUDA_CALL(hb_mc_device_malloc(&device, N * sizeof(int), &C_device));
+
+        hb_mc_dimension_t grid_dim = { .x = 1, .y = 1};
+        hb_mc_dimension_t tg_dim = { .x = 2, .y = 2};
+        uint32_t cuda_argv[4] = {A_device, B_device, C_device, N};
+
+        hb_mc_stream_t *stream;
+        hb_mc_event_t *kernel_done;
+        BSG_CUDA_CALL(hb_mc_stream_create(&device, &stream));
+        BSG_CUDA_CALL(hb_mc_event_create(&kernel_done));
+
+        BSG_CUDA_CALL(hb_mc_stream_memcpy_async(stream, (void *) ((intptr_t) A_device), A_host,
+                                                sizeof(A_host), HB_MC_MEMCPY_TO_DEVICE));
+        BSG_CUDA_CALL(hb_mc_stream_memcpy_async(stream, (void *) ((intptr_t) B_device), B_host,
+                                                sizeof(B_host), HB_MC_MEMCPY_TO_DEVICE));
+        BSG_CUDA_CALL(hb_mc_stream_kernel_enqueue(stream, grid_dim, tg_dim, "kernel_vec_add", 4, cuda_argv));
+        BSG_CUDA_CALL(hb_mc_event_record(kernel_done, stream));
+        BSG_CUDA_CALL(hb_mc_stream_memcpy_async(stream, C_host, (void *) ((intptr_t) C_device),
+                                                sizeof(C_host), HB_MC_MEMCPY_TO_HOST));
+
+        /* poll the event, then the stream, until each reports completion */
+        int err;
+        uint64_t polls = 0;
+        while ((err = hb_mc_event_query(kernel_done)) == HB_MC_BUSY)
+                polls++;
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_test_err("Event query failed: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+
+        while ((err = hb_mc_stream_query(stream)) == HB_MC_BUSY)
+                polls++;
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_test_err("Stream query failed: %s\n", hb_mc_strerror(err));
+                return err;
+        }
+        bsg_pr_test_info("Stream completed after %" PRIu64 " polls\n", polls);
+
+        BSG_CUDA_CALL(hb_mc_stream_destroy(stream));
+        BSG_CUDA_CALL(hb_mc_event_destroy(kernel_done));
+
+        for (int i = 0; i < N; i++) {
+                if (C_host[i] != A_host[i] + B_host[i]) {
+                        bsg_pr_test_err("C[%d] = %d, expected %d\n",
+                                        i, C_host[i], A_host[i] + B_host[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_stream_query", kernel_stream_query);
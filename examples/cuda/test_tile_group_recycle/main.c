@@ -0,0 +1,100 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_cuda.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <bsg_manycore_regression.h>
+
+#define ALLOC_NAME "default_allocator"
+
+// more grids than an 8-bit grid id can count
+#define NUM_GRIDS 300
+
+/*!
+ * Runs an empty kernel on a 4x2 grid of 2x2 tile groups NUM_GRIDS times
+ * with one loaded program. Finished tile group slots must be recycled,
+ * so the pod's slot array stops growing after the first grid, and grid
+ * ids must not wrap.
+*/
+
+int kernel_tile_group_recycle (int argc, char **argv) {
+        char *bin_path, *test_name;
+        struct arguments_path args = {NULL, NULL};
+
+        argp_parse (&argp_path, argc, argv, 0, 0, &args);
+        bin_path = args.path;
+        test_name = args.name;
+
+        bsg_pr_test_info("Running %d grids of the CUDA Empty Kernel on a 4x2 grid of 2x2 tile groups.\n\n",
+                         NUM_GRIDS);
+
+        hb_mc_device_t device;
+        BSG_CUDA_CALL(hb_mc_device_init(&device, test_name, 0));
+        BSG_CUDA_CALL(hb_mc_device_program_init(&device, bin_path, ALLOC_NAME, 0));
+
+        hb_mc_pod_t *pod = &device.pods[device.default_pod_id];
+        hb_mc_dimension_t grid_dim = { .x = 4, .y = 2};
+        hb_mc_dimension_t tg_dim = { .x = 2, .y = 2};
+        uint32_t cuda_argv[1];
+
+        uint32_t capacity = 0;
+        for (int grid = 0; grid < NUM_GRIDS; grid++) {
+                BSG_CUDA_CALL(hb_mc_kernel_enqueue (&device, grid_dim, tg_dim, "kernel_empty", 0, cuda_argv));
+                BSG_CUDA_CALL(hb_mc_device_tile_groups_execute(&device));
+
+                // the first grid sizes the slot array; later grids reuse it
+                if (grid == 0) {
+                        capacity = pod->tile_group_capacity;
+                } else if (pod->tile_group_capacity != capacity) {
+                        bsg_pr_test_err("Grid %d: tile group capacity grew from %u to %u\n",
+                                        grid, capacity, pod->tile_group_capacity);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        if (pod->num_grids != NUM_GRIDS) {
+                bsg_pr_test_err("Expected %d grids, pod counted %u\n", NUM_GRIDS, pod->num_grids);
+                return HB_MC_FAIL;
+        }
+
+        if (pod->num_tile_groups_finished != NUM_GRIDS * grid_dim.x * grid_dim.y) {
+                bsg_pr_test_err("Expected %d finished tile groups, pod counted %u\n",
+                                NUM_GRIDS * grid_dim.x * grid_dim.y, pod->num_tile_groups_finished);
+                return HB_MC_FAIL;
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_finish(&device));
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_tile_group_recycle", kernel_tile_group_recycle);
@@ -0,0 +1,177 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Exercises host-issued atomics on DRAM. A queue-tail counter is
+// bumped with hb_mc_manycore_eva_amo32(), one round trip per slot,
+// and every returned index must be unique and in order. A row of
+// counters is then updated with hb_mc_manycore_eva_amo32_multi(),
+// which pipelines the AMOs, and the old values and final contents
+// are checked. Host time per AMO is reported for both paths.
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_eva.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <time.h>
+#include <bsg_manycore_regression.h>
+
+#define TEST_NAME "test_manycore_amo"
+#define N_SLOTS 64
+#define N_COUNTERS 256
+/* EVAs with bit 31 set address DRAM, striped across the vcaches */
+#define TAIL_EVA 0x80000000
+#define COUNTERS_EVA (TAIL_EVA + 0x1000)
+
+static double now(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Reserve N_SLOTS queue slots by bumping a tail index */
+static int test_single(hb_mc_manycore_t *mc, hb_mc_coordinate_t *target)
+{
+        hb_mc_eva_t tail = TAIL_EVA;
+        uint32_t zero = 0, old, final;
+        int err, i;
+
+        err = hb_mc_manycore_eva_write(mc, &default_map, target, &tail, &zero, sizeof(zero));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        double start = now();
+        for (i = 0; i < N_SLOTS; i++) {
+                err = hb_mc_manycore_eva_amo32(mc, &default_map, target, &tail,
+                                               HB_MC_PACKET_OP_REMOTE_AMOADD, 1, &old);
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: amoadd %d failed: %s\n", __func__, i, hb_mc_strerror(err));
+                        return err;
+                }
+                if (old != (uint32_t)i) {
+                        bsg_pr_err("%s: amoadd %d returned slot %" PRIu32 "\n", __func__, i, old);
+                        return HB_MC_FAIL;
+                }
+        }
+        double seconds = now() - start;
+
+        err = hb_mc_manycore_eva_read(mc, &default_map, target, &tail, &final, sizeof(final));
+        if (err != HB_MC_SUCCESS)
+                return err;
+        if (final != N_SLOTS) {
+                bsg_pr_err("%s: tail is %" PRIu32 ", expected %d\n", __func__, final, N_SLOTS);
+                return HB_MC_FAIL;
+        }
+
+        bsg_pr_test_info("%-8s: %d AMOs, %8.3f us host per AMO\n",
+                         "single", N_SLOTS, seconds * 1e6 / N_SLOTS);
+        return HB_MC_SUCCESS;
+}
+
+/* Add i+1 to counter i, then swap in ~i and check what was there */
+static int test_multi(hb_mc_manycore_t *mc, hb_mc_coordinate_t *target)
+{
+        static hb_mc_eva_t evas[N_COUNTERS];
+        static uint32_t init[N_COUNTERS], operands[N_COUNTERS], olds[N_COUNTERS], final[N_COUNTERS];
+        hb_mc_eva_t base = COUNTERS_EVA;
+        int err, i;
+
+        for (i = 0; i < N_COUNTERS; i++) {
+                evas[i] = COUNTERS_EVA + i * sizeof(uint32_t);
+                init[i] = 0x1000 * i;
+                operands[i] = i + 1;
+        }
+
+        err = hb_mc_manycore_eva_write(mc, &default_map, target, &base, init, sizeof(init));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        double start = now();
+        err = hb_mc_manycore_eva_amo32_multi(mc, &default_map, target, evas, N_COUNTERS,
+                                             HB_MC_PACKET_OP_REMOTE_AMOADD, operands, olds);
+        double seconds = now() - start;
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: amoadd batch failed: %s\n", __func__, hb_mc_strerror(err));
+                return err;
+        }
+
+        for (i = 0; i < N_COUNTERS; i++) {
+                if (olds[i] != init[i]) {
+                        bsg_pr_err("%s: amoadd %d returned 0x%08" PRIx32 ", expected 0x%08" PRIx32 "\n",
+                                   __func__, i, olds[i], init[i]);
+                        return HB_MC_FAIL;
+                }
+                operands[i] = ~i;
+        }
+
+        err = hb_mc_manycore_eva_amo32_multi(mc, &default_map, target, evas, N_COUNTERS,
+                                             HB_MC_PACKET_OP_REMOTE_AMOSWAP, operands, olds);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: amoswap batch failed: %s\n", __func__, hb_mc_strerror(err));
+                return err;
+        }
+
+        err = hb_mc_manycore_eva_read(mc, &default_map, target, &base, final, sizeof(final));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (i = 0; i < N_COUNTERS; i++) {
+                if (olds[i] != init[i] + i + 1 || final[i] != (uint32_t)~i) {
+                        bsg_pr_err("%s: counter %d: swapped out 0x%08" PRIx32 ", holds 0x%08" PRIx32 "\n",
+                                   __func__, i, olds[i], final[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        bsg_pr_test_info("%-8s: %d AMOs, %8.3f us host per AMO\n",
+                         "multi", N_COUNTERS, seconds * 1e6 / N_COUNTERS);
+        return HB_MC_SUCCESS;
+}
+
+int test_manycore_amo (int argc, char *argv[]) {
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+        int err, r;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to initialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_coordinate_t target = hb_mc_config_get_origin_vcore(hb_mc_manycore_get_config(mc));
+
+        r = test_single(mc, &target);
+        if (r == HB_MC_SUCCESS)
+                r = test_multi(mc, &target);
+
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_manycore_amo);
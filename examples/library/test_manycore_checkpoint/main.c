@@ -0,0 +1,123 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Save a checkpoint, overwrite DRAM, restore the checkpoint and check
+// that the original data is back. The data is flushed to the DRAM
+// backing memory before saving, and the overwrite is flushed too, so
+// both the model and the DRAM halves of the checkpoint are exercised.
+
+#include <inttypes.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_coordinate.h>
+#include <bsg_manycore_vcache.h>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_printing.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <bsg_manycore_regression.h>
+
+#define TEST_NAME "test_manycore_checkpoint"
+#define CHECKPOINT "test_manycore_checkpoint.ckpt"
+
+#define ARRAY_LEN  256
+#define BASE_ADDR HB_MC_VCACHE_EPA_BASE
+
+static int write_array(hb_mc_manycore_t *mc, hb_mc_coordinate_t dram, uint32_t seed)
+{
+        uint32_t data[ARRAY_LEN];
+        for (size_t i = 0; i < ARRAY_LEN; i++)
+                data[i] = seed + i;
+
+        hb_mc_npa_t npa = hb_mc_npa(dram, BASE_ADDR);
+        int err = hb_mc_manycore_write_mem(mc, &npa, data, sizeof(data));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        return hb_mc_manycore_flush_vcache(mc);
+}
+
+int test_manycore_checkpoint(int argc, char *argv[]) {
+        int err, r = HB_MC_FAIL;
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to intialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod = {0, 0};
+        hb_mc_coordinate_t dram = hb_mc_config_pod_dram_start(cfg, pod);
+
+        if ((err = write_array(mc, dram, 0x1000)) != HB_MC_SUCCESS)
+                goto cleanup;
+
+        err = hb_mc_manycore_checkpoint_save(mc, CHECKPOINT);
+        if (err == HB_MC_NOIMPL) {
+                bsg_pr_test_info("%s: checkpoints are not supported on this platform\n",
+                                 __func__);
+                r = HB_MC_SUCCESS;
+                goto cleanup;
+        } else if (err != HB_MC_SUCCESS) {
+                goto cleanup;
+        }
+
+        if ((err = write_array(mc, dram, 0x2000)) != HB_MC_SUCCESS)
+                goto cleanup;
+
+        if ((err = hb_mc_manycore_checkpoint_restore(mc, CHECKPOINT)) != HB_MC_SUCCESS)
+                goto cleanup;
+
+        uint32_t read_data[ARRAY_LEN];
+        hb_mc_npa_t npa = hb_mc_npa(dram, BASE_ADDR);
+        if ((err = hb_mc_manycore_read_mem(mc, &npa, read_data, sizeof(read_data))) != HB_MC_SUCCESS)
+                goto cleanup;
+
+        r = HB_MC_SUCCESS;
+        for (size_t i = 0; i < ARRAY_LEN; i++) {
+                if (read_data[i] != 0x1000 + i) {
+                        bsg_pr_err("%s: mismatch @ index %zu: "
+                                   "read 0x%08" PRIx32 ", expected 0x%08zx\n",
+                                   __func__, i, read_data[i], 0x1000 + i);
+                        r = HB_MC_FAIL;
+                }
+        }
+
+cleanup:
+        if (err != HB_MC_SUCCESS)
+                bsg_pr_err("%s: %s\n", __func__, hb_mc_strerror(err));
+        remove(CHECKPOINT);
+        remove(CHECKPOINT ".dram");
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_manycore_checkpoint);
@@ -0,0 +1,160 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Measures DRAM-to-host copy throughput through hb_mc_manycore_eva_read().
+// A DRAM EVA range is split at every vcache stripe. The baseline reads
+// each stripe with hb_mc_manycore_read_mem(), which drains every
+// outstanding load before the next stripe starts, as
+// hb_mc_manycore_eva_read() used to. The pipelined path keeps the load-id
+// window full across stripes. Both reads are checked against the data
+// written, and the cycles and host time of each are reported.
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_eva.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <bsg_manycore_regression.h>
+
+#define TEST_NAME "test_manycore_eva_read_pipelined"
+#define DATA_WORDS (16 * 1024)
+/* EVAs with bit 31 set address DRAM, striped across the vcaches */
+#define DRAM_EVA 0x80000000
+
+typedef int (*eva_read_fn)(hb_mc_manycore_t *mc, const hb_mc_eva_map_t *map,
+                           const hb_mc_coordinate_t *tgt, const hb_mc_eva_t *eva,
+                           void *data, size_t sz);
+
+/* The old path: one read_mem, and so one drained load window, per stripe */
+static int eva_read_per_stripe(hb_mc_manycore_t *mc, const hb_mc_eva_map_t *map,
+                               const hb_mc_coordinate_t *tgt, const hb_mc_eva_t *eva,
+                               void *data, size_t sz)
+{
+        char *dst = (char *)data;
+        hb_mc_eva_t curr = *eva;
+        while (sz > 0) {
+                hb_mc_npa_t npa;
+                size_t npa_sz;
+                int err = hb_mc_eva_to_npa(mc, map, tgt, &curr, &npa, &npa_sz);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+                size_t xfer = sz < npa_sz ? sz : npa_sz;
+                err = hb_mc_manycore_read_mem(mc, &npa, dst, xfer);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+                dst += xfer;
+                curr += xfer;
+                sz -= xfer;
+        }
+        return HB_MC_SUCCESS;
+}
+
+static double now(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint32_t write_data[DATA_WORDS], read_data[DATA_WORDS];
+
+static int run(hb_mc_manycore_t *mc, const char *name, eva_read_fn read,
+               hb_mc_coordinate_t *target)
+{
+        hb_mc_eva_t eva = DRAM_EVA;
+        uint64_t start_cycle, end_cycle;
+        int err, i;
+
+        memset(read_data, 0, sizeof(read_data));
+
+        err = hb_mc_manycore_get_cycle(mc, &start_cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+        double start = now();
+
+        err = read(mc, &default_map, target, &eva, read_data, sizeof(read_data));
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: %s: failed to read: %s\n", __func__, name, hb_mc_strerror(err));
+                return err;
+        }
+
+        double seconds = now() - start;
+        err = hb_mc_manycore_get_cycle(mc, &end_cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (i = 0; i < DATA_WORDS; i++) {
+                if (read_data[i] != write_data[i]) {
+                        bsg_pr_err("%s: word %d: read 0x%08" PRIx32 ", wrote 0x%08" PRIx32 "\n",
+                                   name, i, read_data[i], write_data[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        uint64_t cycles = end_cycle - start_cycle;
+        bsg_pr_test_info("%-12s: %zu bytes in %10" PRIu64 " cycles (%6.3f bytes/cycle), %8.3f ms host\n",
+                         name, sizeof(read_data), cycles,
+                         (double)sizeof(read_data) / (cycles ? cycles : 1),
+                         seconds * 1e3);
+        return HB_MC_SUCCESS;
+}
+
+int test_manycore_eva_read_pipelined (int argc, char *argv[]) {
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+        hb_mc_eva_t eva = DRAM_EVA;
+        int err, r, i;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to initialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_coordinate_t target = hb_mc_config_get_origin_vcore(hb_mc_manycore_get_config(mc));
+
+        srand(1);
+        for (i = 0; i < DATA_WORDS; i++)
+                write_data[i] = (uint32_t)rand();
+
+        r = hb_mc_manycore_eva_write(mc, &default_map, &target, &eva, write_data, sizeof(write_data));
+        if (r != HB_MC_SUCCESS)
+                bsg_pr_err("%s: failed to write: %s\n", __func__, hb_mc_strerror(r));
+
+        if (r == HB_MC_SUCCESS)
+                r = run(mc, "per-stripe", eva_read_per_stripe, &target);
+        if (r == HB_MC_SUCCESS)
+                r = run(mc, "pipelined", hb_mc_manycore_eva_read, &target);
+
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_manycore_eva_read_pipelined);
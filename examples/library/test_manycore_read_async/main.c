@@ -0,0 +1,194 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Exercises the split-phase read API. Read requests are issued with
+// hb_mc_manycore_read_async() until every load id is held, a blocking
+// read is interleaved while they are outstanding, and the tickets are
+// then completed out of order with hb_mc_manycore_poll() and
+// hb_mc_manycore_wait(). Released and duplicate tickets are rejected.
+// A zero timeout receive with nothing in flight must return
+// HB_MC_TIMEOUT rather than block.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#define TEST_NAME "test_manycore_read_async"
+#define WORDS 256
+
+static uint32_t out[WORDS], in[WORDS];
+static hb_mc_manycore_ticket_t tickets[WORDS];
+
+static int test_read_async(hb_mc_manycore_t *mc, hb_mc_npa_t *base)
+{
+        hb_mc_response_packet_t rsp;
+        int err, i, n;
+
+        /* nothing is in flight, so a zero timeout must not block */
+        err = hb_mc_manycore_response_rx(mc, &rsp, 0);
+        if (err != HB_MC_TIMEOUT) {
+                bsg_pr_err("%s: idle receive returned %s\n", __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* issue reads until every load id is held */
+        for (n = 0; n < WORDS; n++) {
+                hb_mc_npa_t npa = hb_mc_npa_from_x_y(hb_mc_npa_get_x(base), hb_mc_npa_get_y(base),
+                                                     hb_mc_npa_get_epa(base) + n * sizeof(uint32_t));
+                err = hb_mc_manycore_read_async(mc, &npa, sizeof(uint32_t), &tickets[n]);
+                if (err == HB_MC_BUSY)
+                        break;
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: read_async %d failed: %s\n", __func__, n, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        if (n < 2) {
+                bsg_pr_err("%s: only %d reads could be issued\n", __func__, n);
+                return HB_MC_FAIL;
+        }
+        bsg_pr_test_info("%d reads outstanding\n", n);
+
+        /* a blocking read must not steal a ticket's response */
+        uint32_t word;
+        hb_mc_npa_t last = hb_mc_npa_from_x_y(hb_mc_npa_get_x(base), hb_mc_npa_get_y(base),
+                                              hb_mc_npa_get_epa(base) + (WORDS - 1) * sizeof(uint32_t));
+        err = hb_mc_manycore_read32(mc, &last, &word);
+        if (err != HB_MC_SUCCESS || word != out[WORDS - 1]) {
+                bsg_pr_err("%s: blocking read returned 0x%08" PRIx32 ": %s\n",
+                           __func__, word, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* complete the newest ticket first by polling */
+        do {
+                err = hb_mc_manycore_poll(mc, tickets[n - 1], &in[n - 1]);
+        } while (err == HB_MC_BUSY);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: poll failed: %s\n", __func__, hb_mc_strerror(err));
+                return err;
+        }
+
+        /* then wait on the rest, newest to oldest */
+        for (i = 0; i < (n - 1) / 2; i++) {
+                hb_mc_manycore_ticket_t t = tickets[i];
+                tickets[i] = tickets[n - 2 - i];
+                tickets[n - 2 - i] = t;
+        }
+        uint32_t rest[WORDS];
+        err = hb_mc_manycore_wait(mc, tickets, n - 1, rest, -1);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: wait failed: %s\n", __func__, hb_mc_strerror(err));
+                return err;
+        }
+        for (i = 0; i < n - 1; i++)
+                in[n - 2 - i] = rest[i];
+
+        for (i = 0; i < n; i++) {
+                if (in[i] != out[i]) {
+                        bsg_pr_err("%s: word %d: read 0x%08" PRIx32 ", wrote 0x%08" PRIx32 "\n",
+                                   __func__, i, in[i], out[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        /* a released ticket is no longer outstanding */
+        err = hb_mc_manycore_poll(mc, tickets[0], &word);
+        if (err != HB_MC_INVALID) {
+                bsg_pr_err("%s: poll of a released ticket returned %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* nor can it be waited on */
+        err = hb_mc_manycore_wait(mc, tickets, 1, &word, -1);
+        if (err != HB_MC_INVALID) {
+                bsg_pr_err("%s: wait on a released ticket returned %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* a ticket listed twice is rejected without releasing it */
+        err = hb_mc_manycore_read_async(mc, base, sizeof(uint32_t), &tickets[0]);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: read_async failed: %s\n", __func__, hb_mc_strerror(err));
+                return err;
+        }
+        tickets[1] = tickets[0];
+        err = hb_mc_manycore_wait(mc, tickets, 2, rest, -1);
+        if (err != HB_MC_INVALID) {
+                bsg_pr_err("%s: wait on a duplicate ticket returned %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+        err = hb_mc_manycore_wait(mc, tickets, 1, &word, -1);
+        if (err != HB_MC_SUCCESS || word != out[0]) {
+                bsg_pr_err("%s: wait after a duplicate returned 0x%08" PRIx32 ": %s\n",
+                           __func__, word, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+int test_manycore_read_async (int argc, char *argv[]) {
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+        int err, r, i;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to initialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* the first vcache of pod (0,0) */
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod = {.x=0, .y=0};
+        hb_mc_npa_t npa = hb_mc_npa_from_x_y(hb_mc_config_get_vcore_base_x(cfg),
+                                             hb_mc_config_pod_dram_y(cfg, pod, 0), 0);
+
+        for (i = 0; i < WORDS; i++)
+                out[i] = (uint32_t)rand();
+
+        r = hb_mc_manycore_write_mem(mc, &npa, out, sizeof(out));
+        if (r != HB_MC_SUCCESS)
+                bsg_pr_err("%s: failed to write: %s\n", __func__, hb_mc_strerror(r));
+        else
+                r = test_read_async(mc, &npa);
+
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_manycore_read_async);
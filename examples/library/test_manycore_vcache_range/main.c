@@ -0,0 +1,134 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Writes a pattern that spans several victim cache lines in two vcaches,
+// starting mid-line, then flushes and invalidates only those ranges with
+// hb_mc_manycore_vcache_op_npa_ranges(). If any line in a range were
+// skipped, the invalidate would drop its dirty data and the read back
+// would return stale DRAM contents.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#define TEST_NAME "test_manycore_vcache_range"
+#define LINES 8
+#define RANGES 2
+
+static int run(hb_mc_manycore_t *mc, const hb_mc_manycore_npa_range_t *ranges,
+               hb_mc_packet_cache_op_t first, hb_mc_packet_cache_op_t second, const char *name)
+{
+        uint32_t *out, *in;
+        size_t words = ranges[0].sz / sizeof(uint32_t);
+        int err = HB_MC_SUCCESS, r, i;
+        size_t w;
+
+        out = (uint32_t *)malloc(ranges[0].sz);
+        in = (uint32_t *)malloc(ranges[0].sz);
+        if (!out || !in) {
+                free(out);
+                free(in);
+                return HB_MC_NOMEM;
+        }
+
+        for (r = 0; r < RANGES && err == HB_MC_SUCCESS; r++) {
+                for (w = 0; w < words; w++)
+                        out[w] = (uint32_t)rand();
+
+                err = hb_mc_manycore_write_mem(mc, &ranges[r].npa, out, ranges[r].sz);
+                if (err != HB_MC_SUCCESS)
+                        break;
+
+                err = hb_mc_manycore_vcache_op_npa_ranges(mc, ranges, RANGES, first);
+                if (err == HB_MC_SUCCESS && second != first)
+                        err = hb_mc_manycore_vcache_op_npa_ranges(mc, ranges, RANGES, second);
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: %s: cache op failed: %s\n",
+                                   __func__, name, hb_mc_strerror(err));
+                        break;
+                }
+
+                err = hb_mc_manycore_read_mem(mc, &ranges[r].npa, in, ranges[r].sz);
+                if (err != HB_MC_SUCCESS)
+                        break;
+
+                for (i = 0; i < (int)words; i++) {
+                        if (in[i] != out[i]) {
+                                bsg_pr_err("%s: %s: range %d word %d: read 0x%08" PRIx32
+                                           ", wrote 0x%08" PRIx32 "\n",
+                                           __func__, name, r, i, in[i], out[i]);
+                                err = HB_MC_FAIL;
+                                break;
+                        }
+                }
+        }
+
+        if (err == HB_MC_SUCCESS)
+                bsg_pr_test_info("%-12s: passed\n", name);
+
+        free(out);
+        free(in);
+        return err;
+}
+
+int test_manycore_vcache_range (int argc, char *argv[]) {
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+        hb_mc_manycore_npa_range_t ranges[RANGES];
+        int err, r;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to initialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* the first two vcaches of pod (0,0), starting mid-line */
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod = {.x=0, .y=0};
+        size_t line = hb_mc_config_get_vcache_block_size(cfg);
+        for (r = 0; r < RANGES; r++) {
+                ranges[r].npa = hb_mc_npa_from_x_y(hb_mc_config_get_vcore_base_x(cfg) + r,
+                                                   hb_mc_config_pod_dram_y(cfg, pod, 0),
+                                                   line / 2);
+                ranges[r].sz = LINES * line;
+        }
+
+        r = run(mc, ranges, HB_MC_PACKET_CACHE_OP_AFL, HB_MC_PACKET_CACHE_OP_AINV, "afl+ainv");
+        if (r == HB_MC_SUCCESS)
+                r = run(mc, ranges, HB_MC_PACKET_CACHE_OP_AFLINV, HB_MC_PACKET_CACHE_OP_AFLINV, "aflinv");
+
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_manycore_vcache_range);
@@ -0,0 +1,149 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Measures back-to-back small writes with and without a write session.
+// Each hb_mc_manycore_write_mem() outside a session drains all credits
+// before returning; inside hb_mc_manycore_write_begin() and
+// hb_mc_manycore_write_commit() the writes are posted and fenced once.
+// Both runs are read back and checked, and unbalanced commits must fail.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#define TEST_NAME "test_manycore_write_session"
+#define WRITES 512
+
+static uint32_t out[WRITES], in[WRITES];
+
+static int run(hb_mc_manycore_t *mc, const hb_mc_npa_t *base, const char *name, int session)
+{
+        uint64_t start_cycle, end_cycle;
+        int err, i;
+
+        for (i = 0; i < WRITES; i++)
+                out[i] = (uint32_t)rand();
+
+        err = hb_mc_manycore_get_cycle(mc, &start_cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        if (session) {
+                err = hb_mc_manycore_write_begin(mc);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        /* one small write_mem per word, as the loader and runtime issue them */
+        for (i = 0; i < WRITES; i++) {
+                hb_mc_npa_t npa = hb_mc_npa_from_x_y(hb_mc_npa_get_x(base), hb_mc_npa_get_y(base),
+                                                     hb_mc_npa_get_epa(base) + i * sizeof(uint32_t));
+                err = hb_mc_manycore_write_mem(mc, &npa, &out[i], sizeof(uint32_t));
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: %s: write %d failed: %s\n", __func__, name, i, hb_mc_strerror(err));
+                        return err;
+                }
+        }
+
+        if (session) {
+                err = hb_mc_manycore_write_commit(mc);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        err = hb_mc_manycore_get_cycle(mc, &end_cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        err = hb_mc_manycore_read_mem(mc, base, in, sizeof(in));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (i = 0; i < WRITES; i++) {
+                if (in[i] != out[i]) {
+                        bsg_pr_err("%s: %s: word %d: read 0x%08" PRIx32 ", wrote 0x%08" PRIx32 "\n",
+                                   __func__, name, i, in[i], out[i]);
+                        return HB_MC_FAIL;
+                }
+        }
+
+        bsg_pr_test_info("%-10s: %d writes in %10" PRIu64 " cycles\n",
+                         name, WRITES, end_cycle - start_cycle);
+        return HB_MC_SUCCESS;
+}
+
+static int test_nesting(hb_mc_manycore_t *mc)
+{
+        if (hb_mc_manycore_write_begin(mc) != HB_MC_SUCCESS ||
+            hb_mc_manycore_write_begin(mc) != HB_MC_SUCCESS ||
+            hb_mc_manycore_write_commit(mc) != HB_MC_SUCCESS ||
+            hb_mc_manycore_write_commit(mc) != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: nested sessions failed\n", __func__);
+                return HB_MC_FAIL;
+        }
+
+        if (hb_mc_manycore_write_commit(mc) != HB_MC_INVALID) {
+                bsg_pr_err("%s: commit without a session succeeded\n", __func__);
+                return HB_MC_FAIL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+int test_manycore_write_session (int argc, char *argv[]) {
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+        int err, r;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to initialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* the first vcache of pod (0,0) */
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod = {.x=0, .y=0};
+        hb_mc_npa_t npa = hb_mc_npa_from_x_y(hb_mc_config_get_vcore_base_x(cfg),
+                                             hb_mc_config_pod_dram_y(cfg, pod, 0), 0);
+
+        r = run(mc, &npa, "per-write", 0);
+        if (r == HB_MC_SUCCESS)
+                r = run(mc, &npa, "session", 1);
+        if (r == HB_MC_SUCCESS)
+                r = test_nesting(mc);
+
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_manycore_write_session);
@@ -0,0 +1,309 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Churns many small allocations, the pattern of a tensor library, through
+// two allocators: the std::list first-fit manager that the CUDA library
+// used to use, and hb_mc_segfit_allocator. Every allocation is checked
+// for alignment, bounds and overlap. The host time of each allocator is
+// reported, followed by checks of resize, statistics and coalescing.
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore_segfit_allocator.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <map>
+#include <vector>
+
+#define HEAP_START 0x10000
+#define HEAP_SIZE  (256u << 20)
+#define ALIGNMENT  64
+#define LIVE_MAX   4096
+#define CHURN_OPS  200000
+
+/* The old policy: first-fit over a free list, linear search of the busy list */
+class list_first_fit {
+        std::list<std::pair<uint64_t, uint64_t> > free_list, busy_list;
+        uint64_t alignment;
+        void coalesce() {
+                free_list.sort();
+                auto curr = free_list.begin();
+                auto next = std::next(curr);
+                while (next != free_list.end()) {
+                        if (curr->first + curr->second == next->first) {
+                                curr->second += next->second;
+                                next = free_list.erase(next);
+                        } else {
+                                curr = next++;
+                        }
+                }
+        }
+public:
+        list_first_fit(uint64_t start, uint64_t size, uint64_t align) : alignment(align) {
+                free_list.push_back(std::make_pair(start, size));
+        }
+        int alloc(uint64_t size, uint64_t *addr) {
+                size = size == 0 ? alignment : (size + alignment - 1) & ~(alignment - 1);
+                for (auto it = free_list.begin(); it != free_list.end(); ++it) {
+                        if (it->second < size)
+                                continue;
+                        *addr = it->first;
+                        if (it->second > size) {
+                                it->first += size;
+                                it->second -= size;
+                        } else {
+                                free_list.erase(it);
+                        }
+                        busy_list.push_back(std::make_pair(*addr, size));
+                        return HB_MC_SUCCESS;
+                }
+                return HB_MC_NOMEM;
+        }
+        int free(uint64_t addr) {
+                auto it = std::find_if(busy_list.begin(), busy_list.end(),
+                                       [&](const std::pair<uint64_t, uint64_t> &b) { return b.first == addr; });
+                if (it == busy_list.end())
+                        return HB_MC_INVALID;
+                free_list.push_back(*it);
+                busy_list.erase(it);
+                if (free_list.size() > 4)
+                        coalesce();
+                return HB_MC_SUCCESS;
+        }
+};
+
+/* The allocator interface the churn drives */
+typedef struct {
+        const char *name;
+        int (*alloc)(void *state, uint64_t size, uint64_t *addr);
+        int (*free)(void *state, uint64_t addr);
+        void *state;
+} allocator_t;
+
+static int list_alloc(void *state, uint64_t size, uint64_t *addr)
+{
+        return static_cast<list_first_fit*>(state)->alloc(size, addr);
+}
+
+static int list_free(void *state, uint64_t addr)
+{
+        return static_cast<list_first_fit*>(state)->free(addr);
+}
+
+static int segfit_alloc(void *state, uint64_t size, uint64_t *addr)
+{
+        return hb_mc_segfit_allocator_alloc(static_cast<hb_mc_segfit_allocator_t*>(state), size, addr);
+}
+
+static int segfit_free(void *state, uint64_t addr)
+{
+        return hb_mc_segfit_allocator_free(static_cast<hb_mc_segfit_allocator_t*>(state), addr);
+}
+
+/*
+ * Mostly small tensors with an occasional large one. The live set grows
+ * to LIVE_MAX and then allocations and frees of random blocks alternate.
+ * The same seed is used for every allocator.
+ */
+static int churn(const allocator_t *a, double *seconds)
+{
+        uint32_t seed = 0x2545F491;
+        auto next = [&seed]() { seed = seed * 1664525 + 1013904223; return seed >> 8; };
+
+        std::vector<std::pair<uint64_t, uint64_t> > live; // (addr, requested size)
+        std::map<uint64_t, uint64_t> shadow;              // addr -> requested size, to check overlap
+        *seconds = 0;
+
+        for (int op = 0; op < CHURN_OPS; op++) {
+                bool do_alloc = live.size() < LIVE_MAX / 2 || (live.size() < LIVE_MAX && next() % 2);
+                if (do_alloc) {
+                        uint32_t r = next();
+                        uint64_t size = (r % 64 == 0) ? (next() % (1u << 20)) : (next() % 4096);
+
+                        uint64_t addr;
+                        auto start = std::chrono::steady_clock::now();
+                        int err = a->alloc(a->state, size, &addr);
+                        *seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                        if (err != HB_MC_SUCCESS) {
+                                bsg_pr_test_err("%s: failed to allocate %" PRIu64 " bytes\n", a->name, size);
+                                return HB_MC_FAIL;
+                        }
+
+                        if (addr % ALIGNMENT != 0 || addr < HEAP_START || addr + size > HEAP_START + HEAP_SIZE) {
+                                bsg_pr_test_err("%s: bad block 0x%" PRIx64 "\n", a->name, addr);
+                                return HB_MC_FAIL;
+                        }
+                        auto after = shadow.lower_bound(addr);
+                        bool overlap = (after != shadow.end() && after->first < addr + std::max<uint64_t>(size, 1));
+                        if (after != shadow.begin()) {
+                                auto before = std::prev(after);
+                                overlap |= before->first + std::max<uint64_t>(before->second, 1) > addr;
+                        }
+                        if (overlap) {
+                                bsg_pr_test_err("%s: block 0x%" PRIx64 " overlaps a live block\n", a->name, addr);
+                                return HB_MC_FAIL;
+                        }
+                        shadow[addr] = size;
+                        live.push_back(std::make_pair(addr, size));
+                } else {
+                        size_t pick = next() % live.size();
+                        uint64_t addr = live[pick].first;
+                        live[pick] = live.back();
+                        live.pop_back();
+                        shadow.erase(addr);
+
+                        auto start = std::chrono::steady_clock::now();
+                        int err = a->free(a->state, addr);
+                        *seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                        if (err != HB_MC_SUCCESS) {
+                                bsg_pr_test_err("%s: failed to free 0x%" PRIx64 "\n", a->name, addr);
+                                return HB_MC_FAIL;
+                        }
+                }
+        }
+
+        for (auto &block : live) {
+                if (a->free(a->state, block.first) != HB_MC_SUCCESS) {
+                        bsg_pr_test_err("%s: failed to free 0x%" PRIx64 "\n", a->name, block.first);
+                        return HB_MC_FAIL;
+                }
+        }
+        return HB_MC_SUCCESS;
+}
+
+#define CHECK(cond)                                                     \
+        do {                                                            \
+                if (!(cond)) {                                          \
+                        bsg_pr_test_err("%s:%d: check failed: %s\n",    \
+                                        __FILE__, __LINE__, #cond);     \
+                        return HB_MC_FAIL;                              \
+                }                                                       \
+        } while (0)
+
+/* Resize, statistics and coalescing on a small heap */
+static int check_segfit(void)
+{
+        hb_mc_segfit_allocator_t *alloc;
+        hb_mc_segfit_stats_t stats;
+        uint64_t a, b, c, size;
+
+        CHECK(hb_mc_segfit_allocator_init(&alloc, HEAP_START, 16 * ALIGNMENT, ALIGNMENT) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, 1, &a) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, ALIGNMENT + 1, &b) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, 0, &c) == HB_MC_SUCCESS);
+        CHECK(a == HEAP_START && b == a + ALIGNMENT && c == b + 2 * ALIGNMENT);
+        CHECK(hb_mc_segfit_allocator_lookup(alloc, b, &size) == HB_MC_SUCCESS && size == 2 * ALIGNMENT);
+
+        // b cannot grow into c; c can grow into the tail
+        CHECK(hb_mc_segfit_allocator_resize(alloc, b, 3 * ALIGNMENT) == HB_MC_NOMEM);
+        CHECK(hb_mc_segfit_allocator_resize(alloc, c, 4 * ALIGNMENT) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_resize(alloc, c, ALIGNMENT) == HB_MC_SUCCESS);
+
+        hb_mc_segfit_allocator_get_stats(alloc, &stats);
+        CHECK(stats.bytes_busy == 4 * ALIGNMENT && stats.bytes_free == 12 * ALIGNMENT);
+        CHECK(stats.peak_bytes_busy == 7 * ALIGNMENT && stats.largest_free == 12 * ALIGNMENT);
+        CHECK(stats.num_busy == 3 && stats.num_free == 1 && stats.num_failed == 1);
+
+        // freeing the middle block leaves a hole; freeing its neighbours merges everything
+        CHECK(hb_mc_segfit_allocator_free(alloc, b) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_free(alloc, b) == HB_MC_INVALID);
+        hb_mc_segfit_allocator_get_stats(alloc, &stats);
+        CHECK(stats.num_free == 2);
+        CHECK(hb_mc_segfit_allocator_free(alloc, a) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_free(alloc, c) == HB_MC_SUCCESS);
+        hb_mc_segfit_allocator_get_stats(alloc, &stats);
+        CHECK(stats.num_free == 1 && stats.largest_free == 16 * ALIGNMENT && stats.bytes_busy == 0);
+
+        // best fit: a 1-unit request takes the 1-unit hole, not the large tail
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, 4 * ALIGNMENT, &a) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, ALIGNMENT, &b) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, ALIGNMENT, &c) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_free(alloc, b) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, ALIGNMENT, &size) == HB_MC_SUCCESS && size == b);
+        CHECK(hb_mc_segfit_allocator_alloc(alloc, 16 * ALIGNMENT, &size) == HB_MC_NOMEM);
+
+        // reserving the middle of the free tail splits it in two; freeing merges it back
+        uint64_t r = HEAP_START + 8 * ALIGNMENT;
+        CHECK(hb_mc_segfit_allocator_reserve(alloc, r, 2 * ALIGNMENT) == HB_MC_SUCCESS);
+        CHECK(hb_mc_segfit_allocator_reserve(alloc, r + ALIGNMENT, ALIGNMENT) == HB_MC_NOMEM);
+        CHECK(hb_mc_segfit_allocator_reserve(alloc, c, ALIGNMENT) == HB_MC_NOMEM);
+        CHECK(hb_mc_segfit_allocator_reserve(alloc, r + 1, ALIGNMENT) == HB_MC_INVALID);
+        hb_mc_segfit_allocator_get_stats(alloc, &stats);
+        CHECK(stats.num_free == 2 && stats.largest_free == 6 * ALIGNMENT);
+        CHECK(hb_mc_segfit_allocator_free(alloc, r) == HB_MC_SUCCESS);
+        hb_mc_segfit_allocator_get_stats(alloc, &stats);
+        CHECK(stats.num_free == 1 && stats.largest_free == 10 * ALIGNMENT);
+
+        hb_mc_segfit_allocator_exit(alloc);
+        return HB_MC_SUCCESS;
+}
+
+int test_segfit_allocator (int argc, char **argv) {
+        int err = check_segfit();
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        list_first_fit list(HEAP_START, HEAP_SIZE, ALIGNMENT);
+        allocator_t first_fit = { "list first-fit", list_alloc, list_free, &list };
+        double first_fit_seconds;
+        err = churn(&first_fit, &first_fit_seconds);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_segfit_allocator_t *alloc;
+        err = hb_mc_segfit_allocator_init(&alloc, HEAP_START, HEAP_SIZE, ALIGNMENT);
+        if (err != HB_MC_SUCCESS)
+                return err;
+        allocator_t segfit = { "segregated fit", segfit_alloc, segfit_free, alloc };
+        double segfit_seconds;
+        err = churn(&segfit, &segfit_seconds);
+
+        hb_mc_segfit_stats_t stats;
+        hb_mc_segfit_allocator_get_stats(alloc, &stats);
+        hb_mc_segfit_allocator_exit(alloc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        // everything was freed, so the heap must be one block again
+        if (stats.num_busy != 0 || stats.num_free != 1 || stats.largest_free != HEAP_SIZE) {
+                bsg_pr_test_err("segregated fit: heap did not coalesce: %" PRIu64 " busy, %" PRIu64 " free blocks\n",
+                                stats.num_busy, stats.num_free);
+                return HB_MC_FAIL;
+        }
+
+        bsg_pr_test_info("%-16s: %d operations, %8.3f ms\n", first_fit.name, CHURN_OPS, first_fit_seconds * 1e3);
+        bsg_pr_test_info("%-16s: %d operations, %8.3f ms, peak %" PRIu64 " KiB busy\n",
+                         segfit.name, CHURN_OPS, segfit_seconds * 1e3, stats.peak_bytes_busy >> 10);
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_segfit_allocator", test_segfit_allocator);
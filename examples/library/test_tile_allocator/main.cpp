@@ -0,0 +1,266 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Replays an enqueue/complete trace of mixed 1x1, 2x2 and 4x4 tile
+// groups against two allocators: the exhaustive first-fit scan that
+// the CUDA library used to perform, and hb_mc_tile_allocator. Both are
+// checked against a shadow occupancy grid, and the host time and number
+// of failed launch attempts are reported for each.
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore_coordinate.h>
+#include <bsg_manycore_tile_allocator.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+#define MESH_X 16
+#define MESH_Y 8
+#define TRACE_LENGTH 20000
+
+typedef enum {
+        TRACE_ENQUEUE,  //!< Enqueue a tile group of the given shape
+        TRACE_COMPLETE, //!< Complete the pick-th running tile group (modulo the number running)
+} trace_op_t;
+
+typedef struct {
+        trace_op_t op;
+        hb_mc_dimension_t dim;
+        uint32_t pick;
+} trace_event_t;
+
+typedef struct {
+        hb_mc_coordinate_t origin;
+        hb_mc_dimension_t dim;
+} placement_t;
+
+typedef struct {
+        const char *name;
+        uint64_t attempts;
+        uint64_t failed;
+        uint64_t launched;
+        uint64_t busy_sum;
+        double seconds;         //!< Time spent inside the allocator
+} replay_stats_t;
+
+/*
+ * Record a trace with a fixed seed so that every run replays the same
+ * sequence. Small groups dominate, as they do in real workloads, with
+ * enough 4x4 groups that fragmentation matters.
+ */
+static std::vector<trace_event_t> record_trace(void)
+{
+        std::vector<trace_event_t> trace;
+        uint32_t seed = 0x2545F491;
+        auto next = [&seed]() { seed = seed * 1664525 + 1013904223; return seed >> 8; };
+
+        for (int i = 0; i < TRACE_LENGTH; i++) {
+                uint32_t r = next();
+                trace_event_t ev;
+                if ((r % 16) < 8) {
+                        uint32_t shape = next() % 8;
+                        ev.op = TRACE_ENQUEUE;
+                        hb_mc_idx_t side = shape < 5 ? 1 : shape < 7 ? 2 : 4;
+                        ev.dim = hb_mc_dimension(side, side);
+                        ev.pick = 0;
+                } else {
+                        ev.op = TRACE_COMPLETE;
+                        ev.dim = hb_mc_dimension(0, 0);
+                        ev.pick = next();
+                }
+                trace.push_back(ev);
+        }
+        return trace;
+}
+
+/* The shadow grid is the reference every allocator is checked against */
+typedef struct {
+        bool busy[MESH_Y][MESH_X];
+        uint32_t busy_tiles;
+} shadow_t;
+
+static bool shadow_is_free(const shadow_t *s, hb_mc_coordinate_t o, hb_mc_dimension_t d)
+{
+        if (o.x + d.x > MESH_X || o.y + d.y > MESH_Y)
+                return false;
+        for (hb_mc_idx_t y = o.y; y < o.y + d.y; y++)
+                for (hb_mc_idx_t x = o.x; x < o.x + d.x; x++)
+                        if (s->busy[y][x])
+                                return false;
+        return true;
+}
+
+static void shadow_set(shadow_t *s, hb_mc_coordinate_t o, hb_mc_dimension_t d, bool busy)
+{
+        for (hb_mc_idx_t y = o.y; y < o.y + d.y; y++)
+                for (hb_mc_idx_t x = o.x; x < o.x + d.x; x++)
+                        s->busy[y][x] = busy;
+        s->busy_tiles = busy ? s->busy_tiles + d.x * d.y : s->busy_tiles - d.x * d.y;
+}
+
+/* The allocator interface the replay drives */
+typedef struct {
+        void *state;
+        int (*alloc)(void *state, hb_mc_dimension_t dim, hb_mc_coordinate_t *origin);
+        int (*free)(void *state, hb_mc_coordinate_t origin, hb_mc_dimension_t dim);
+} allocator_t;
+
+/* The old policy: try every origin and rescan every tile of the candidate */
+static int scan_alloc(void *state, hb_mc_dimension_t dim, hb_mc_coordinate_t *origin)
+{
+        shadow_t *grid = (shadow_t*)state;
+        for (hb_mc_idx_t y = 0; y < MESH_Y; y++) {
+                for (hb_mc_idx_t x = 0; x < MESH_X; x++) {
+                        hb_mc_coordinate_t o = hb_mc_coordinate(x, y);
+                        if (shadow_is_free(grid, o, dim)) {
+                                shadow_set(grid, o, dim, true);
+                                *origin = o;
+                                return HB_MC_SUCCESS;
+                        }
+                }
+        }
+        return HB_MC_NOTFOUND;
+}
+
+static int scan_free(void *state, hb_mc_coordinate_t origin, hb_mc_dimension_t dim)
+{
+        shadow_set((shadow_t*)state, origin, dim, false);
+        return HB_MC_SUCCESS;
+}
+
+static int tile_allocator_alloc(void *state, hb_mc_dimension_t dim, hb_mc_coordinate_t *origin)
+{
+        return hb_mc_tile_allocator_alloc((hb_mc_tile_allocator_t*)state, dim, origin);
+}
+
+static int tile_allocator_free(void *state, hb_mc_coordinate_t origin, hb_mc_dimension_t dim)
+{
+        return hb_mc_tile_allocator_free((hb_mc_tile_allocator_t*)state, origin, dim);
+}
+
+/*
+ * Replay a trace the way hb_mc_device_pod_try_launch_tile_groups()
+ * drains its queue: after every event, launch queued groups in order,
+ * skipping any group whose shape has already failed in this pass.
+ */
+static int replay(const std::vector<trace_event_t> &trace, allocator_t *a, replay_stats_t *stats)
+{
+        shadow_t shadow = {};
+        std::deque<hb_mc_dimension_t> queue;
+        std::vector<placement_t> running;
+
+        for (const trace_event_t &ev : trace) {
+                if (ev.op == TRACE_ENQUEUE) {
+                        queue.push_back(ev.dim);
+                } else if (!running.empty()) {
+                        size_t i = ev.pick % running.size();
+                        placement_t p = running[i];
+                        running[i] = running.back();
+                        running.pop_back();
+                        auto start = std::chrono::steady_clock::now();
+                        int err = a->free(a->state, p.origin, p.dim);
+                        stats->seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                        if (err != HB_MC_SUCCESS) {
+                                bsg_pr_test_err("%s: failed to free tile group\n", stats->name);
+                                return HB_MC_FAIL;
+                        }
+                        shadow_set(&shadow, p.origin, p.dim, false);
+                }
+
+                hb_mc_dimension_t last_failed = hb_mc_dimension(0, 0);
+                for (auto it = queue.begin(); it != queue.end(); ) {
+                        if (hb_mc_dimension_eq(*it, last_failed)) {
+                                ++it;
+                                continue;
+                        }
+
+                        hb_mc_coordinate_t origin;
+                        stats->attempts++;
+                        auto start = std::chrono::steady_clock::now();
+                        int err = a->alloc(a->state, *it, &origin);
+                        stats->seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                        if (err != HB_MC_SUCCESS) {
+                                stats->failed++;
+                                last_failed = *it;
+                                ++it;
+                                continue;
+                        }
+
+                        if (!shadow_is_free(&shadow, origin, *it)) {
+                                bsg_pr_test_err("%s: overlapping or out of bounds placement\n", stats->name);
+                                return HB_MC_FAIL;
+                        }
+                        shadow_set(&shadow, origin, *it, true);
+                        running.push_back({origin, *it});
+                        stats->launched++;
+                        it = queue.erase(it);
+                }
+                stats->busy_sum += shadow.busy_tiles;
+        }
+        return HB_MC_SUCCESS;
+}
+
+static void report(const replay_stats_t *stats, size_t events)
+{
+        bsg_pr_test_info("%-16s: %8" PRIu64 " launched, %8" PRIu64 " failed of %8" PRIu64 " attempts, "
+                         "%5.1f%% mean utilization, %8.3f ms\n",
+                         stats->name, stats->launched, stats->failed, stats->attempts,
+                         100.0 * stats->busy_sum / (events * MESH_X * MESH_Y),
+                         stats->seconds * 1e3);
+}
+
+int test_tile_allocator (int argc, char **argv) {
+        std::vector<trace_event_t> trace = record_trace();
+
+        shadow_t grid = {};
+        allocator_t scan = { &grid, scan_alloc, scan_free };
+        replay_stats_t scan_stats = {"first-fit scan"};
+        int err = replay(trace, &scan, &scan_stats);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_tile_allocator_t tile_allocator;
+        err = hb_mc_tile_allocator_init(&tile_allocator, hb_mc_dimension(MESH_X, MESH_Y));
+        if (err != HB_MC_SUCCESS)
+                return err;
+        allocator_t best = { &tile_allocator, tile_allocator_alloc, tile_allocator_free };
+        replay_stats_t best_stats = {"tile allocator"};
+        err = replay(trace, &best, &best_stats);
+        hb_mc_tile_allocator_exit(&tile_allocator);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        report(&scan_stats, trace.size());
+        report(&best_stats, trace.size());
+
+        return HB_MC_SUCCESS;
+}
+
+declare_program_main("test_tile_allocator", test_tile_allocator);
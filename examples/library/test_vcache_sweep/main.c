@@ -0,0 +1,144 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Measures whole-cache sweeps on the machine the test is built for.
+// Each pod is first flushed on its own with hb_mc_manycore_pod_flush_vcache(),
+// then all pods are swept in one interleaved stream with a single fence.
+// The same comparison is made for invalidation. DRAM written before the
+// sweeps must read back intact afterwards.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_config_pod.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+#define TEST_NAME "test_vcache_sweep"
+#define WORDS 256
+#define MAX_PODS 64
+
+static uint32_t out[WORDS], in[WORDS];
+
+typedef int (*pod_sweep_t)(hb_mc_manycore_t *, hb_mc_coordinate_t);
+typedef int (*pods_sweep_t)(hb_mc_manycore_t *, const hb_mc_coordinate_t *, size_t);
+
+static int time_sweep(hb_mc_manycore_t *mc, const hb_mc_coordinate_t *pods, size_t n,
+                      pod_sweep_t pod_sweep, pods_sweep_t pods_sweep, const char *name)
+{
+        uint64_t start_cycle, mid_cycle, end_cycle;
+        size_t p;
+        int err;
+
+        err = hb_mc_manycore_get_cycle(mc, &start_cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (p = 0; p < n; p++) {
+                err = pod_sweep(mc, pods[p]);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        err = hb_mc_manycore_get_cycle(mc, &mid_cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        err = pods_sweep(mc, pods, n);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        err = hb_mc_manycore_get_cycle(mc, &end_cycle);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        bsg_pr_test_info("%-10s: pod by pod %10" PRIu64 " cycles, all pods %10" PRIu64 " cycles\n",
+                         name, mid_cycle - start_cycle, end_cycle - mid_cycle);
+        return HB_MC_SUCCESS;
+}
+
+int test_vcache_sweep (int argc, char *argv[]) {
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+        hb_mc_coordinate_t pods[MAX_PODS], pod;
+        size_t n = 0;
+        int err, r, i;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to initialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_config_foreach_pod(pod, cfg)
+        {
+                if (n < MAX_PODS)
+                        pods[n++] = pod;
+        }
+
+        bsg_pr_test_info("machine: %zu pods of %" PRIu32 "x%" PRIu32 " tiles, "
+                         "%" PRIu32 " ways x %" PRIu32 " sets x %" PRIu32 " words per vcache\n",
+                         n,
+                         (uint32_t)hb_mc_config_get_dimension_vcore(cfg).x,
+                         (uint32_t)hb_mc_config_get_dimension_vcore(cfg).y,
+                         hb_mc_config_get_vcache_ways(cfg),
+                         hb_mc_config_get_vcache_sets(cfg),
+                         hb_mc_config_get_vcache_block_words(cfg));
+
+        /* dirty some lines in the first vcache of pod (0,0) */
+        hb_mc_coordinate_t pod0 = {.x=0, .y=0};
+        hb_mc_npa_t npa = hb_mc_npa_from_x_y(hb_mc_config_get_vcore_base_x(cfg),
+                                             hb_mc_config_pod_dram_y(cfg, pod0, 0), 0);
+        for (i = 0; i < WORDS; i++)
+                out[i] = (uint32_t)rand();
+
+        r = hb_mc_manycore_write_mem(mc, &npa, out, sizeof(out));
+        if (r == HB_MC_SUCCESS)
+                r = time_sweep(mc, pods, n, hb_mc_manycore_pod_flush_vcache,
+                               hb_mc_manycore_pods_flush_vcache, "flush");
+        if (r == HB_MC_SUCCESS)
+                r = time_sweep(mc, pods, n, hb_mc_manycore_pod_invalidate_vcache,
+                               hb_mc_manycore_pods_invalidate_vcache, "invalidate");
+        if (r == HB_MC_SUCCESS)
+                r = hb_mc_manycore_read_mem(mc, &npa, in, sizeof(in));
+
+        for (i = 0; r == HB_MC_SUCCESS && i < WORDS; i++) {
+                if (in[i] != out[i]) {
+                        bsg_pr_err("%s: word %d: read 0x%08" PRIx32 ", wrote 0x%08" PRIx32 "\n",
+                                   __func__, i, in[i], out[i]);
+                        r = HB_MC_FAIL;
+                }
+        }
+
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_vcache_sweep);
@@ -0,0 +1,116 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Measures the host packet rate of hb_mc_manycore_write_mem() and
+// hb_mc_manycore_memset(). Both hand the platform a batch of store
+// packets at a time through hb_mc_platform_transmit_batch(). On simulated
+// platforms the process time also includes the simulator. Run it with
+// BSG_PLATFORM=loopback to measure the library alone.
+
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_printing.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TEST_NAME "test_write_mem_host_time"
+#define WORDS (8 * 1024)
+#define ITERATIONS 4
+
+static uint32_t out[WORDS], in[WORDS];
+
+int test_write_mem_host_time (int argc, char *argv[]) {
+        hb_mc_manycore_t manycore = {0}, *mc = &manycore;
+        int err, r = HB_MC_SUCCESS, i;
+
+        err = hb_mc_manycore_init(mc, TEST_NAME, 0);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to initialize manycore: %s\n",
+                           __func__, hb_mc_strerror(err));
+                return HB_MC_FAIL;
+        }
+
+        /* the first vcache of pod (0,0) */
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t pod = {.x=0, .y=0};
+        hb_mc_npa_t npa = hb_mc_npa_from_x_y(hb_mc_config_get_vcore_base_x(cfg),
+                                             hb_mc_config_pod_dram_y(cfg, pod, 0), 0);
+
+        clock_t write_cpu = 0, memset_cpu = 0;
+        for (int it = 0; it < ITERATIONS; it++) {
+                for (i = 0; i < WORDS; i++)
+                        out[i] = (uint32_t)rand();
+
+                clock_t start = clock();
+                err = hb_mc_manycore_write_mem(mc, &npa, out, sizeof(out));
+                write_cpu += clock() - start;
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: failed to write: %s\n", __func__, hb_mc_strerror(err));
+                        r = err;
+                        goto cleanup;
+                }
+
+                err = hb_mc_manycore_read_mem(mc, &npa, in, sizeof(in));
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: failed to read: %s\n", __func__, hb_mc_strerror(err));
+                        r = err;
+                        goto cleanup;
+                }
+
+                for (i = 0; i < WORDS; i++) {
+                        if (in[i] != out[i]) {
+                                bsg_pr_err("%s: word %d: read 0x%08" PRIx32 ", wrote 0x%08" PRIx32 "\n",
+                                           __func__, i, in[i], out[i]);
+                                r = HB_MC_FAIL;
+                                goto cleanup;
+                        }
+                }
+
+                start = clock();
+                err = hb_mc_manycore_memset(mc, &npa, (uint8_t)it, sizeof(out));
+                memset_cpu += clock() - start;
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: failed to memset: %s\n", __func__, hb_mc_strerror(err));
+                        r = err;
+                        goto cleanup;
+                }
+        }
+
+        bsg_pr_test_info("write_mem: %.0f packets per second of host CPU time\n",
+                         (double)WORDS * ITERATIONS * CLOCKS_PER_SEC / (write_cpu ? write_cpu : 1));
+        bsg_pr_test_info("memset   : %.0f packets per second of host CPU time\n",
+                         (double)WORDS * ITERATIONS * CLOCKS_PER_SEC / (memset_cpu ? memset_cpu : 1));
+
+cleanup:
+        hb_mc_manycore_exit(mc);
+        return r;
+}
+
+declare_program_main(TEST_NAME, test_write_mem_host_time);
@@ -45,10 +45,11 @@
 #include <cassert>
 
 #include <type_traits>
-#include <stack>
-#include <map>
+#include <algorithm>
 #include <queue>
 #include <vector>
+#include <map>
+#include <string>
 
 #define array_size(x)                           \
         (sizeof(x)/sizeof(x[0]))
@@ -81,6 +82,46 @@ static int hb_mc_manycore_get_remote_load_cap(hb_mc_manycore_t *mc, unsigned *ca
         return HB_MC_SUCCESS;
 }
 
+/* states of a load id under the split-phase API */
+enum {
+        HB_MC_ASYNC_FREE = 0, //!< not held by a ticket
+        HB_MC_ASYNC_PENDING,  //!< request sent, response outstanding
+        HB_MC_ASYNC_DONE,     //!< response received, not yet claimed
+};
+
+/* a load id held by a split-phase request */
+typedef struct {
+        int state;                      //!< One of HB_MC_ASYNC_*
+        hb_mc_manycore_ticket_t ticket; //!< Ticket handed out for the request
+        uint32_t data;                  //!< Response data once HB_MC_ASYNC_DONE
+} hb_mc_manycore_async_slot_t;
+
+/* tickets are a sequence number above the load id they hold */
+#define HB_MC_TICKET_ID_BITS 8
+#define HB_MC_TICKET_ID_MASK ((1u << HB_MC_TICKET_ID_BITS) - 1)
+
+struct hb_mc_manycore_async {
+        std::vector<hb_mc_manycore_async_slot_t> slots; //!< Indexed by load id
+        unsigned n_pending;                             //!< Slots in HB_MC_ASYNC_PENDING
+        uint32_t seq;                                   //!< Sequence number of the last ticket
+};
+
+/* does a split-phase request hold this load id on the network? */
+static bool hb_mc_manycore_async_is_pending(const hb_mc_manycore_t *mc, uint32_t id)
+{
+        return mc->async != nullptr
+                && id < mc->async->slots.size()
+                && mc->async->slots[id].state == HB_MC_ASYNC_PENDING;
+}
+
+/* record the response to a split-phase request */
+static void hb_mc_manycore_async_complete(hb_mc_manycore_t *mc, uint32_t id, uint32_t data)
+{
+        mc->async->slots[id].state = HB_MC_ASYNC_DONE;
+        mc->async->slots[id].data = data;
+        mc->async->n_pending--;
+}
+
 /**
  * Stall until the all requests (and responses to the host) have reached their destination.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -127,6 +168,21 @@ static int hb_mc_manycore_init_config(hb_mc_manycore_t *mc)
         return HB_MC_SUCCESS;
 }
 
+// Checkpoint requested for the next hb_mc_manycore_init(), see
+// hb_mc_manycore_init_checkpoint()
+static std::string init_checkpoint_save, init_checkpoint_restore;
+
+/**
+ * Make the next hb_mc_manycore_init() in this process save or restore a checkpoint.
+ * @param[in] save     Checkpoint to save once reset, DRAM enable and vcache init are done, or NULL
+ * @param[in] restore  Checkpoint to restore in place of those three steps, or NULL
+ */
+void hb_mc_manycore_init_checkpoint(const char *save, const char *restore)
+{
+        init_checkpoint_save = save ? save : "";
+        init_checkpoint_restore = restore ? restore : "";
+}
+
 /**
  * Initialize a manycore instance
  * @param[in] mc    A manycore to initialize
@@ -180,6 +236,30 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
                 return err;
         }
 
+        // initialize dma
+        if ((err = hb_mc_dma_init(mc)) != HB_MC_SUCCESS) {
+                hb_mc_platform_cleanup(mc);
+                free((void*)mc->name);
+                return err;
+        }
+
+        // The checkpoint request applies to this init only
+        std::string save, restore;
+        save.swap(init_checkpoint_save);
+        restore.swap(init_checkpoint_restore);
+
+        // A checkpoint was saved after reset, DRAM enable and vcache
+        // init, so restoring it replaces all three
+        if (!restore.empty()) {
+                if ((err = hb_mc_platform_checkpoint_restore(mc, restore.c_str())) != HB_MC_SUCCESS) {
+                        hb_mc_platform_cleanup(mc);
+                        free((void*)mc->name);
+                        return err;
+                }
+                manycore_pr_info(mc, "Restored checkpoint '%s'\n", restore.c_str());
+                return HB_MC_SUCCESS;
+        }
+
         // wait for reset to complete
         if ((err = hb_mc_platform_wait_reset_done(mc)) != HB_MC_SUCCESS) {
                 hb_mc_platform_cleanup(mc);
@@ -201,11 +281,13 @@ int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_
                 return err;
         }
 
-        // initialize dma
-        if ((err = hb_mc_dma_init(mc)) != HB_MC_SUCCESS) {
-                hb_mc_platform_cleanup(mc);
-                free((void*)mc->name);
-                return err;
+        if (!save.empty()) {
+                if ((err = hb_mc_manycore_checkpoint_save(mc, save.c_str())) != HB_MC_SUCCESS) {
+                        hb_mc_platform_cleanup(mc);
+                        free((void*)mc->name);
+                        return err;
+                }
+                manycore_pr_info(mc, "Saved checkpoint '%s'\n", save.c_str());
         }
 
         return HB_MC_SUCCESS;
@@ -225,6 +307,7 @@ int hb_mc_manycore_exit(hb_mc_manycore_t *mc)
                 return err;
         }
         hb_mc_platform_cleanup(mc);
+        delete mc->async;
         free((void*)mc->name);
         return HB_MC_SUCCESS;
 }
@@ -247,6 +330,48 @@ int hb_mc_manycore_get_cycle(hb_mc_manycore_t *mc, uint64_t *time)
         return hb_mc_platform_get_cycle(mc, time);
 }
 
+/**
+ * Fence, then save the state of the manycore hardware (including
+ * DRAM) to a checkpoint.
+ * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path   The checkpoint file
+ * @return HB_MC_NOIMPL if the platform cannot checkpoint. HB_MC_SUCCESS on success.
+ */
+int hb_mc_manycore_checkpoint_save(hb_mc_manycore_t *mc, const char *path)
+{
+        int err;
+
+        // Responses to split-phase loads would be lost on restore
+        if (mc->async && mc->async->n_pending) {
+                manycore_pr_err(mc, "%s: %u split-phase loads are pending\n",
+                                __func__, mc->async->n_pending);
+                return HB_MC_BUSY;
+        }
+
+        if ((err = hb_mc_manycore_host_request_fence(mc, -1)) != HB_MC_SUCCESS)
+                return err;
+
+        return hb_mc_platform_checkpoint_save(mc, path);
+}
+
+/**
+ * Replace the state of the manycore hardware (including DRAM)
+ * with a checkpoint saved by hb_mc_manycore_checkpoint_save().
+ * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path   The checkpoint file
+ * @return HB_MC_NOIMPL if the platform cannot checkpoint. HB_MC_SUCCESS on success.
+ */
+int hb_mc_manycore_checkpoint_restore(hb_mc_manycore_t *mc, const char *path)
+{
+        if (mc->async && mc->async->n_pending) {
+                manycore_pr_err(mc, "%s: %u split-phase loads are pending\n",
+                                __func__, mc->async->n_pending);
+                return HB_MC_BUSY;
+        }
+
+        return hb_mc_platform_checkpoint_restore(mc, path);
+}
+
 ////////////////
 // Packet API //
 ////////////////
@@ -255,7 +380,7 @@ int hb_mc_manycore_get_cycle(hb_mc_manycore_t *mc, uint64_t *time)
  * Transmit a request packet to manycore hardware
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] request A request packet to transmit to manycore hardware
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_request_tx(hb_mc_manycore_t *mc,
@@ -266,11 +391,27 @@ int hb_mc_manycore_request_tx(hb_mc_manycore_t *mc,
         return hb_mc_platform_transmit(mc, (hb_mc_packet_t*)request, HB_MC_FIFO_TX_REQ, timeout);
 }
 
+/**
+ * Transmit an array of request packets to manycore hardware, in order
+ * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] requests An array of #n packets holding requests to transmit
+ * @param[in] n        The number of packets
+ * @param[in] timeout  Retries per packet before HB_MC_TIMEOUT, or -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_request_tx_batch(hb_mc_manycore_t *mc,
+                                    hb_mc_packet_t *requests,
+                                    size_t n,
+                                    long timeout)
+{
+        return hb_mc_platform_transmit_batch(mc, requests, n, HB_MC_FIFO_TX_REQ, timeout);
+}
+
 /**
  * Receive a response packet from manycore hardware
  * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] response A packet into which data should be read
- * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout  Retries before HB_MC_TIMEOUT, or -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_response_rx(hb_mc_manycore_t *mc,
@@ -285,7 +426,7 @@ int hb_mc_manycore_response_rx(hb_mc_manycore_t *mc,
  * Transmit a response packet to manycore hardware
  * @param[in] mc        A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] response  A response packet to transmit to manycore hardware
- * @param[in] timeout   A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout   Retries before HB_MC_TIMEOUT, or -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_response_tx(hb_mc_manycore_t *mc,
@@ -299,7 +440,7 @@ int hb_mc_manycore_response_tx(hb_mc_manycore_t *mc,
  * Receive a request packet from manycore hardware
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] request A packet into which data should be read
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_request_rx(hb_mc_manycore_t *mc,
@@ -326,7 +467,7 @@ int hb_mc_manycore_request_rx(hb_mc_manycore_t *mc,
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] packet  A packet to transmit to manycore hardware
  * @param[in] type    Is this packet a request or response packet?
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_packet_tx(hb_mc_manycore_t *mc,
@@ -348,7 +489,7 @@ int hb_mc_manycore_packet_tx(hb_mc_manycore_t *mc,
  * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] packet A packet into which data should be read
  * @param[in] type   Is this packet a request or response packet?
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_manycore_packet_rx(hb_mc_manycore_t *mc,
@@ -470,6 +611,8 @@ static int hb_mc_manycore_format_cache_op_request_packet(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/* defined with the write session API below */
+static int hb_mc_manycore_write_close(hb_mc_manycore_t *mc, int err);
 
 /************************/
 /* Cache Operations API */
@@ -500,49 +643,94 @@ int hb_mc_manycore_vcache_apply_to_npa(hb_mc_manycore_t *mc,
         if (err != HB_MC_SUCCESS) {
                 manycore_pr_err(mc, "%s: Failed to send request packet: %s\n",
                                 __func__, hb_mc_strerror(err));
+                return err;
         }
 
         return HB_MC_SUCCESS;
 }
 
 /**
- * Apply cache operation to a range of NPAs
- * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in]  npa    A valid hb_mc_npa_t (must map to DRAM) - start of the range to invalidate
- * @param[in]  sz     The size of the range to invalidate in bytes
+ * Apply a cache operation to every line of a list of NPA ranges.
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  ranges   An array of ranges (must map to DRAM)
+ * @param[in]  n        The number of ranges in #ranges
+ * @param[in]  cache_op The operation to apply: AFL, AINV, or AFLINV
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ *
+ * Lines are grouped by victim cache and deduplicated, so overlapping
+ * ranges and ranges split across stripes cost one packet per line.
+ * All packets are sent back to back in one write session and fenced once.
+ * A flush then reads one word from each victim cache it touched.
+ * AFLINV is applied as a probed AFL pass followed by an AINV pass, so
+ * the dirty lines are known to be in DRAM before they are dropped.
  */
-static int hb_mc_manycore_vcache_apply_to_npa_range(hb_mc_manycore_t *mc,
-                                                    const hb_mc_npa_t *npa,
-                                                    size_t range_sz,
-                                                    hb_mc_packet_cache_op_t cache_op)
+int hb_mc_manycore_vcache_op_npa_ranges(hb_mc_manycore_t *mc,
+                                        const hb_mc_manycore_npa_range_t *ranges,
+                                        size_t n,
+                                        hb_mc_packet_cache_op_t cache_op)
 {
-        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
-        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
-        ssize_t sz = static_cast<ssize_t>(range_sz);
-        ssize_t bsize = static_cast<ssize_t>(hb_mc_config_get_vcache_block_size(cfg));
-        int err;
-
-        // align npa to closest cache line
-        sz += (epa & (bsize - 1));
-        epa &= -bsize;
+        if (!hb_mc_manycore_has_cache(mc))
+                return HB_MC_SUCCESS;
 
-        // until we've applied op the entire range...
-        while (sz > 0) {
-                // apply op to line address
-                hb_mc_npa_t line_npa = *npa;
-                hb_mc_npa_set_epa(&line_npa, epa);
+        int err;
 
-                err = hb_mc_manycore_vcache_apply_to_npa(mc, npa, cache_op);
+        // the fence only orders the packets; probe the writebacks before invalidating
+        if (cache_op == HB_MC_PACKET_CACHE_OP_AFLINV) {
+                err = hb_mc_manycore_vcache_op_npa_ranges(mc, ranges, n, HB_MC_PACKET_CACHE_OP_AFL);
                 if (err != HB_MC_SUCCESS)
                         return err;
 
-                // next line
-                sz -= std::min(sz, bsize);
-                epa += bsize;
+                return hb_mc_manycore_vcache_op_npa_ranges(mc, ranges, n, HB_MC_PACKET_CACHE_OP_AINV);
         }
 
-        return HB_MC_SUCCESS;
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_epa_t bsize = hb_mc_config_get_vcache_block_size(cfg);
+
+        // collect the line addresses of each victim cache
+        std::map<std::pair<hb_mc_idx_t, hb_mc_idx_t>, std::vector<hb_mc_epa_t>> lines;
+        for (size_t r = 0; r < n; r++) {
+                if (ranges[r].sz == 0)
+                        continue;
+
+                hb_mc_epa_t epa = hb_mc_npa_get_epa(&ranges[r].npa);
+                hb_mc_epa_t last = epa + ranges[r].sz - 1;
+                std::vector<hb_mc_epa_t> &vc = lines[std::make_pair(hb_mc_npa_get_x(&ranges[r].npa),
+                                                                    hb_mc_npa_get_y(&ranges[r].npa))];
+                for (hb_mc_epa_t line = epa & -bsize; line <= (last & -bsize); line += bsize)
+                        vc.push_back(line);
+        }
+
+        err = hb_mc_manycore_write_begin(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        // stream every line of every cache
+        std::vector<hb_mc_npa_t> probes;
+        for (auto &vc : lines) {
+                std::vector<hb_mc_epa_t> &epas = vc.second;
+                std::sort(epas.begin(), epas.end());
+                epas.erase(std::unique(epas.begin(), epas.end()), epas.end());
+
+                for (hb_mc_epa_t line : epas) {
+                        hb_mc_npa_t line_npa = hb_mc_npa_from_x_y(vc.first.first, vc.first.second, line);
+                        err = hb_mc_manycore_vcache_apply_to_npa(mc, &line_npa, cache_op);
+                        if (err != HB_MC_SUCCESS)
+                                return hb_mc_manycore_write_close(mc, err);
+                }
+
+                probes.push_back(hb_mc_npa_from_x_y(vc.first.first, vc.first.second, epas.front()));
+        }
+
+        err = hb_mc_manycore_write_close(mc, HB_MC_SUCCESS);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        // read a word behind each flush - when it completes, assume the flush is done
+        if (cache_op != HB_MC_PACKET_CACHE_OP_AFL || probes.empty())
+                return HB_MC_SUCCESS;
+
+        std::vector<uint32_t> dummy(probes.size());
+        return hb_mc_manycore_read_mem_scatter_gather(mc, probes.data(), dummy.data(), probes.size());
 }
 
 /**
@@ -556,8 +744,8 @@ int hb_mc_manycore_vcache_invalidate_npa_range(hb_mc_manycore_t *mc,
                                                const hb_mc_npa_t *npa,
                                                size_t sz)
 {
-        return hb_mc_manycore_vcache_apply_to_npa_range(mc, npa, sz,
-                                                        HB_MC_PACKET_CACHE_OP_AINV);
+        hb_mc_manycore_npa_range_t range = { *npa, sz };
+        return hb_mc_manycore_vcache_op_npa_ranges(mc, &range, 1, HB_MC_PACKET_CACHE_OP_AINV);
 }
 
 /**
@@ -571,18 +759,8 @@ int hb_mc_manycore_vcache_flush_npa_range(hb_mc_manycore_t *mc,
                                           const hb_mc_npa_t *npa,
                                           size_t sz)
 {
-        if (!hb_mc_manycore_has_cache(mc))
-                return HB_MC_SUCCESS;
-
-        int err;
-        err = hb_mc_manycore_vcache_apply_to_npa_range(mc, npa, sz,
-                                                       HB_MC_PACKET_CACHE_OP_AFL);
-        if (err != HB_MC_SUCCESS)
-                return err;
-
-        // read a single word from cache - when it completes, assume flush is done
-        uint32_t dummy;
-        return hb_mc_manycore_read32(mc, npa, &dummy);
+        hb_mc_manycore_npa_range_t range = { *npa, sz };
+        return hb_mc_manycore_vcache_op_npa_ranges(mc, &range, 1, HB_MC_PACKET_CACHE_OP_AFL);
 }
 
 int hb_mc_manycore_vcache_flush_tag(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa)
@@ -602,8 +780,11 @@ int hb_mc_manycore_vcache_flush_tag(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa
 }
 
 
+/* apply a function to every way of every set of every vcache in a list of pods */
 template <typename ApplyFunction>
-static int hb_mc_manycore_pod_apply_to_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod, ApplyFunction apply_function)
+static int hb_mc_manycore_pods_apply_to_vcache(hb_mc_manycore_t *mc,
+                                               const hb_mc_coordinate_t *pods, size_t n_pods,
+                                               ApplyFunction apply_function)
 {
         if (!hb_mc_manycore_has_cache(mc))
                 return HB_MC_SUCCESS;
@@ -612,108 +793,170 @@ static int hb_mc_manycore_pod_apply_to_vcache(hb_mc_manycore_t *mc, hb_mc_coordi
         hb_mc_epa_t sets = hb_mc_vcache_num_sets(mc);
         int err;
 
+        // collect the caches once; consecutive tag ops then go to different caches
+        std::vector<hb_mc_epa_t> cache_ids;
+        for (size_t p = 0; p < n_pods; p++) {
+                hb_mc_coordinate_t dram;
+                hb_mc_config_pod_foreach_dram(dram, pods[p], &mc->config)
+                {
+                        cache_ids.push_back(static_cast<hb_mc_epa_t>(hb_mc_config_dram_id(&mc->config, dram)));
+                }
+        }
+
+        // post every tag op and fence once at the end
+        err = hb_mc_manycore_write_begin(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
         for (hb_mc_epa_t way_id = 0; way_id < ways; way_id++) {
                 for (hb_mc_epa_t set_id = 0; set_id < sets; set_id++) {
-                        hb_mc_coordinate_t dram;
-                        hb_mc_config_pod_foreach_dram(dram, pod, &mc->config)
-                        {
-                                hb_mc_epa_t cache_id = static_cast<hb_mc_epa_t>(hb_mc_config_dram_id(&mc->config, dram));
+                        for (hb_mc_epa_t cache_id : cache_ids) {
                                 // build the address for the way
                                 hb_mc_npa_t way_addr = hb_mc_vcache_way_npa(mc, cache_id, set_id, way_id);
                                 // apply
                                 err = apply_function(mc, &way_addr);
                                 if (err != HB_MC_SUCCESS)
-                                        return err;
+                                        return hb_mc_manycore_write_close(mc, err);
                         }
                 }
         }
 
-        return HB_MC_SUCCESS;
+        return hb_mc_manycore_write_close(mc, HB_MC_SUCCESS);
+}
+
+static int hb_mc_manycore_vcache_invalidate_way(hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr)
+{
+        // write way_id (no valid bit)
+        char npa_str [256];
+        manycore_pr_dbg(mc, "Invalidating vcache tag @ %s\n",
+                        hb_mc_npa_to_string(way_addr, npa_str, sizeof(npa_str)));
+
+        return hb_mc_manycore_write32(mc, way_addr, 0);
+}
+
+static int hb_mc_manycore_vcache_validate_way(hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr)
+{
+        char npa_str[256];
+        uint32_t tag = HB_MC_VCACHE_VALID | hb_mc_vcache_way(mc, hb_mc_npa_get_epa(way_addr));
+        manycore_pr_dbg(mc, "Validating vcache tag @ %s with tag = 0x%08" PRIx32 "\n",
+                        hb_mc_npa_to_string(way_addr, npa_str, sizeof(npa_str)), tag);
+
+        // write the way_id or'd with the valid bit
+        return hb_mc_manycore_write32(mc, way_addr, tag);
 }
 
+static int hb_mc_manycore_vcache_flush_way(hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr)
+{
+        // flush tag
+        char npa_str[256];
+        manycore_pr_dbg(mc, "Flushing vcach tag @ %s\n",
+                        hb_mc_npa_to_string(way_addr, npa_str, sizeof(npa_str)));
+        return hb_mc_manycore_vcache_flush_tag(mc, way_addr);
+}
 
 /**
- * Invalidate entire victim cache for pod.
+ * Invalidate entire victim cache for a list of pods.
+ * Tag writes to all caches of all pods are interleaved and fenced once.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  pods   An array of #n pod coordinates
+ * @param[in]  n      The number of pods
  */
-int hb_mc_manycore_pod_invalidate_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
+int hb_mc_manycore_pods_invalidate_vcache(hb_mc_manycore_t *mc, const hb_mc_coordinate_t *pods, size_t n)
 {
-        return hb_mc_manycore_pod_apply_to_vcache(mc, pod, [](hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr) {
-                        // write way_id (no valid bit)
-                        char npa_str [256];
-                        manycore_pr_dbg(mc, "Invalidating vcache tag @ %s\n",
-                                        hb_mc_npa_to_string(way_addr, npa_str, sizeof(npa_str)));
-
-                        return hb_mc_manycore_write32(mc, way_addr, 0);
-                });
+        return hb_mc_manycore_pods_apply_to_vcache(mc, pods, n, hb_mc_manycore_vcache_invalidate_way);
 }
 
 /**
- * Mark each way in victim cache as valid for pod.
+ * Mark each way in victim cache as valid for a list of pods.
+ * Tag writes to all caches of all pods are interleaved and fenced once.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  pods   An array of #n pod coordinates
+ * @param[in]  n      The number of pods
  */
-int hb_mc_manycore_pod_validate_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
+int hb_mc_manycore_pods_validate_vcache(hb_mc_manycore_t *mc, const hb_mc_coordinate_t *pods, size_t n)
 {
-        return hb_mc_manycore_pod_apply_to_vcache(mc, pod, [](hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr) {
-                        char npa_str[256];
-                        uint32_t tag = HB_MC_VCACHE_VALID | hb_mc_vcache_way(mc, hb_mc_npa_get_epa(way_addr));
-                        manycore_pr_dbg(mc, "Validating vcache tag @ %s with tag = 0x%08" PRIx32 "\n",
-                                        hb_mc_npa_to_string(way_addr, npa_str, sizeof(npa_str)), tag);
-
-                        // write the way_id or'd with the valid bit
-                        return hb_mc_manycore_write32(mc, way_addr, tag);
-                });
+        return hb_mc_manycore_pods_apply_to_vcache(mc, pods, n, hb_mc_manycore_vcache_validate_way);
 }
 
 /**
- * Flush entire victim cache for pod.
+ * Flush entire victim cache for a list of pods.
+ * Tag flushes to all caches of all pods are interleaved and fenced once.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  pods   An array of #n pod coordinates
+ * @param[in]  n      The number of pods
  */
-int hb_mc_manycore_pod_flush_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
+int hb_mc_manycore_pods_flush_vcache(hb_mc_manycore_t *mc, const hb_mc_coordinate_t *pods, size_t n)
 {
         if (!hb_mc_manycore_has_cache(mc))
                 return HB_MC_SUCCESS;
 
-        int err = hb_mc_manycore_pod_apply_to_vcache(mc, pod, [](hb_mc_manycore_t *mc, const hb_mc_npa_t *way_addr) {
-                        // flush tag
-                        char npa_str[256];
-                        manycore_pr_dbg(mc, "Flushing vcach tag @ %s\n",
-                                        hb_mc_npa_to_string(way_addr, npa_str, sizeof(npa_str)));
-                        return hb_mc_manycore_vcache_flush_tag(mc, way_addr);
-                });
-
+        int err = hb_mc_manycore_pods_apply_to_vcache(mc, pods, n, hb_mc_manycore_vcache_flush_way);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        // read a word from each cache
-        hb_mc_coordinate_t dram;
-        hb_mc_config_pod_foreach_dram(dram, pod, &mc->config) {
-                hb_mc_epa_t cache_id = static_cast<hb_mc_epa_t>(hb_mc_config_dram_id(&mc->config, dram));
-                hb_mc_npa_t way_addr = hb_mc_vcache_way_npa(mc, cache_id, 0, 0);
-                hb_mc_npa_set_epa(&way_addr, 0);
-                uint32_t dummy;
-                err = hb_mc_manycore_read32(mc, &way_addr, &dummy);
-                if (err != HB_MC_SUCCESS)
-                        return err;
+        // read a word from each cache - when they all complete, the flushes are done
+        std::vector<hb_mc_npa_t> probes;
+        for (size_t p = 0; p < n; p++) {
+                hb_mc_coordinate_t dram;
+                hb_mc_config_pod_foreach_dram(dram, pods[p], &mc->config) {
+                        hb_mc_epa_t cache_id = static_cast<hb_mc_epa_t>(hb_mc_config_dram_id(&mc->config, dram));
+                        hb_mc_npa_t way_addr = hb_mc_vcache_way_npa(mc, cache_id, 0, 0);
+                        hb_mc_npa_set_epa(&way_addr, 0);
+                        probes.push_back(way_addr);
+                }
         }
-        return HB_MC_SUCCESS;
+
+        std::vector<uint32_t> dummy(probes.size());
+        return hb_mc_manycore_read_mem_scatter_gather(mc, probes.data(), dummy.data(), probes.size());
 }
 
 /**
- * Invalidate entire victim cache.
+ * Invalidate entire victim cache for pod.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
  */
-int hb_mc_manycore_invalidate_vcache(hb_mc_manycore_t *mc)
+int hb_mc_manycore_pod_invalidate_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
 {
-        int err;
+        return hb_mc_manycore_pods_invalidate_vcache(mc, &pod, 1);
+}
+
+/**
+ * Mark each way in victim cache as valid for pod.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ */
+int hb_mc_manycore_pod_validate_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
+{
+        return hb_mc_manycore_pods_validate_vcache(mc, &pod, 1);
+}
+
+/**
+ * Flush entire victim cache for pod.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ */
+int hb_mc_manycore_pod_flush_vcache(hb_mc_manycore_t *mc, hb_mc_coordinate_t pod)
+{
+        return hb_mc_manycore_pods_flush_vcache(mc, &pod, 1);
+}
+
+/* every pod of the machine */
+static std::vector<hb_mc_coordinate_t> hb_mc_manycore_all_pods(hb_mc_manycore_t *mc)
+{
+        std::vector<hb_mc_coordinate_t> pods;
         hb_mc_coordinate_t pod;
         hb_mc_config_foreach_pod(pod, &mc->config)
         {
-                err = hb_mc_manycore_pod_invalidate_vcache(mc, pod);
-                if (err != HB_MC_SUCCESS)
-                        return err;
+                pods.push_back(pod);
         }
-        return HB_MC_SUCCESS;
+        return pods;
+}
+
+/**
+ * Invalidate entire victim cache.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ */
+int hb_mc_manycore_invalidate_vcache(hb_mc_manycore_t *mc)
+{
+        std::vector<hb_mc_coordinate_t> pods = hb_mc_manycore_all_pods(mc);
+        return hb_mc_manycore_pods_invalidate_vcache(mc, pods.data(), pods.size());
 }
 
 
@@ -723,15 +966,8 @@ int hb_mc_manycore_invalidate_vcache(hb_mc_manycore_t *mc)
  */
 int hb_mc_manycore_validate_vcache(hb_mc_manycore_t *mc)
 {
-        int err;
-        hb_mc_coordinate_t pod;
-        hb_mc_config_foreach_pod(pod, &mc->config)
-        {
-                err = hb_mc_manycore_pod_validate_vcache(mc, pod);
-                if (err != HB_MC_SUCCESS)
-                        return err;
-        }
-        return HB_MC_SUCCESS;
+        std::vector<hb_mc_coordinate_t> pods = hb_mc_manycore_all_pods(mc);
+        return hb_mc_manycore_pods_validate_vcache(mc, pods.data(), pods.size());
 }
 
 /**
@@ -740,15 +976,8 @@ int hb_mc_manycore_validate_vcache(hb_mc_manycore_t *mc)
  */
 int hb_mc_manycore_flush_vcache(hb_mc_manycore_t *mc)
 {
-        int err;
-        hb_mc_coordinate_t pod;
-        hb_mc_config_foreach_pod(pod, &mc->config)
-        {
-                err = hb_mc_manycore_pod_flush_vcache(mc, pod);
-                if (err != HB_MC_SUCCESS)
-                        return err;
-        }
-        return HB_MC_SUCCESS;
+        std::vector<hb_mc_coordinate_t> pods = hb_mc_manycore_all_pods(mc);
+        return hb_mc_manycore_pods_flush_vcache(mc, pods.data(), pods.size());
 }
 
 
@@ -812,16 +1041,72 @@ static int hb_mc_manycore_send_read_rqst(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/* send an atomic memory operation and don't wait for the return packet */
+static int hb_mc_manycore_send_amo_rqst(hb_mc_manycore_t *mc,
+                                        const hb_mc_npa_t *npa,
+                                        hb_mc_packet_op_t op,
+                                        uint32_t operand,
+                                        uint32_t id = 0)
+{
+        hb_mc_packet_t rqst;
+        int err;
+
+        if (op < HB_MC_PACKET_OP_REMOTE_AMOSWAP || op > HB_MC_PACKET_OP_REMOTE_AMOMAXU) {
+                manycore_pr_err(mc, "%s: Bad AMO opcode %d\n", __func__, op);
+                return HB_MC_INVALID;
+        }
+
+        /* format the request packet */
+        err = hb_mc_manycore_format_request_packet(mc, &rqst.request, npa);
+        if (err != HB_MC_SUCCESS) {
+                manycore_pr_err(mc, "%s: Failed to format AMO request packet: %s\n",
+                                __func__, hb_mc_strerror(err));
+                return err;
+        }
+
+        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        err = hb_mc_manycore_epa_check_alignment(&epa, sizeof(uint32_t));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_request_packet_set_op(&rqst.request, op);
+        hb_mc_request_packet_set_data(&rqst.request, operand);
+        hb_mc_request_packet_set_load_id(&rqst.request, id);
+
+        manycore_pr_dbg(mc, "Sending AMO (op: %d) to NPA "
+                        "(x: %d, y: %d, 0x%08" PRIx32 ")\n",
+                        op,
+                        hb_mc_npa_get_x(npa),
+                        hb_mc_npa_get_y(npa),
+                        hb_mc_npa_get_epa(npa));
+
+        err = hb_mc_manycore_request_tx(mc, &rqst.request, -1);
+        if (err == HB_MC_BUSY)
+                return err; // omit the error message if just busy
+
+        if (err != HB_MC_SUCCESS) {
+                manycore_pr_err(mc, "%s: Failed to send request packet: %s\n",
+                                __func__, hb_mc_strerror(err));
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 /* read a response packet for a read request to an npa */
 static int hb_mc_manycore_recv_read_rsp(hb_mc_manycore_t *mc,
                                         uint32_t *vp,
-                                        uint32_t *id = nullptr)
+                                        uint32_t *id = nullptr,
+                                        long timeout = -1)
 {
         hb_mc_packet_t rsp;
         int err;
 
         /* receive a packet from the hardware */
-        err = hb_mc_manycore_response_rx(mc, &rsp.response, -1);
+        err = hb_mc_manycore_response_rx(mc, &rsp.response, timeout);
+        if (err == HB_MC_TIMEOUT)
+                return err; // omit the error message if just waiting
+
         if (err != HB_MC_SUCCESS) {
                 manycore_pr_err(mc, "%s: Failed to read response packet: %s\n",
                                 __func__, hb_mc_strerror(err));
@@ -837,33 +1122,12 @@ static int hb_mc_manycore_recv_read_rsp(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
-/* read from a memory address on the manycore */
-template <typename UINT>
-static int hb_mc_manycore_read(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, UINT *vp)
-{
-        int err;
-
-        /* send load request */
-        err = hb_mc_manycore_send_read_rqst(mc, npa, sizeof(UINT));
-        if (err != HB_MC_SUCCESS)
-                return err;
-
-        /* read back response */
-        uint32_t load_data;
-        err = hb_mc_manycore_recv_read_rsp(mc, &load_data);
-        if (err != HB_MC_SUCCESS)
-                return err;
-
-        /* mask off unused bits */
-        *vp = static_cast<UINT>(load_data);
-        return HB_MC_SUCCESS;
-}
 
-/* write to a memory address on the manycore */
-static int hb_mc_manycore_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const void *vp, size_t sz)
+/* format a store request to a memory address on the manycore */
+static int hb_mc_manycore_format_write_packet(hb_mc_manycore_t *mc, hb_mc_packet_t &rqst,
+                                              const hb_mc_npa_t *npa, const void *vp, size_t sz)
 {
         int err;
-        hb_mc_packet_t rqst;
 
         /* format the request packet */
         err = hb_mc_manycore_format_request_packet(mc, &rqst.request, npa);
@@ -901,7 +1165,6 @@ static int hb_mc_manycore_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, co
                 return HB_MC_INVALID;
         }
 
-        /* transmit the request */
         manycore_pr_dbg(mc, "Sending %d-byte write request to NPA "
                         "(x: %d, y: %d, 0x%08x) (data = 0x%08" PRIx32 ")\n",
                         sz,
@@ -910,15 +1173,62 @@ static int hb_mc_manycore_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, co
                         hb_mc_npa_get_epa(npa),
                         hb_mc_request_packet_get_data(&rqst.request));
 
-        return hb_mc_manycore_request_tx(mc, &rqst.request, -1);
+        return HB_MC_SUCCESS;
 }
 
-/* checks that the arguments of read/write_mem are supported */
-static int hb_mc_manycore_read_write_mem_check_args(hb_mc_manycore_t *mc,
-                                                    const char *caller_name,
-                                                    const void *data, size_t sz)
+/* write to a memory address on the manycore */
+static int hb_mc_manycore_write(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, const void *vp, size_t sz)
 {
-        uintptr_t ptr = (uintptr_t)data;
+        int err;
+        hb_mc_packet_t rqst;
+
+        err = hb_mc_manycore_format_write_packet(mc, rqst, npa, vp, sz);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* transmit the request */
+        return hb_mc_manycore_request_tx(mc, &rqst.request, -1);
+}
+
+/* the number of store requests formatted before they are handed to the platform */
+#define HB_MC_MANYCORE_TX_BATCH 64
+
+/* store words to consecutive addresses, handing the platform a batch of packets at a time */
+template <typename WordFunction>
+static int hb_mc_manycore_write_words(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                      size_t n_words, WordFunction word)
+{
+        hb_mc_packet_t batch[HB_MC_MANYCORE_TX_BATCH];
+        hb_mc_npa_t addr = *npa;
+        size_t n = 0;
+        int err;
+
+        for (size_t i = 0; i < n_words; i++) {
+                uint32_t data = word(i);
+                err = hb_mc_manycore_format_write_packet(mc, batch[n++], &addr, &data, sizeof(data));
+                if (err != HB_MC_SUCCESS)
+                        return err;
+
+                if (n == HB_MC_MANYCORE_TX_BATCH || i + 1 == n_words) {
+                        err = hb_mc_manycore_request_tx_batch(mc, batch, n, -1);
+                        if (err != HB_MC_SUCCESS)
+                                return err;
+                        n = 0;
+                }
+
+                // increment EPA by 4:
+                hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&addr) + sizeof(uint32_t));
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/* checks that the arguments of read/write_mem are supported */
+static int hb_mc_manycore_read_write_mem_check_args(hb_mc_manycore_t *mc,
+                                                    const char *caller_name,
+                                                    const void *data, size_t sz)
+{
+        uintptr_t ptr = (uintptr_t)data;
 
         if (ptr & 0x3) {
                 manycore_pr_err(mc, "%s: Input 'data' = %p: "
@@ -937,48 +1247,109 @@ static int hb_mc_manycore_read_write_mem_check_args(hb_mc_manycore_t *mc,
 }
 
 /**
- * Write memory out to manycore hardware starting at a given NPA
+ * Open a write session. Memory writes are posted without a fence until
+ * the matching hb_mc_manycore_write_commit(). Sessions nest.
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
- * @param[in]  npa    A valid hb_mc_npa_t
- * @param[in]  data   A buffer to be written out manycore hardware
- * @param[in]  sz     The number of bytes to write to manycore hardware
- * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
-int hb_mc_manycore_write_mem(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
-                             const void *data, size_t sz)
+int hb_mc_manycore_write_begin(hb_mc_manycore_t *mc)
 {
         int err;
 
-        err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, data, sz);
+        // a session only opens if the bulk transfer starts
+        if (mc->write_session == 0 &&
+            (err = hb_mc_platform_start_bulk_transfer(mc)) != HB_MC_SUCCESS)
+                return err;
+
+        mc->write_session++;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Close a write session. Closing the outermost session fences once.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. HB_MC_INVALID if no session is open.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_write_commit(hb_mc_manycore_t *mc)
+{
+        int err;
+
+        if (mc->write_session == 0) {
+                manycore_pr_err(mc, "%s: No write session is open\n", __func__);
+                return HB_MC_INVALID;
+        }
+
+        if (--mc->write_session > 0)
+                return HB_MC_SUCCESS;
+
+        err = hb_mc_manycore_host_request_fence(mc, -1);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        hb_mc_platform_start_bulk_transfer(mc);
+        return hb_mc_platform_finish_bulk_transfer(mc);
+}
 
-        const uint32_t *words = (const uint32_t*)data;
-        size_t n_words = sz >> 2;
-        hb_mc_npa_t addr = *npa;
+/* close the session of a write call, keeping the first error */
+static int hb_mc_manycore_write_close(hb_mc_manycore_t *mc, int err)
+{
+        int commit_err = hb_mc_manycore_write_commit(mc);
+        return err != HB_MC_SUCCESS ? err : commit_err;
+}
 
-        /* send store requests one word at a time */
-        for (size_t i = 0; i < n_words; i++) {
+/**
+ * Write a list of segments out to manycore hardware.
+ * All stores of all segments are issued in one bulk transfer and
+ * followed by a single fence.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  segs   An array of segments
+ * @param[in]  n      The number of segments in #segs
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_write_mem_segments(hb_mc_manycore_t *mc,
+                                      const hb_mc_manycore_mem_segment_t *segs,
+                                      size_t n)
+{
+        int err;
 
-                err = hb_mc_manycore_write(mc, &addr, &words[i], 4);
-                if (err != HB_MC_SUCCESS) {
-                        manycore_pr_err(mc, "%s: Failed to send write request: %s\n",
-                                        __func__, hb_mc_strerror(err));
+        for (size_t s = 0; s < n; s++) {
+                err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, segs[s].data, segs[s].sz);
+                if (err != HB_MC_SUCCESS)
                         return err;
-                }
-
-                // Increment EPA by 4:
-                hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&addr) + 4);
         }
 
-        err = hb_mc_manycore_host_request_fence(mc, -1);
+        err = hb_mc_manycore_write_begin(mc);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        hb_mc_platform_finish_bulk_transfer(mc);
-        return HB_MC_SUCCESS;
+        for (size_t s = 0; s < n && err == HB_MC_SUCCESS; s++) {
+                const uint32_t *words = (const uint32_t*)segs[s].data;
+                size_t n_words = segs[s].sz >> 2;
+
+                /* send store requests a batch at a time */
+                err = hb_mc_manycore_write_words(mc, &segs[s].npa, n_words,
+                                                 [=](size_t i) { return words[i]; });
+                if (err != HB_MC_SUCCESS)
+                        manycore_pr_err(mc, "%s: Failed to send write request: %s\n",
+                                        __func__, hb_mc_strerror(err));
+        }
+
+        return hb_mc_manycore_write_close(mc, err);
+}
+
+/**
+ * Write memory out to manycore hardware starting at a given NPA
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t
+ * @param[in]  data   A buffer to be written out manycore hardware
+ * @param[in]  sz     The number of bytes to write to manycore hardware
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_manycore_write_mem(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                             const void *data, size_t sz)
+{
+        hb_mc_manycore_mem_segment_t seg = { *npa, data, sz };
+        return hb_mc_manycore_write_mem_segments(mc, &seg, 1);
 }
 
 /**
@@ -1000,53 +1371,40 @@ int hb_mc_manycore_memset(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
 
         const uint32_t word = (val << 24) | (val << 16) | (val << 8) | val;
         size_t n_words = sz >> 2;
-        hb_mc_npa_t addr = *npa;
-
-        hb_mc_platform_start_bulk_transfer(mc);
-
-        /* send store requests one word at a time */
-        for (size_t i = 0; i < n_words; i++) {
-
-                err = hb_mc_manycore_write(mc, &addr, &word, 4);
-                if (err != HB_MC_SUCCESS) {
-                        manycore_pr_err(mc, "%s: Failed to send write request: %s\n",
-                                        __func__, hb_mc_strerror(err));
-                        return err;
-                }
 
-                // increment EPA by 1: (EPA's address words)
-                hb_mc_npa_set_epa(&addr, hb_mc_npa_get_epa(&addr) + sizeof(uint32_t));
-        }
-
-        err = hb_mc_manycore_host_request_fence(mc, -1);
+        err = hb_mc_manycore_write_begin(mc);
         if (err != HB_MC_SUCCESS)
                 return err;
 
-        hb_mc_platform_finish_bulk_transfer(mc);
+        /* send store requests a batch at a time */
+        err = hb_mc_manycore_write_words(mc, npa, n_words, [=](size_t) { return word; });
+        if (err != HB_MC_SUCCESS)
+                manycore_pr_err(mc, "%s: Failed to send write request: %s\n",
+                                __func__, hb_mc_strerror(err));
 
-        return HB_MC_SUCCESS;
+        return hb_mc_manycore_write_close(mc, err);
 }
 
 /**
- * Perform #cnt loads from a series of NPAs and return results in an associative container #data.
- * After returning success, #data[i] shall be the data read from the NPA given by #npa(i)
- * for i >= 0 and i < cnt.
+ * Perform #cnt requests that each return a word and collect results in an associative container #data.
+ * After returning success, #data[i] shall be the word returned by the request sent by #rqst(i, id)
+ * for i >= 0 and i < cnt. Requests are pipelined up to the remote load cap.
  *
- * @tparam UINT               The unsigned integer type for data loads.
- * @tparam UINTV              An associative container of UNT words (indexed by i).
- * @tparam NPA_OF_I_FUNCTION  Returns an NPA given an index i.
+ * @tparam UINT                The unsigned integer type for returned data.
+ * @tparam UINTV               An associative container of UNT words (indexed by i).
+ * @tparam RQST_OF_I_FUNCTION  Sends request i tagged with a load id; returns an error code.
  *
  * @param[in]  mc    A manycore instance.
- * @param[in]  npa   A function that takes an index i and returns an NPA.
- * @param[out] data  A mutable associative container by which load data is returned.
- * @param[in]  cnt   The number of loads to perform.
+ * @param[in]  rqst  A function that takes an index i and a load id and sends request i.
+ * @param[out] data  A mutable associative container by which returned data is written.
+ * @param[in]  cnt   The number of requests to perform.
  *
  * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
  */
-template <typename UINT, typename UINTV, typename NPA_OF_I_FUNCTION>
-static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
-                                            NPA_OF_I_FUNCTION npa,
-                                            UINTV & data, size_t cnt)
+template <typename UINT, typename UINTV, typename RQST_OF_I_FUNCTION>
+static int hb_mc_manycore_request_internal(hb_mc_manycore_t *mc,
+                                           RQST_OF_I_FUNCTION rqst,
+                                           UINTV & data, size_t cnt)
 {
         const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
         size_t rsp_i = 0, rqst_i = 0;
@@ -1060,54 +1418,65 @@ static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
         hb_mc_platform_start_bulk_transfer(mc);
 
         /* track requests and responses with ids and id_to_rsp_i */
-        std::stack <uint32_t, std::vector<uint32_t> > ids;
-        for (int i = n_ids - 1; i >= 0; i--)
-                ids.push(static_cast<uint32_t>(i));
+        /* bit i of free_ids is set if load id i is available */
+        const unsigned n_masks = (n_ids + 63) / 64;
+        uint64_t free_ids[n_masks];
+        size_t id_to_rsp_i[n_ids];
+        unsigned n_free = n_ids;
+        for (unsigned m = 0; m < n_masks; m++) {
+                unsigned bits = n_ids - 64 * m;
+                free_ids[m] = bits >= 64 ? ~0ull : ((1ull << bits) - 1);
+        }
 
-        std::map<uint32_t, uint32_t> id_to_rsp_i;
-        hb_mc_npa_t id_to_npa[n_ids];
+        /* load ids held by split-phase requests are not ours to use */
+        for (unsigned id = 0; id < n_ids; id++) {
+                if (hb_mc_manycore_async_is_pending(mc, id)) {
+                        free_ids[id / 64] &= ~(1ull << (id % 64));
+                        n_free--;
+                }
+        }
 
         /* until we've received all responses... */
         while (rsp_i < cnt) {
 
                 /* try to request as many words as we have left */
                 while (rqst_i < cnt) {
-                        // get the NPA of the next load address
-                        hb_mc_npa_t rqst_addr = npa(rqst_i);
-
                         // if we're out of load ids, break to start reading requests
-                        if (ids.empty())
+                        if (n_free == 0)
                                 break;
 
                         // get an available load id for this load request
-                        uint32_t rqst_load_id = ids.top();
+                        unsigned m = 0;
+                        while (free_ids[m] == 0)
+                                m++;
+                        uint32_t rqst_load_id = 64 * m + __builtin_ctzll(free_ids[m]);
 
                         // save which request this is
                         id_to_rsp_i[rqst_load_id] = rqst_i;
-                        id_to_npa[rqst_load_id] = rqst_addr;
 
-                        // send a load request
-                        err = hb_mc_manycore_send_read_rqst(mc, &rqst_addr, sizeof(UINT),
-                                                            rqst_load_id);
+                        // send the request
+                        err = rqst(rqst_i, rqst_load_id);
                         if (err == HB_MC_SUCCESS) {
-                                // success; increment succesful requests and pop the load id
+                                // success; increment succesful requests and take the load id
                                 rqst_i++;
-                                ids.pop();
+                                free_ids[m] &= ~(1ull << (rqst_load_id % 64));
+                                n_free--;
                         } else if (err == HB_MC_BUSY) {
                                 // if we're busy, break to start reading requests
                                 break;
                         } else {
                                 // we've hit some other error: abort with an error message
-                                manycore_pr_err(mc, "%s: Failed to send read request: %s\n",
+                                manycore_pr_err(mc, "%s: Failed to send request: %s\n",
                                                 __func__, hb_mc_strerror(err));
                                 return err;
                         }
-                        manycore_pr_dbg(mc, "%s: Sent read request with load_id = %" PRIu32 "\n",
+                        manycore_pr_dbg(mc, "%s: Sent request with load_id = %" PRIu32 "\n",
                                         __func__, rqst_load_id);
                 }
 
                 /* read all available response packets */
-                while (rsp_i < rqst_i) {
+                /* if split-phase requests hold every id, wait for one of them */
+                while (rsp_i < rqst_i || n_free == 0) {
                         /* read a response and write it back to the location marked by load_id */
                         uint32_t read_data, load_id;
                         err = hb_mc_manycore_recv_read_rsp(mc, &read_data, &load_id);
@@ -1127,17 +1496,25 @@ static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
                                 return HB_MC_FAIL;
                         }
 
+                        // set aside a response to a split-phase request and take its id
+                        if (hb_mc_manycore_async_is_pending(mc, load_id)) {
+                                hb_mc_manycore_async_complete(mc, load_id, read_data);
+                                free_ids[load_id / 64] |= 1ull << (load_id % 64);
+                                n_free++;
+                                continue;
+                        }
+
                         // This would be an unexpected response
-                        if (id_to_rsp_i.count(load_id) == 0) {
+                        if (free_ids[load_id / 64] & (1ull << (load_id % 64))) {
                                 manycore_pr_err(mc, "%s: Unexpected load id = %" PRIu32 "\n",
                                                 __func__, load_id);
                                 return HB_MC_FAIL;
                         }
-                        uint32_t idx = id_to_rsp_i[load_id];
-                        
+                        size_t idx = id_to_rsp_i[load_id];
+
                         // This would be a runtime writer error... or worse.
-                        if (idx > cnt) {
-                                manycore_pr_err(mc, "%s: Return index outside of array. Idx = %" PRIu32 "\n",
+                        if (idx >= cnt) {
+                                manycore_pr_err(mc, "%s: Return index outside of array. Idx = %zu\n",
                                                 __func__, idx);
                                 return HB_MC_FAIL;
                         }
@@ -1147,8 +1524,9 @@ static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
                         // increment succesful responses
                         rsp_i++;
 
-                        // push the load id onto the stack so we can use it again
-                        ids.push(load_id);
+                        // return the load id so we can use it again
+                        free_ids[load_id / 64] |= 1ull << (load_id % 64);
+                        n_free++;
                 }
         }
         hb_mc_platform_finish_bulk_transfer(mc);
@@ -1156,6 +1534,69 @@ static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Perform #cnt loads from a series of NPAs and return results in an associative container #data.
+ * After returning success, #data[i] shall be the data read from the NPA given by #npa(i)
+ * for i >= 0 and i < cnt.
+ *
+ * @tparam UINT               The unsigned integer type for data loads.
+ * @tparam UINTV              An associative container of UNT words (indexed by i).
+ * @tparam NPA_OF_I_FUNCTION  Returns an NPA given an index i.
+ *
+ * @param[in]  mc    A manycore instance.
+ * @param[in]  npa   A function that takes an index i and returns an NPA.
+ * @param[out] data  A mutable associative container by which load data is returned.
+ * @param[in]  cnt   The number of loads to perform.
+ *
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+template <typename UINT, typename UINTV, typename NPA_OF_I_FUNCTION>
+static int hb_mc_manycore_read_mem_internal(hb_mc_manycore_t *mc,
+                                            NPA_OF_I_FUNCTION npa,
+                                            UINTV & data, size_t cnt)
+{
+        /* request i => load from npa(i) */
+        struct rqst_function {
+                hb_mc_manycore_t *mc;
+                NPA_OF_I_FUNCTION &npa;
+                rqst_function(hb_mc_manycore_t *mc, NPA_OF_I_FUNCTION &npa) : mc(mc), npa(npa) {}
+                int operator()(size_t i, uint32_t id) {
+                        hb_mc_npa_t rqst_addr = npa(i);
+                        return hb_mc_manycore_send_read_rqst(mc, &rqst_addr, sizeof(UINT), id);
+                }
+        };
+
+        return hb_mc_manycore_request_internal<UINT>(mc, rqst_function(mc, npa), data, cnt);
+}
+
+/* read from a memory address on the manycore */
+template <typename UINT>
+static int hb_mc_manycore_read(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, UINT *vp)
+{
+        int err;
+
+        /* share load ids with split-phase requests */
+        if (mc->async != nullptr && mc->async->n_pending > 0) {
+                auto npa_function = [npa](size_t i) { return *npa; };
+                return hb_mc_manycore_read_mem_internal<UINT>(mc, npa_function, vp, 1);
+        }
+
+        /* send load request */
+        err = hb_mc_manycore_send_read_rqst(mc, npa, sizeof(UINT));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* read back response */
+        uint32_t load_data;
+        err = hb_mc_manycore_recv_read_rsp(mc, &load_data);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        /* mask off unused bits */
+        *vp = static_cast<UINT>(load_data);
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Read memory from a vector of NPAs
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -1212,6 +1653,68 @@ int hb_mc_manycore_read_mem(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
         return hb_mc_manycore_read_mem_internal<uint32_t>(mc, npa_function(npa), words, n_words);
 }
 
+/**
+ * Read a list of segments from manycore hardware.
+ * Loads are pipelined across segment boundaries, so the load-id
+ * window stays full until the last word of the last segment.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  segs   An array of segments
+ * @param[in]  n      The number of segments in #segs
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_read_mem_segments(hb_mc_manycore_t *mc,
+                                     const hb_mc_manycore_read_segment_t *segs,
+                                     size_t n)
+{
+        int err;
+
+        /* first_word[s] is the index of the first word of segment s */
+        std::vector<size_t> first_word(n + 1, 0);
+        for (size_t s = 0; s < n; s++) {
+                err = hb_mc_manycore_read_write_mem_check_args(mc, __func__, segs[s].data, segs[s].sz);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+                first_word[s+1] = first_word[s] + (segs[s].sz >> 2);
+        }
+
+        /* ith NPA => the word of the segment holding i; requests are issued in order */
+        struct npa_function {
+                const hb_mc_manycore_read_segment_t *segs;
+                const std::vector<size_t> *first_word;
+                size_t seg;
+                npa_function(const hb_mc_manycore_read_segment_t *segs,
+                             const std::vector<size_t> *first_word) :
+                        segs(segs), first_word(first_word), seg(0) {}
+                hb_mc_npa_t operator()(size_t i) {
+                        while (i >= (*first_word)[seg+1])
+                                seg++;
+                        const hb_mc_npa_t *npa = &segs[seg].npa;
+                        return hb_mc_npa_from_x_y(hb_mc_npa_get_x(npa),
+                                                  hb_mc_npa_get_y(npa),
+                                                  hb_mc_npa_get_epa(npa) +
+                                                  (i - (*first_word)[seg])*sizeof(uint32_t));
+                }
+        };
+
+        /* ith word => the word of the segment holding i; responses arrive in any order */
+        struct word_vector {
+                const hb_mc_manycore_read_segment_t *segs;
+                const std::vector<size_t> *first_word;
+                word_vector(const hb_mc_manycore_read_segment_t *segs,
+                            const std::vector<size_t> *first_word) :
+                        segs(segs), first_word(first_word) {}
+                uint32_t & operator[](size_t i) {
+                        size_t seg = std::upper_bound(first_word->begin(), first_word->end(), i)
+                                - first_word->begin() - 1;
+                        return static_cast<uint32_t*>(segs[seg].data)[i - (*first_word)[seg]];
+                }
+        };
+
+        word_vector words(segs, &first_word);
+        return hb_mc_manycore_read_mem_internal<uint32_t>(mc, npa_function(segs, &first_word),
+                                                          words, first_word[n]);
+}
+
 /**
  * Read one byte from manycore hardware at a given NPA
  * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -1284,6 +1787,285 @@ int hb_mc_manycore_write32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, uint32_
         return hb_mc_manycore_write(mc, npa, &v, 4);
 }
 
+/**
+ * Write the same 32-bit word to a list of NPAs.
+ * All stores are issued back-to-back and followed by a single fence.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npas   An array of valid hb_mc_npa_t aligned to a four byte boundary
+ * @param[in]  n      The number of NPAs in #npas
+ * @param[in]  v      A word value to be written out
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_manycore_write32_multi(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                 size_t n, uint32_t v)
+{
+        int err;
+
+        err = hb_mc_manycore_write_begin(mc);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (size_t i = 0; i < n; i++) {
+                err = hb_mc_manycore_write(mc, &npas[i], &v, 4);
+                if (err != HB_MC_SUCCESS) {
+                        manycore_pr_err(mc, "%s: Failed to send write request: %s\n",
+                                        __func__, hb_mc_strerror(err));
+                        break;
+                }
+        }
+
+        return hb_mc_manycore_write_close(mc, err);
+}
+
+/**
+ * Perform a 32-bit atomic memory operation at a given NPA
+ * and return the value held at the NPA before the operation.
+ * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa      A valid hb_mc_npa_t aligned to a four byte boundary
+ * @param[in]  op       One of HB_MC_PACKET_OP_REMOTE_AMO*
+ * @param[in]  operand  Operand of the AMO
+ * @param[out] old      Set to the value held at #npa before the AMO. May be NULL.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_amo32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                         hb_mc_packet_op_t op, uint32_t operand, uint32_t *old)
+{
+        uint32_t data;
+        int err;
+
+        /* share load ids with split-phase requests */
+        if (mc->async != nullptr && mc->async->n_pending > 0) {
+                hb_mc_manycore_amo_t amo = {*npa, op, operand, 0};
+                err = hb_mc_manycore_amo32_multi(mc, &amo, 1);
+                if (err == HB_MC_SUCCESS && old != nullptr)
+                        *old = amo.old;
+                return err;
+        }
+
+        err = hb_mc_manycore_send_amo_rqst(mc, npa, op, operand);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        err = hb_mc_manycore_recv_read_rsp(mc, &data);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        if (old != nullptr)
+                *old = data;
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Perform a list of 32-bit atomic memory operations.
+ * AMOs are pipelined up to the remote load cap and may complete in any order.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in,out] amos   An array of AMOs; the old field of each is set on success
+ * @param[in]  n      The number of AMOs in #amos
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_amo32_multi(hb_mc_manycore_t *mc, hb_mc_manycore_amo_t *amos, size_t n)
+{
+        /* request i => amos[i] */
+        struct rqst_function {
+                hb_mc_manycore_t *mc;
+                const hb_mc_manycore_amo_t *amos;
+                rqst_function(hb_mc_manycore_t *mc, const hb_mc_manycore_amo_t *amos) :
+                        mc(mc), amos(amos) {}
+                int operator()(size_t i, uint32_t id) {
+                        return hb_mc_manycore_send_amo_rqst(mc, &amos[i].npa, amos[i].op,
+                                                            amos[i].operand, id);
+                }
+        };
+
+        /* ith word => amos[i].old */
+        struct old_vector {
+                hb_mc_manycore_amo_t *amos;
+                old_vector(hb_mc_manycore_amo_t *amos) : amos(amos) {}
+                uint32_t & operator[](size_t i) { return amos[i].old; }
+        };
+
+        old_vector olds(amos);
+        return hb_mc_manycore_request_internal<uint32_t>(mc, rqst_function(mc, amos), olds, n);
+}
+
+/////////////////////
+// Split-phase API //
+/////////////////////
+
+/* receive one response to a split-phase request */
+static int hb_mc_manycore_async_recv(hb_mc_manycore_t *mc, long timeout)
+{
+        uint32_t data, load_id;
+        int err;
+
+        err = hb_mc_manycore_recv_read_rsp(mc, &data, &load_id, timeout);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        if (!hb_mc_manycore_async_is_pending(mc, load_id)) {
+                manycore_pr_err(mc, "%s: Unexpected load id = %" PRIu32 "\n",
+                                __func__, load_id);
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_manycore_async_complete(mc, load_id, data);
+        return HB_MC_SUCCESS;
+}
+
+/* find the slot of an outstanding ticket */
+static hb_mc_manycore_async_slot_t *hb_mc_manycore_async_slot(hb_mc_manycore_t *mc,
+                                                              hb_mc_manycore_ticket_t ticket)
+{
+        uint32_t id = ticket & HB_MC_TICKET_ID_MASK;
+
+        if (mc->async == nullptr || id >= mc->async->slots.size())
+                return nullptr;
+
+        hb_mc_manycore_async_slot_t *slot = &mc->async->slots[id];
+        if (slot->state == HB_MC_ASYNC_FREE || slot->ticket != ticket)
+                return nullptr;
+
+        return slot;
+}
+
+/**
+ * Send a read request and return without waiting for the response.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t aligned to #sz
+ * @param[in]  sz     The number of bytes to read: 1, 2, or 4
+ * @param[out] ticket Set to a ticket for the request
+ * @return HB_MC_SUCCESS on success. HB_MC_BUSY if every load id is held by a ticket.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_read_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                              size_t sz, hb_mc_manycore_ticket_t *ticket)
+{
+        int err;
+
+        if (ticket == nullptr)
+                return HB_MC_INVALID;
+
+        if (mc->async == nullptr) {
+                unsigned n_ids = hb_mc_config_get_io_remote_load_cap(hb_mc_manycore_get_config(mc));
+                mc->async = new hb_mc_manycore_async;
+                mc->async->slots.resize(std::min(n_ids, HB_MC_TICKET_ID_MASK + 1),
+                                        hb_mc_manycore_async_slot_t());
+                mc->async->n_pending = 0;
+                mc->async->seq = 0;
+        }
+
+        struct hb_mc_manycore_async *async = mc->async;
+        uint32_t id = 0;
+        while (id < async->slots.size() && async->slots[id].state != HB_MC_ASYNC_FREE)
+                id++;
+
+        if (id == async->slots.size())
+                return HB_MC_BUSY;
+
+        err = hb_mc_manycore_send_read_rqst(mc, npa, sz, id);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        async->seq++;
+        async->slots[id].state = HB_MC_ASYNC_PENDING;
+        async->slots[id].ticket = (async->seq << HB_MC_TICKET_ID_BITS) | id;
+        async->n_pending++;
+
+        *ticket = async->slots[id].ticket;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Collect any responses that have already arrived and check a ticket.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  ticket A ticket returned by hb_mc_manycore_read_async()
+ * @param[out] data   Set to the data read if #ticket has completed. May be NULL.
+ * @return HB_MC_SUCCESS if #ticket has completed, which releases it.
+ *         HB_MC_BUSY if #ticket is still outstanding.
+ *         HB_MC_INVALID if #ticket is not outstanding.
+ */
+int hb_mc_manycore_poll(hb_mc_manycore_t *mc, hb_mc_manycore_ticket_t ticket,
+                        uint32_t *data)
+{
+        hb_mc_manycore_async_slot_t *slot = hb_mc_manycore_async_slot(mc, ticket);
+        int err;
+
+        if (slot == nullptr)
+                return HB_MC_INVALID;
+
+        /* drain whatever has arrived without waiting */
+        while (mc->async->n_pending > 0) {
+                err = hb_mc_manycore_async_recv(mc, 0);
+                if (err == HB_MC_TIMEOUT)
+                        break;
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        if (slot->state == HB_MC_ASYNC_PENDING)
+                return HB_MC_BUSY;
+
+        if (data != nullptr)
+                *data = slot->data;
+        slot->state = HB_MC_ASYNC_FREE;
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Wait for a set of tickets to complete. Responses may arrive in any order.
+ * @param[in]  mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  tickets An array of tickets returned by hb_mc_manycore_read_async()
+ * @param[in]  n       The number of tickets in #tickets
+ * @param[out] data    An array of #n words set to the data read for each ticket. May be NULL.
+ * @param[in]  timeout Retries for each receive before HB_MC_TIMEOUT, or -1 to wait forever.
+ * @return HB_MC_SUCCESS if every ticket completed, which releases them all.
+ *         HB_MC_TIMEOUT if a receive timed out; no ticket is released and the call may be repeated.
+ *         HB_MC_INVALID if a ticket is not outstanding or appears twice; no ticket is released.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_manycore_wait(hb_mc_manycore_t *mc, const hb_mc_manycore_ticket_t *tickets,
+                        size_t n, uint32_t *data, long timeout)
+{
+        int err;
+
+        // check every ticket before waiting on any, so none is released twice
+        for (size_t i = 0; i < n; i++) {
+                if (hb_mc_manycore_async_slot(mc, tickets[i]) == nullptr) {
+                        manycore_pr_err(mc, "%s: Ticket 0x%08" PRIx32 " is not outstanding\n",
+                                        __func__, tickets[i]);
+                        return HB_MC_INVALID;
+                }
+
+                for (size_t j = 0; j < i; j++) {
+                        if (tickets[j] == tickets[i]) {
+                                manycore_pr_err(mc, "%s: Ticket 0x%08" PRIx32 " appears more than once\n",
+                                                __func__, tickets[i]);
+                                return HB_MC_INVALID;
+                        }
+                }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+                hb_mc_manycore_async_slot_t *slot = hb_mc_manycore_async_slot(mc, tickets[i]);
+                while (slot->state == HB_MC_ASYNC_PENDING) {
+                        err = hb_mc_manycore_async_recv(mc, timeout);
+                        if (err != HB_MC_SUCCESS)
+                                return err;
+                }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+                hb_mc_manycore_async_slot_t *slot = hb_mc_manycore_async_slot(mc, tickets[i]);
+                if (data != nullptr)
+                        data[i] = slot->data;
+                slot->state = HB_MC_ASYNC_FREE;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 
 /**
  * Enable DRAM mode on the manycore instance.
@@ -51,11 +51,15 @@ extern "C" {
         typedef int hb_mc_manycore_id_t;
 #define HB_MC_MANYCORE_ID_ANY -1
 
+        struct hb_mc_manycore_async;
+
         typedef struct hb_mc_manycore {
                 const char *name;      //!< the name of this manycore
                 hb_mc_config_t config; //!< configuration of the manycore
                 void *platform;        //!< machine-specific data pointer
                 int dram_enabled;      //!< operating in no-dram mode?
+                struct hb_mc_manycore_async *async; //!< load ids held by split-phase requests
+                int write_session;     //!< depth of open write sessions
         } hb_mc_manycore_t;
 
 #define HB_MC_MANYCORE_INIT {0}
@@ -91,6 +95,15 @@ extern "C" {
         __attribute__((warn_unused_result))
         int  hb_mc_manycore_init(hb_mc_manycore_t *mc, const char *name, hb_mc_manycore_id_t id);
 
+        /**
+         * Make the next hb_mc_manycore_init() in this process save or
+         * restore a checkpoint. Later inits are not affected. Regression
+         * programs set this from --checkpoint-save and --checkpoint-restore.
+         * @param[in] save     Checkpoint to save once reset, DRAM enable and vcache init are done, or NULL
+         * @param[in] restore  Checkpoint to restore in place of those three steps, or NULL
+         */
+        void hb_mc_manycore_init_checkpoint(const char *save, const char *restore);
+
         /**
          * Cleanup an initialized manycore instance
          * @param[in] mc   A manycore instance that has been initialized with hb_mc_manycore_init()
@@ -106,7 +119,7 @@ extern "C" {
          * Transmit a request packet to manycore hardware
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] request A request packet to transmit to manycore hardware
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -114,11 +127,25 @@ extern "C" {
                                       hb_mc_request_packet_t *request,
                                       long timeout);
 
+        /**
+         * Transmit an array of request packets to manycore hardware, in order
+         * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] requests An array of #n packets holding requests to transmit
+         * @param[in] n        The number of packets
+         * @param[in] timeout  Retries per packet before HB_MC_TIMEOUT, or -1 to wait forever.
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_request_tx_batch(hb_mc_manycore_t *mc,
+                                            hb_mc_packet_t *requests,
+                                            size_t n,
+                                            long timeout);
+
         /**
          * Receive a response packet from manycore hardware
          * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] response A packet into which data should be read
-         * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout  Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -130,7 +157,7 @@ extern "C" {
          * Transmit a response packet to manycore hardware
          * @param[in] mc        A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] response  A response packet to transmit to manycore hardware
-         * @param[in] timeout   A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout   Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -142,7 +169,7 @@ extern "C" {
          * Receive a request packet from manycore hardware
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] request A packet into which data should be read
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -155,7 +182,7 @@ extern "C" {
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] packet  A packet to transmit to manycore hardware
          * @param[in] type    Is this packet a request or response packet?
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result, deprecated))
@@ -169,7 +196,7 @@ extern "C" {
          * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] packet A packet into which data should be read
          * @param[in] type   Is this packet a request or response packet?
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         __attribute__((warn_unused_result))
@@ -253,6 +280,109 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_manycore_write32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa, uint32_t v);
 
+        /**
+         * Write the same 32-bit word to a list of NPAs.
+         * All stores are issued back-to-back and followed by a single fence.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npas   An array of valid hb_mc_npa_t aligned to a four byte boundary
+         * @param[in]  n      The number of NPAs in #npas
+         * @param[in]  v      A word value to be written out
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write32_multi(hb_mc_manycore_t *mc, const hb_mc_npa_t *npas,
+                                         size_t n, uint32_t v);
+
+        /**
+         * A single 32-bit atomic memory operation issued by the host.
+         */
+        typedef struct {
+                hb_mc_npa_t       npa;      //!< Target NPA, aligned to a four byte boundary
+                hb_mc_packet_op_t op;       //!< One of HB_MC_PACKET_OP_REMOTE_AMO*
+                uint32_t          operand;  //!< Operand of the AMO
+                uint32_t          old;      //!< Set to the value held before the AMO
+        } hb_mc_manycore_amo_t;
+
+        /**
+         * Perform a 32-bit atomic memory operation at a given NPA
+         * and return the value held at the NPA before the operation.
+         * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npa      A valid hb_mc_npa_t aligned to a four byte boundary
+         * @param[in]  op       One of HB_MC_PACKET_OP_REMOTE_AMO*
+         * @param[in]  operand  Operand of the AMO
+         * @param[out] old      Set to the value held at #npa before the AMO. May be NULL.
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         *
+         * Vanilla cores implement only AMOSWAP and AMOOR in their scratchpad;
+         * the victim caches implement the full set.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_amo32(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                 hb_mc_packet_op_t op, uint32_t operand, uint32_t *old);
+
+        /**
+         * Perform a list of 32-bit atomic memory operations.
+         * AMOs are pipelined up to the remote load cap and may complete in
+         * any order; AMOs to the same NPA are not guaranteed to be ordered.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in,out] amos   An array of AMOs; the old field of each is set on success
+         * @param[in]  n      The number of AMOs in #amos
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_amo32_multi(hb_mc_manycore_t *mc, hb_mc_manycore_amo_t *amos, size_t n);
+
+        /**
+         * Identifies an outstanding split-phase request.
+         */
+        typedef uint32_t hb_mc_manycore_ticket_t;
+
+        /**
+         * Send a read request and return without waiting for the response.
+         * The response is claimed with hb_mc_manycore_poll() or hb_mc_manycore_wait().
+         * Synchronous reads may be issued while tickets are outstanding; they use
+         * the load ids not held by a ticket and set aside responses to tickets.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  npa    A valid hb_mc_npa_t aligned to #sz
+         * @param[in]  sz     The number of bytes to read: 1, 2, or 4
+         * @param[out] ticket Set to a ticket for the request
+         * @return HB_MC_SUCCESS on success. HB_MC_BUSY if every load id is held by a ticket.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_read_async(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
+                                      size_t sz, hb_mc_manycore_ticket_t *ticket);
+
+        /**
+         * Collect any responses that have already arrived and check a ticket.
+         * This call does not block.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  ticket A ticket returned by hb_mc_manycore_read_async()
+         * @param[out] data   Set to the data read if #ticket has completed. May be NULL.
+         * @return HB_MC_SUCCESS if #ticket has completed, which releases it.
+         *         HB_MC_BUSY if #ticket is still outstanding.
+         *         HB_MC_INVALID if #ticket is not outstanding.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_poll(hb_mc_manycore_t *mc, hb_mc_manycore_ticket_t ticket,
+                                uint32_t *data);
+
+        /**
+         * Wait for a set of tickets to complete. Responses may arrive in any order.
+         * @param[in]  mc      A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  tickets An array of tickets returned by hb_mc_manycore_read_async()
+         * @param[in]  n       The number of tickets in #tickets
+         * @param[out] data    An array of #n words set to the data read for each ticket. May be NULL.
+         * @param[in]  timeout Retries for each receive before HB_MC_TIMEOUT, or -1 to wait forever.
+         * @return HB_MC_SUCCESS if every ticket completed, which releases them all.
+         *         HB_MC_TIMEOUT if a receive timed out; no ticket is released and the call may be repeated.
+         *         HB_MC_INVALID if a ticket is not outstanding or appears twice; no ticket is released.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_wait(hb_mc_manycore_t *mc, const hb_mc_manycore_ticket_t *tickets,
+                                size_t n, uint32_t *data, long timeout);
+
         /**
          * Set memory to a given value starting at a given NPA
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -265,6 +395,49 @@ extern "C" {
         int hb_mc_manycore_memset(hb_mc_manycore_t *mc, const hb_mc_npa_t *npa,
                                   uint8_t data, size_t sz);
 
+        /**
+         * A host buffer and the contiguous run of NPAs it is written to.
+         */
+        typedef struct {
+                hb_mc_npa_t npa;   //!< First NPA of the run
+                const void *data;  //!< Host buffer, 32-bit aligned
+                size_t      sz;    //!< Bytes to write, a multiple of 4
+        } hb_mc_manycore_mem_segment_t;
+
+        /**
+         * Open a write session. Until the matching hb_mc_manycore_write_commit(),
+         * memory writes are posted without a fence; stores to one destination
+         * arrive in the order they were issued. Sessions nest.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write_begin(hb_mc_manycore_t *mc);
+
+        /**
+         * Close a write session. Closing the outermost session fences once,
+         * so every write posted in the session has landed on return.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @return HB_MC_SUCCESS on success. HB_MC_INVALID if no session is open.
+         *         Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write_commit(hb_mc_manycore_t *mc);
+
+        /**
+         * Write a list of segments out to manycore hardware.
+         * All stores of all segments are issued in one bulk transfer and
+         * followed by a single fence, which is deferred inside a write session.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  segs   An array of segments
+         * @param[in]  n      The number of segments in #segs
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_write_mem_segments(hb_mc_manycore_t *mc,
+                                              const hb_mc_manycore_mem_segment_t *segs,
+                                              size_t n);
+
         /**
          * Write memory out to manycore hardware starting at a given NPA
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -290,6 +463,29 @@ extern "C" {
                                     void *data, size_t sz);
 
 
+        /**
+         * A contiguous run of NPAs and the host buffer it is read into.
+         */
+        typedef struct {
+                hb_mc_npa_t npa;   //!< First NPA of the run
+                void       *data;  //!< Host buffer, 32-bit aligned
+                size_t      sz;    //!< Bytes to read, a multiple of 4
+        } hb_mc_manycore_read_segment_t;
+
+        /**
+         * Read a list of segments from manycore hardware.
+         * Loads are pipelined across segment boundaries, so the load-id
+         * window stays full until the last word of the last segment.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  segs   An array of segments
+         * @param[in]  n      The number of segments in #segs
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_read_mem_segments(hb_mc_manycore_t *mc,
+                                             const hb_mc_manycore_read_segment_t *segs,
+                                             size_t n);
+
         /**
          * Read memory from a vector of NPAs
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -413,6 +609,31 @@ extern "C" {
         }
 
 
+        /**
+         * A range of manycore DRAM addresses.
+         */
+        typedef struct {
+                hb_mc_npa_t npa;  //!< First NPA of the range
+                size_t      sz;   //!< Size of the range in bytes
+        } hb_mc_manycore_npa_range_t;
+
+        /**
+         * Apply a cache operation to every cache line of a list of NPA ranges.
+         * Lines are coalesced per victim cache, the packets are sent back to back,
+         * and a single fence follows. A flush reads one word from each victim
+         * cache it touched; AFLINV is a probed flush followed by an invalidate.
+         * @param[in]  mc       A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  ranges   An array of ranges (must map to DRAM)
+         * @param[in]  n        The number of ranges in #ranges
+         * @param[in]  cache_op HB_MC_PACKET_CACHE_OP_AFL, _AINV, or _AFLINV
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_vcache_op_npa_ranges(hb_mc_manycore_t *mc,
+                                                const hb_mc_manycore_npa_range_t *ranges,
+                                                size_t n,
+                                                hb_mc_packet_cache_op_t cache_op);
+
         /**
          * Invalidate a range of manycore DRAM addresses.
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -464,6 +685,36 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_manycore_flush_vcache(hb_mc_manycore_t *mc);
 
+        /**
+         * Invalidate entire victim cache for a list of pods.
+         * Tag writes to all caches of all pods are interleaved and fenced once.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  pods   An array of #n pod coordinates
+         * @param[in]  n      The number of pods
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_pods_invalidate_vcache(hb_mc_manycore_t *mc, const hb_mc_coordinate_t *pods, size_t n);
+
+        /**
+         * Mark each way in victim cache as valid for a list of pods.
+         * Tag writes to all caches of all pods are interleaved and fenced once.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  pods   An array of #n pod coordinates
+         * @param[in]  n      The number of pods
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_pods_validate_vcache(hb_mc_manycore_t *mc, const hb_mc_coordinate_t *pods, size_t n);
+
+        /**
+         * Flush entire victim cache for a list of pods.
+         * Tag flushes to all caches of all pods are interleaved and fenced once.
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  pods   An array of #n pod coordinates
+         * @param[in]  n      The number of pods
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_pods_flush_vcache(hb_mc_manycore_t *mc, const hb_mc_coordinate_t *pods, size_t n);
+
         /**
          * Invalidate entire victim cache for pod.
          * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
@@ -547,6 +798,28 @@ extern "C" {
          */
         int hb_mc_manycore_get_cycle(hb_mc_manycore_t *mc, uint64_t *time);
 
+        /**
+         * Fence, then save the state of the manycore hardware (including
+         * DRAM) to a checkpoint. hb_mc_manycore_init_checkpoint() makes
+         * a later hb_mc_manycore_init() save one or start from one.
+         * Host-side state (e.g. allocators, loaded program symbols) is not saved.
+         * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] path   The checkpoint file
+         * @return HB_MC_NOIMPL if the platform cannot checkpoint. HB_MC_SUCCESS on success.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_checkpoint_save(hb_mc_manycore_t *mc, const char *path);
+
+        /**
+         * Replace the state of the manycore hardware (including DRAM)
+         * with a checkpoint saved by hb_mc_manycore_checkpoint_save().
+         * @param[in] mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] path   The checkpoint file
+         * @return HB_MC_NOIMPL if the platform cannot checkpoint. HB_MC_SUCCESS on success.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_checkpoint_restore(hb_mc_manycore_t *mc, const char *path);
+
         typedef enum {
                 e_instr_float = 0, //<! Floating Point Instructions
                 e_instr_int = 1, //<! Integer Instructions
@@ -27,7 +27,6 @@
 #include <bsg_manycore_cuda.h>
 #include <bsg_manycore_cuda_barrier.h>
 #include <bsg_manycore_tile.h>
-#include <bsg_manycore_memory_manager.h>
 #include <bsg_manycore_elf.h>
 #include <bsg_manycore_loader.h>
 #include <bsg_manycore.h>
@@ -36,9 +35,20 @@
 #include <bsg_manycore_origin_eva_map.h>
 #include <bsg_manycore_config_pod.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #ifdef __cplusplus
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
 #else
+#include <stddef.h>
 #include <string.h>
 #endif
 
@@ -110,6 +120,8 @@ static int kernel_init(hb_mc_kernel_t *kernel, const char *name, uint32_t argc,
         memcpy(const_cast<uint32_t*>(kernel->argv), argv, argc * sizeof(*argv));
         kernel->argc = argc;
         kernel->refcount = 0;
+        kernel->finished = NULL;
+        kernel->argv_eva = 0;
 
         return HB_MC_SUCCESS;
 }
@@ -142,6 +154,12 @@ static int kernel_exit(hb_mc_kernel_t *kernel)
 ////////////////////////
 // Tile group helpers //
 ////////////////////////
+__attribute__((warn_unused_result))
+static int hb_mc_device_pod_barcfg_release(hb_mc_device_t *device,
+                                           hb_mc_pod_t *pod,
+                                           hb_mc_dimension_t dim,
+                                           hb_mc_eva_t barcfg_eva);
+
 __attribute__((warn_unused_result))
 static int hb_mc_device_pod_tile_group_init(hb_mc_device_t* device,
                                             hb_mc_pod_t *pod,
@@ -154,9 +172,29 @@ static int hb_mc_device_pod_tile_group_init(hb_mc_device_t* device,
 __attribute__((warn_unused_result))
 static int hb_mc_device_pod_tile_group_exit(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_group_t *tg);
 
+__attribute__((warn_unused_result))
+static int hb_mc_device_pod_dram_files_load(hb_mc_device_t *device, hb_mc_pod_t *pod);
+
+__attribute__((warn_unused_result))
+static int hb_mc_device_pod_dram_files_dump(hb_mc_device_t *device, hb_mc_pod_t *pod);
+
 /////////////////////
 // Program helpers //
 /////////////////////
+/**
+ * Get an EVA for a symbol in a program's binary.
+ * @param[in]  program       Pointer to program
+ * @param[in]  symbol        A program symbol
+ * @param[out] eva           An EVA that addresses #symbol
+ * @return HB_MC_SUCCESS if succesful. HB_MC_NOTFOUND if #symbol is not in the program.
+ */
+static int hb_mc_program_symbol_to_eva(const hb_mc_program_t *program,
+                                       const char *symbol,
+                                       hb_mc_eva_t *eva)
+{
+        return hb_mc_loader_symbol_index_to_eva(program->symbols, symbol, eva);
+}
+
 /**
  * Initializes program's memory allocator and creates a memory manager
  * @param[in]  program       Pointer to program
@@ -184,7 +222,7 @@ static int hb_mc_program_allocator_init (const hb_mc_config_t *cfg,
         program->allocator->id = id;
 
         hb_mc_eva_t program_end_eva;
-        error = hb_mc_loader_symbol_to_eva(program->bin, program->bin_size, "_bsg_dram_end_addr", &program_end_eva);
+        error = hb_mc_program_symbol_to_eva(program, "_bsg_dram_end_addr", &program_end_eva);
         if (error != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to acquire _bsg_dram_end_addr eva from binary file.\n", __func__);
                 return HB_MC_INVALID;
@@ -193,7 +231,7 @@ static int hb_mc_program_allocator_init (const hb_mc_config_t *cfg,
         uint32_t alignment = hb_mc_config_get_vcache_block_size(cfg);
         uint32_t start = program_end_eva + alignment - (program_end_eva % alignment); /* start at the next aligned block */
         size_t dram_size = hb_mc_config_get_dram_size(cfg);
-        program->allocator->memory_manager = (awsbwhal::MemoryManager *) new awsbwhal::MemoryManager(dram_size, start, alignment);
+        BSG_CUDA_CALL(hb_mc_segfit_allocator_init(&program->allocator->memory_manager, start, dram_size, alignment));
 
         return HB_MC_SUCCESS;
 }
@@ -228,13 +266,11 @@ static int hb_mc_program_allocator_exit (hb_mc_allocator_t *allocator) {
 
 
         // Free memory manager
-        const awsbwhal::MemoryManager *memory_manager;
-        memory_manager = (awsbwhal::MemoryManager *) allocator->memory_manager;
-        if (!memory_manager) {
+        if (!allocator->memory_manager) {
                 bsg_pr_err("%s: calling exit on allocator with null memory manager.\n", __func__);
                 return HB_MC_INVALID;
         } else {
-                free ((awsbwhal::MemoryManager *) memory_manager);
+                hb_mc_segfit_allocator_exit(allocator->memory_manager);
                 allocator->memory_manager = NULL;
         }
         free(allocator);
@@ -288,7 +324,7 @@ static int tile_set_symbol_val(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_t
         hb_mc_eva_t symbol_dev;
         int r;
 
-        r = hb_mc_loader_symbol_to_eva(program->bin, program->bin_size, symbol, &symbol_dev);
+        r = hb_mc_program_symbol_to_eva(program, symbol, &symbol_dev);
         if (r != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to find symbol '%s' in program '%s': %s\n",
                            __func__,
@@ -340,32 +376,84 @@ static int tile_unfreeze(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_t
 }
 
 /**
- * Sets the CUDA runtime symbols for a  tile
+ * Get the NPA of a program symbol on a tile
  */
 __attribute__((warn_unused_result))
-static int tile_set_runtime_symbols(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_t *tile, hb_mc_tile_group_t *tg,
-                                    uint32_t    argc, hb_mc_eva_t kernel_addr)
+static int tile_symbol_to_npa(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_t *tile,
+                              const hb_mc_eva_map_t *map,
+                              const char *symbol, hb_mc_npa_t *npa)
 {
-        const hb_mc_eva_map_t *map = tg->map;
-        hb_mc_eva_t argv_addr = tg->argv_eva;
-        hb_mc_npa_t finish_signal_npa = tg->finish_signal_npa;
-
-        BSG_CUDA_CALL(tile_set_symbol_val(device, pod, tile, map, "cuda_argc", argc));
-        BSG_CUDA_CALL(tile_set_symbol_val(device, pod, tile, map, "cuda_argv_ptr", argv_addr));
-
-        hb_mc_eva_t finish_signal_addr;
+        hb_mc_eva_t symbol_dev;
         size_t sz;
-        BSG_CUDA_CALL(hb_mc_npa_to_eva(device->mc, map, &tile->coord, &finish_signal_npa, &finish_signal_addr, &sz));
-        BSG_CUDA_CALL(tile_set_symbol_val(device, pod, tile, map, "cuda_finish_signal_addr", finish_signal_addr));
+        BSG_CUDA_CALL(hb_mc_program_symbol_to_eva(pod->program, symbol, &symbol_dev));
+        BSG_MANYCORE_CALL(device->mc, hb_mc_eva_to_npa(device->mc, map, &tile->coord, &symbol_dev, npa, &sz));
+        return HB_MC_SUCCESS;
+}
 
-        // set the barrier pointer, if found
-        if (tg->barcfg_eva != 0)
-                BSG_CUDA_CALL(tile_set_symbol_val(device, pod, tile, map, "__cuda_barrier_cfg", tg->barcfg_eva));
+/**
+ * Wake up every tile in a tile group by writing the kernel address
+ * to cuda_kernel_ptr. All wake-up stores are sent in one burst.
+ */
+__attribute__((warn_unused_result))
+static int tile_group_wake(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_group_t *tg,
+                           hb_mc_eva_t kernel_addr)
+{
+        hb_mc_npa_t kernel_ptr_npas[hb_mc_dimension_to_length(tg->dim)];
+        size_t n = 0;
 
+        hb_mc_coordinate_t coord;
+        foreach_coordinate(coord, tg->origin, tg->dim)
+        {
+                hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, coord);
+                hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
+                BSG_CUDA_CALL(tile_symbol_to_npa(device, pod, tile, tg->map, "cuda_kernel_ptr", &kernel_ptr_npas[n++]));
+        }
 
         // tiles wake-on-broken reservation on this address
         // this write wakes up the kernel and 'launches' it
-        BSG_CUDA_CALL(tile_set_symbol_val(device, pod, tile, map, "cuda_kernel_ptr", kernel_addr));
+        BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write32_multi(device->mc, kernel_ptr_npas, n, kernel_addr));
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Sets the CUDA runtime symbols for every tile in a tile group.
+ * The stores are posted back-to-back and fenced once; the tiles are
+ * not woken up.
+ */
+__attribute__((warn_unused_result))
+static int tile_group_set_runtime_symbols(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_group_t *tg,
+                                          uint32_t argc)
+{
+        const hb_mc_eva_map_t *map = tg->map;
+        hb_mc_coordinate_t coord;
+        hb_mc_npa_t npa;
+
+        foreach_coordinate(coord, tg->origin, tg->dim)
+        {
+                hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, coord);
+                hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
+
+                BSG_CUDA_CALL(tile_symbol_to_npa(device, pod, tile, map, "cuda_argc", &npa));
+                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write32(device->mc, &npa, argc));
+
+                BSG_CUDA_CALL(tile_symbol_to_npa(device, pod, tile, map, "cuda_argv_ptr", &npa));
+                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write32(device->mc, &npa, tg->argv_eva));
+
+                hb_mc_eva_t finish_signal_addr;
+                size_t sz;
+                BSG_CUDA_CALL(hb_mc_npa_to_eva(device->mc, map, &tile->coord, &tg->finish_signal_npa, &finish_signal_addr, &sz));
+                BSG_CUDA_CALL(tile_symbol_to_npa(device, pod, tile, map, "cuda_finish_signal_addr", &npa));
+                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write32(device->mc, &npa, finish_signal_addr));
+
+                // set the barrier pointer, if found
+                if (tg->barcfg_eva != 0) {
+                        BSG_CUDA_CALL(tile_symbol_to_npa(device, pod, tile, map, "__cuda_barrier_cfg", &npa));
+                        BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write32(device->mc, &npa, tg->barcfg_eva));
+                }
+        }
+
+        BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_host_request_fence(device->mc, -1));
 
         return HB_MC_SUCCESS;
 }
@@ -440,6 +528,105 @@ static int tile_set_config_symbols(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Check if a program uses the launch descriptor ABI
+ * @param[in]  program       Pointer to program
+ * @param[out] desc_eva      EVA of the launch descriptor in each tile's DMEM
+ * @return One if #program defines HB_MC_CUDA_LAUNCH_DESC_SYMBOL. Zero otherwise.
+ */
+static int hb_mc_program_has_launch_desc(const hb_mc_program_t *program, hb_mc_eva_t *desc_eva)
+{
+        return hb_mc_program_symbol_to_eva(program, HB_MC_CUDA_LAUNCH_DESC_SYMBOL, desc_eva) == HB_MC_SUCCESS;
+}
+
+/**
+ * Fill in the configuration fields of a tile's launch descriptor.
+ * These hold the same values tile_set_config_symbols() writes.
+ */
+static void tile_launch_desc_set_config(hb_mc_cuda_launch_desc_t *desc,
+                                        const hb_mc_tile_t *tile,
+                                        hb_mc_coordinate_t origin,
+                                        hb_mc_coordinate_t tg_id,
+                                        hb_mc_dimension_t tg_dim,
+                                        hb_mc_dimension_t grid_dim)
+{
+        hb_mc_coordinate_t coord = hb_mc_coordinate_get_relative (origin, tile->coord);
+
+        desc->grp_org_x       = hb_mc_coordinate_get_x (origin);
+        desc->grp_org_y       = hb_mc_coordinate_get_y (origin);
+        desc->x               = hb_mc_coordinate_get_x (coord);
+        desc->y               = hb_mc_coordinate_get_y (coord);
+        desc->id              = desc->y * hb_mc_dimension_get_x(tg_dim) + desc->x;
+        desc->tile_group_id_x = hb_mc_coordinate_get_x (tg_id);
+        desc->tile_group_id_y = hb_mc_coordinate_get_y (tg_id);
+        desc->tile_group_id   = desc->tile_group_id_y * hb_mc_dimension_get_x(grid_dim) + desc->tile_group_id_x;
+        desc->grid_dim_x      = hb_mc_dimension_get_x (grid_dim);
+        desc->grid_dim_y      = hb_mc_dimension_get_y (grid_dim);
+        desc->finish_signal_val     = HB_MC_CUDA_FINISH_SIGNAL_VAL;
+        desc->kernel_not_loaded_val = HB_MC_CUDA_KERNEL_NOT_LOADED_VAL;
+}
+
+/**
+ * Write a launch descriptor into a tile's DMEM.
+ * The stores are not fenced; the caller must call
+ * hb_mc_manycore_host_request_fence() before waking the tile.
+ */
+__attribute__((warn_unused_result))
+static int tile_write_launch_desc(hb_mc_device_t *device, hb_mc_tile_t *tile,
+                                  const hb_mc_eva_map_t *map,
+                                  hb_mc_eva_t desc_eva,
+                                  const hb_mc_cuda_launch_desc_t *desc)
+{
+        hb_mc_npa_t desc_npa;
+        size_t sz;
+        BSG_MANYCORE_CALL(device->mc, hb_mc_eva_to_npa(device->mc, map, &tile->coord, &desc_eva, &desc_npa, &sz));
+        if (sz < sizeof(*desc)) {
+                bsg_pr_err("%s: '%s' must be at least %zu contiguous bytes\n",
+                           __func__, HB_MC_CUDA_LAUNCH_DESC_SYMBOL, sizeof(*desc));
+                return HB_MC_INVALID;
+        }
+
+        const uint32_t *words = (const uint32_t *)desc;
+        for (size_t i = 0; i < sizeof(*desc) / sizeof(*words); i++) {
+                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write32(device->mc, &desc_npa, words[i]));
+                hb_mc_npa_set_epa(&desc_npa, hb_mc_npa_get_epa(&desc_npa) + sizeof(*words));
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Write the launch descriptor of every tile in a tile group, then fence once.
+ */
+__attribute__((warn_unused_result))
+static int tile_group_set_launch_descs(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_group_t *tg,
+                                       uint32_t argc, hb_mc_eva_t desc_eva)
+{
+        hb_mc_cuda_launch_desc_t desc;
+        hb_mc_coordinate_t coord;
+        foreach_coordinate(coord, tg->origin, tg->dim)
+        {
+                hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, coord);
+                hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
+
+                tile_launch_desc_set_config(&desc, tile, tg->origin, tg->id, tg->dim, tg->grid_dim);
+
+                hb_mc_eva_t finish_signal_addr;
+                size_t sz;
+                BSG_CUDA_CALL(hb_mc_npa_to_eva(device->mc, tg->map, &tile->coord, &tg->finish_signal_npa,
+                                               &finish_signal_addr, &sz));
+                desc.argc               = argc;
+                desc.argv_ptr           = tg->argv_eva;
+                desc.finish_signal_addr = finish_signal_addr;
+                desc.barrier_cfg        = tg->barcfg_eva;
+
+                BSG_CUDA_CALL(tile_write_launch_desc(device, tile, tg->map, desc_eva, &desc));
+        }
+
+        BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_host_request_fence(device->mc, -1));
+        return HB_MC_SUCCESS;
+}
+
 //////////////////
 // Mesh helpers //
 //////////////////
@@ -460,6 +647,122 @@ static int mesh_num_tiles(hb_mc_mesh_t *mesh)
 #define pod_foreach_tile_group(pod, tile_group_ptr)     \
         for (tile_group_ptr = pod->tile_groups; tile_group_ptr != pod->tile_groups+pod->num_tile_groups; tile_group_ptr++)
 
+// marks an origin tile with no launched tile group
+#define POD_NO_TILE_GROUP 0xFFFFFFFF
+
+/**
+ * Get the slot in pod->launched_tile_groups for a tile group origin.
+ * @return HB_MC_SUCCESS if origin is in the pod's mesh. HB_MC_NOTFOUND otherwise.
+ */
+static int pod_origin_to_slot(hb_mc_pod_t *pod, hb_mc_coordinate_t origin, hb_mc_idx_t *slot)
+{
+        // coordinates outside the mesh wrap around to large values
+        hb_mc_coordinate_t rel = hb_mc_coordinate_get_relative(pod->mesh->origin, origin);
+        if (rel.x >= pod->mesh->dim.x || rel.y >= pod->mesh->dim.y)
+                return HB_MC_NOTFOUND;
+
+        *slot = hb_mc_coordinate_to_index(rel, pod->mesh->dim);
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Find the launched tile group with this origin and finish signal address.
+ * Launched tile groups never share tiles, so the origin alone picks the
+ * candidate and the finish signal address confirms it.
+ * @return The matching tile group, or NULL if there is none.
+ */
+static hb_mc_tile_group_t *pod_find_launched_tile_group(hb_mc_pod_t *pod,
+                                                        hb_mc_coordinate_t origin,
+                                                        hb_mc_epa_t finish_signal_epa)
+{
+        hb_mc_idx_t slot;
+        if (pod_origin_to_slot(pod, origin, &slot) != HB_MC_SUCCESS)
+                return NULL;
+
+        uint32_t tg_idx = pod->launched_tile_groups[slot];
+        if (tg_idx == POD_NO_TILE_GROUP)
+                return NULL;
+
+        hb_mc_tile_group_t *tg = &pod->tile_groups[tg_idx];
+        if (hb_mc_npa_get_epa(&tg->finish_signal_npa) != finish_signal_epa)
+                return NULL;
+
+        return tg;
+}
+
+/**
+ * Double the number of tile group slots in a pod.
+ */
+__attribute__((warn_unused_result))
+static int pod_tile_groups_grow(hb_mc_pod_t *pod)
+{
+        uint32_t cap = pod->tile_group_capacity;
+        uint32_t new_cap = cap * 2;
+
+        XREALLOC(pod->tile_groups, new_cap);
+        XREALLOC(pod->free_tile_groups, new_cap);
+
+        // unwrap the pending ring into the larger buffer
+        uint32_t *pending;
+        XMALLOC_N(pending, new_cap);
+        for (uint32_t i = 0; i < pod->num_tile_groups_pending; i++)
+                pending[i] = pod->pending_tile_groups[(pod->pending_head + i) % cap];
+
+        free(pod->pending_tile_groups);
+        pod->pending_tile_groups = pending;
+        pod->pending_head = 0;
+        pod->tile_group_capacity = new_cap;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Get an unused tile group slot, reusing a finished one if possible.
+ */
+__attribute__((warn_unused_result))
+static int pod_tile_group_slot_acquire(hb_mc_pod_t *pod, uint32_t *slot)
+{
+        if (pod->num_free_tile_groups > 0) {
+                *slot = pod->free_tile_groups[--pod->num_free_tile_groups];
+                return HB_MC_SUCCESS;
+        }
+
+        if (pod->num_tile_groups == pod->tile_group_capacity)
+                BSG_CUDA_CALL(pod_tile_groups_grow(pod));
+
+        *slot = pod->num_tile_groups++;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Return the slot of a finished tile group for reuse.
+ */
+static void pod_tile_group_slot_release(hb_mc_pod_t *pod, hb_mc_tile_group_t *tg)
+{
+        pod->free_tile_groups[pod->num_free_tile_groups++] = tg - pod->tile_groups;
+}
+
+/**
+ * Add a slot to the back of the pending ring.
+ * The ring never overflows: it holds at most one entry per slot.
+ */
+static void pod_pending_push(hb_mc_pod_t *pod, uint32_t slot)
+{
+        uint32_t tail = (pod->pending_head + pod->num_tile_groups_pending) % pod->tile_group_capacity;
+        pod->pending_tile_groups[tail] = slot;
+        pod->num_tile_groups_pending++;
+}
+
+/**
+ * Remove a slot from the front of the pending ring.
+ */
+static uint32_t pod_pending_pop(hb_mc_pod_t *pod)
+{
+        uint32_t slot = pod->pending_tile_groups[pod->pending_head];
+        pod->pending_head = (pod->pending_head + 1) % pod->tile_group_capacity;
+        pod->num_tile_groups_pending--;
+        return slot;
+}
+
 ///////////////////////
 // Iteration helpers //
 ///////////////////////
@@ -508,8 +811,27 @@ static int hb_mc_device_pod_init(hb_mc_device_t *device,
         pod->tile_groups         = NULL;
         pod->num_tile_groups     = 0;
         pod->tile_group_capacity = 0;
+        pod->free_tile_groups    = NULL;
+        pod->num_free_tile_groups = 0;
+        pod->pending_tile_groups = NULL;
+        pod->pending_head        = 0;
+        pod->num_tile_groups_pending  = 0;
+        pod->num_tile_groups_launched = 0;
+        pod->num_tile_groups_finished = 0;
+        pod->launched_tile_groups = NULL;
         pod->num_grids           = 0;
+        pod->streams             = NULL;
+        pod->persistent          = NULL;
+        pod->barcfgs             = NULL;
+        pod->uses_hw_barrier     = -1;
         pod->program_loaded      = 0;
+        pod->dma_stats           = {0};
+
+        // a sweep sends one packet per way and set of every vcache in the pod
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(device->mc);
+        pod->dma_stats.sweep_threshold = hb_mc_config_get_vcache_ways(cfg)
+                * hb_mc_config_get_vcache_sets(cfg)
+                * hb_mc_config_get_dimension_vcore(cfg).x * 2;
         return HB_MC_SUCCESS;
 }
 
@@ -522,6 +844,44 @@ static int hb_mc_device_pod_exit(hb_mc_device_t *device,
         return HB_MC_SUCCESS;
 }
 
+// DRAM files for the next hb_mc_device_init(), see hb_mc_device_init_dram_files()
+static std::string init_dram_load, init_dram_dump;
+
+/**
+ * Make the next hb_mc_device_init() in this process set the DRAM files of its device.
+ * @param[in]  load    Comma-separated EVA:FILE entries, or NULL
+ * @param[in]  dump    Comma-separated EVA:SIZE:FILE entries, or NULL
+ */
+void hb_mc_device_init_dram_files(const char *load, const char *dump)
+{
+        init_dram_load = load ? load : "";
+        init_dram_dump = dump ? dump : "";
+}
+
+/**
+ * Set the DRAM files that each pod loads with its program and dumps when it finishes.
+ * @param[in]  device  Pointer to device
+ * @param[in]  load    Comma-separated EVA:FILE entries, or NULL
+ * @param[in]  dump    Comma-separated EVA:SIZE:FILE entries, or NULL
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_set_dram_files(hb_mc_device_t *device, const char *load, const char *dump)
+{
+        CHECK_PTR(device);
+
+        free(device->dram_load);
+        free(device->dram_dump);
+        device->dram_load = NULL;
+        device->dram_dump = NULL;
+
+        if (load != NULL && *load != '\0')
+                XSTRDUP(device->dram_load, load);
+        if (dump != NULL && *dump != '\0')
+                XSTRDUP(device->dram_dump, dump);
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Initializes the manycore struct, and a mesh structure with default (maximum)
  * dimensions inside device struct with list of tiles and their coordinates
@@ -565,6 +925,14 @@ int hb_mc_device_init (hb_mc_device_t *device,
         // set name
         XSTRDUP(device->name, name);
 
+        // take the DRAM files meant for this init
+        std::string load, dump;
+        load.swap(init_dram_load);
+        dump.swap(init_dram_dump);
+        device->dram_load = NULL;
+        device->dram_dump = NULL;
+        BSG_CUDA_CALL(hb_mc_device_set_dram_files(device, load.c_str(), dump.c_str()));
+
         return HB_MC_SUCCESS;
 }
 
@@ -636,6 +1004,8 @@ int hb_mc_device_finish (hb_mc_device_t *device)
         free(device->mc);
         free(device->pods);
         free(const_cast<char*>(device->name));
+        free(device->dram_load);
+        free(device->dram_dump);
 
         return HB_MC_SUCCESS;
 }
@@ -735,6 +1105,9 @@ int hb_mc_device_pod_mesh_init(hb_mc_device_t *device,
 
         }
 
+        // initialize the free-rectangle allocator
+        BSG_CUDA_CALL(hb_mc_tile_allocator_init(&mesh->tile_allocator, mesh->dim));
+
         pod->mesh = mesh;
 
         return HB_MC_SUCCESS;
@@ -763,6 +1136,20 @@ int hb_mc_device_pod_tile_groups_init(hb_mc_device_t *device,
         pod->tile_group_capacity = capacity;
         pod->num_tile_groups = 0;
 
+        // no slots are free or pending yet
+        XMALLOC_N(pod->free_tile_groups, capacity);
+        XMALLOC_N(pod->pending_tile_groups, capacity);
+        pod->num_free_tile_groups = 0;
+        pod->pending_head = 0;
+        pod->num_tile_groups_pending = 0;
+        pod->num_tile_groups_launched = 0;
+        pod->num_tile_groups_finished = 0;
+
+        // no tile group is launched at any origin
+        XMALLOC_N(pod->launched_tile_groups, mesh_num_tiles(pod->mesh));
+        for (int i = 0; i < mesh_num_tiles(pod->mesh); i++)
+                pod->launched_tile_groups[i] = POD_NO_TILE_GROUP;
+
         return HB_MC_SUCCESS;
 
 }
@@ -796,12 +1183,13 @@ int hb_mc_device_pod_program_load (hb_mc_device_t *device, hb_mc_pod_t *pod)
 
 
         // Load binary into all tiles
-        r = hb_mc_loader_load (pod->program->bin,
-                               pod->program->bin_size,
-                               device->mc,
-                               &default_map,
-                               tile_list,
-                               mesh_num_tiles(pod->mesh));
+        r = hb_mc_loader_load_indexed (pod->program->bin,
+                                       pod->program->bin_size,
+                                       pod->program->symbols,
+                                       device->mc,
+                                       &default_map,
+                                       tile_list,
+                                       mesh_num_tiles(pod->mesh));
         if (r != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to load program '%s': %s\n",
                            __func__,
@@ -814,16 +1202,44 @@ int hb_mc_device_pod_program_load (hb_mc_device_t *device, hb_mc_pod_t *pod)
         hb_mc_coordinate_t tg_id = hb_mc_coordinate (0, 0);
         hb_mc_coordinate_t tg_dim = hb_mc_coordinate (1, 1);
         hb_mc_coordinate_t grid_dim = hb_mc_coordinate (1, 1);
-        mesh_foreach_tile(pod->mesh, tile)
-        {
-                BSG_CUDA_CALL(tile_set_config_symbols(device, pod, tile,
-                                                      &default_map,
-                                                      pod->mesh->origin,
-                                                      tg_id,
-                                                      tg_dim,
-                                                      grid_dim));
+        hb_mc_eva_t desc_eva;
+        if (hb_mc_program_has_launch_desc(pod->program, &desc_eva)) {
+                hb_mc_cuda_launch_desc_t desc = {};
+                mesh_foreach_tile(pod->mesh, tile)
+                {
+                        BSG_MANYCORE_CALL(device->mc, hb_mc_tile_set_origin_registers(device->mc, &tile->coord,
+                                                                                     &pod->mesh->origin));
+                        tile_launch_desc_set_config(&desc, tile, pod->mesh->origin, tg_id, tg_dim, grid_dim);
+                        BSG_CUDA_CALL(tile_write_launch_desc(device, tile, &default_map, desc_eva, &desc));
+                }
+                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_host_request_fence(device->mc, -1));
+
+                mesh_foreach_tile(pod->mesh, tile)
+                {
+                        BSG_CUDA_CALL(tile_unfreeze(device, pod, tile));
+                }
+        } else {
+                // post every tile's symbols, fence once, then wake the tiles
+                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write_begin(device->mc));
+                mesh_foreach_tile(pod->mesh, tile)
+                {
+                        r = tile_set_config_symbols(device, pod, tile,
+                                                    &default_map,
+                                                    pod->mesh->origin,
+                                                    tg_id,
+                                                    tg_dim,
+                                                    grid_dim);
+                        if (r != HB_MC_SUCCESS)
+                                break;
+                }
+                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write_commit(device->mc));
+                if (r != HB_MC_SUCCESS)
+                        return r;
 
-                BSG_CUDA_CALL(tile_unfreeze(device, pod, tile));
+                mesh_foreach_tile(pod->mesh, tile)
+                {
+                        BSG_CUDA_CALL(tile_unfreeze(device, pod, tile));
+                }
         }
 
         return HB_MC_SUCCESS;
@@ -945,6 +1361,9 @@ int hb_mc_device_pod_program_init_binary_opts(hb_mc_device_t       *device,
                 program->bin_size = bin_size;
         }
 
+        // index program symbols
+        BSG_CUDA_CALL(hb_mc_loader_symbol_index_init(program->bin, program->bin_size, &program->symbols));
+
         // initialize memory allocator
         const hb_mc_config_t *cfg = hb_mc_manycore_get_config(device->mc);
         BSG_CUDA_CALL(hb_mc_program_allocator_init (cfg, program, popts->alloc_name, popts->alloc_id));
@@ -957,6 +1376,9 @@ int hb_mc_device_pod_program_init_binary_opts(hb_mc_device_t       *device,
 
         pod->program_loaded = 1;
 
+        // load the device's DRAM files now, so they are in place even if no kernel launches
+        BSG_CUDA_CALL(hb_mc_device_pod_dram_files_load(device, pod));
+
         return HB_MC_SUCCESS;
 }
 
@@ -983,6 +1405,9 @@ int hb_mc_device_pod_mesh_exit(hb_mc_device_t *device,
         free ((void *) tiles);
         mesh->tiles = NULL;
 
+        // free tile allocator
+        hb_mc_tile_allocator_exit(&mesh->tile_allocator);
+
         // free mesh
         free(mesh);
         pod->mesh = NULL;
@@ -1012,9 +1437,28 @@ int hb_mc_device_pod_tile_groups_exit(hb_mc_device_t *device,
         pod->tile_group_capacity = 0;
         pod->num_tile_groups = 0;
 
+        free(pod->free_tile_groups);
+        pod->free_tile_groups = NULL;
+        pod->num_free_tile_groups = 0;
+
+        free(pod->pending_tile_groups);
+        pod->pending_tile_groups = NULL;
+        pod->pending_head = 0;
+        pod->num_tile_groups_pending = 0;
+        pod->num_tile_groups_launched = 0;
+        pod->num_tile_groups_finished = 0;
+
+        free(pod->launched_tile_groups);
+        pod->launched_tile_groups = NULL;
+
         return HB_MC_SUCCESS;
 }
 
+// forward declarations
+static void hb_mc_device_pod_streams_exit(hb_mc_device_t *device, hb_mc_pod_t *pod);
+static void hb_mc_device_pod_persistent_exit(hb_mc_device_t *device, hb_mc_pod_t *pod);
+static void hb_mc_device_pod_barcfgs_exit(hb_mc_device_t *device, hb_mc_pod_t *pod);
+
 /**
  * Performs cleanup for a program loaded onto pod with
  * hb_mc_device_pod_program_init().
@@ -1050,18 +1494,34 @@ int hb_mc_device_pod_program_finish(hb_mc_device_t *device,
         // perform a fence on outstanding host requests
         BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_host_request_fence(device->mc, -1));
 
+        // dump the device's DRAM ranges while the program's memory is still allocated
+        BSG_CUDA_CALL(hb_mc_device_pod_dram_files_dump(device, pod));
+
         // free resources allocated for program
         hb_mc_program_t *program = pod->program;
 
         // cleanup tile groups
         BSG_CUDA_CALL(hb_mc_device_pod_tile_groups_exit(device, pod));
 
+        // release streams the user did not destroy
+        hb_mc_device_pod_streams_exit(device, pod);
+
+        // release a dispatcher the user did not stop
+        hb_mc_device_pod_persistent_exit(device, pod);
+
+        // free pooled barrier config buffers
+        hb_mc_device_pod_barcfgs_exit(device, pod);
+
         // cleanup mesh
         BSG_CUDA_CALL(hb_mc_device_pod_mesh_exit(device, pod));
 
         // free allocator
         BSG_CUDA_CALL(hb_mc_program_allocator_exit(program->allocator));
 
+        // free symbol index
+        hb_mc_loader_symbol_index_exit(program->symbols);
+        program->symbols = NULL;
+
         // free bin data
         free(const_cast<unsigned char*>(program->bin));
         program->bin = NULL;
@@ -1109,15 +1569,14 @@ int hb_mc_device_pod_malloc(hb_mc_device_t *device,
                 return HB_MC_INVALID;
         }
 
-        awsbwhal::MemoryManager *mem_manager = reinterpret_cast<awsbwhal::MemoryManager*>(program->allocator->memory_manager);
-        hb_mc_eva_t result = mem_manager->alloc(size);
-        if (result == awsbwhal::MemoryManager::mNull) {
+        uint64_t result;
+        if (hb_mc_segfit_allocator_alloc(program->allocator->memory_manager, size, &result) != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to allocate %" PRIu32 " bytes\n",
                            __func__, size);
                 return HB_MC_NOMEM;
         }
 
-        *eva = result;
+        *eva = static_cast<hb_mc_eva_t>(result);
         return HB_MC_SUCCESS;
 }
 
@@ -1146,8 +1605,108 @@ int hb_mc_device_pod_free(hb_mc_device_t *device,
                 return HB_MC_INVALID;
         }
 
-        awsbwhal::MemoryManager *mem_manager = reinterpret_cast<awsbwhal::MemoryManager*>(program->allocator->memory_manager);
-        mem_manager->free(eva);
+        return hb_mc_segfit_allocator_free(program->allocator->memory_manager, eva);
+}
+
+/**
+ * Resizes memory on device's DRAM associated with the input pod
+ * The block grows or shrinks in place when it can. Otherwise a new
+ * block is allocated, the contents are copied and the old block is freed.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod ID with a prorgam initialized
+ * @param[in]  eva           Eva address of memory returned by hb_mc_device_pod_malloc()
+ * @param[in]  size          New size of the memory
+ * @param[out] new_eva       Eva address of the resized memory
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_realloc(hb_mc_device_t *device,
+                             hb_mc_pod_id_t  pod_id,
+                             hb_mc_eva_t     eva,
+                             uint32_t        size,
+                             hb_mc_eva_t    *new_eva)
+{
+        CHECK_POD_ID(device, pod_id);
+        CHECK_PTR(new_eva);
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+        hb_mc_program_t *program = pod->program;
+        // check pod has program loaded
+        if (program == NULL) {
+                bsg_pr_err("%s: no program load on pod %d: %s\n",
+                           __func__,
+                           pod_id,
+                           hb_mc_strerror(HB_MC_INVALID));
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_segfit_allocator_t *mm = program->allocator->memory_manager;
+        uint64_t old_size;
+        if (hb_mc_segfit_allocator_lookup(mm, eva, &old_size) != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: 0x%08" PRIx32 " was not allocated on pod %d\n",
+                           __func__, eva, pod_id);
+                return HB_MC_INVALID;
+        }
+
+        // try in place first
+        int err = hb_mc_segfit_allocator_resize(mm, eva, size);
+        if (err == HB_MC_SUCCESS) {
+                *new_eva = eva;
+                return HB_MC_SUCCESS;
+        } else if (err != HB_MC_NOMEM) {
+                return err;
+        }
+
+        // move: the old block stays allocated until its contents are copied
+        hb_mc_eva_t moved;
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod_id, size, &moved));
+
+        size_t bytes = old_size < size ? old_size : size;
+        unsigned char *buffer = reinterpret_cast<unsigned char *>(malloc(bytes));
+        if (buffer == NULL) {
+                err = HB_MC_NOMEM;
+        } else {
+                err = hb_mc_device_pod_memcpy_to_host(device, pod_id, buffer, eva, bytes);
+                if (err == HB_MC_SUCCESS)
+                        err = hb_mc_device_pod_memcpy_to_device(device, pod_id, moved, buffer, bytes);
+                free(buffer);
+        }
+
+        // on failure the old block is left as it was
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to move 0x%08" PRIx32 " on pod %d: %s\n",
+                           __func__, eva, pod_id, hb_mc_strerror(err));
+                BSG_CUDA_CALL(hb_mc_device_pod_free(device, pod_id, moved));
+                return err;
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_pod_free(device, pod_id, eva));
+        *new_eva = moved;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Gets statistics of the DRAM allocator of the input pod
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod ID with a prorgam initialized
+ * @param[out] stats         Allocator statistics
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_malloc_stats(hb_mc_device_t *device,
+                                  hb_mc_pod_id_t  pod_id,
+                                  hb_mc_segfit_stats_t *stats)
+{
+        CHECK_POD_ID(device, pod_id);
+        CHECK_PTR(stats);
+        hb_mc_program_t *program = device->pods[pod_id].program;
+        // check pod has program loaded
+        if (program == NULL) {
+                bsg_pr_err("%s: no program load on pod %d: %s\n",
+                           __func__,
+                           pod_id,
+                           hb_mc_strerror(HB_MC_INVALID));
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_segfit_allocator_get_stats(program->allocator->memory_manager, stats);
         return HB_MC_SUCCESS;
 }
 
@@ -1276,6 +1835,27 @@ int hb_mc_device_pod_memset (hb_mc_device_t *device,
 /***********************************/
 /* Pod Interface Execution Control */
 /***********************************/
+/**
+ * Release a kernel once no tile group holds a reference to it.
+ * Frees its device argv and signals anyone waiting on it.
+ */
+__attribute__((warn_unused_result))
+static int kernel_release(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_kernel_t *kernel)
+{
+        if (kernel->argv_eva != 0) {
+                hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
+                BSG_CUDA_CALL(hb_mc_device_pod_free(device, pod_id, kernel->argv_eva));
+                kernel->argv_eva = 0;
+        }
+
+        if (kernel->finished)
+                *kernel->finished = 1;
+
+        BSG_CUDA_CALL(kernel_exit(kernel));
+        free(kernel);
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Initialize a tile group
  */
@@ -1294,6 +1874,8 @@ static int hb_mc_device_pod_tile_group_init(hb_mc_device_t* device,
         tg->grid_id = grid_id;
         tg->grid_dim = grid_dim;
         tg->status = HB_MC_TILE_GROUP_STATUS_INITIALIZED;
+        tg->argv_eva = 0;
+        tg->barcfg_eva = 0;
 
         hb_mc_coordinate_t host = hb_mc_manycore_get_host_coordinate(device->mc);
         tg->finish_signal_npa = hb_mc_npa(host, hb_mc_tile_group_get_finish_signal_addr(tg));
@@ -1313,11 +1895,13 @@ static int hb_mc_device_pod_tile_group_init(hb_mc_device_t* device,
 static int hb_mc_device_pod_tile_group_exit(hb_mc_device_t *device, hb_mc_pod_t *pod, hb_mc_tile_group_t *tg)
 {
 
-        // Free the memory location in the device that holds the list of
-        // arguments of tile group's kernel
-        hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
-        BSG_CUDA_CALL(hb_mc_device_pod_free(device, pod_id, tg->argv_eva));
-        BSG_CUDA_CALL(hb_mc_device_pod_free(device, pod_id, tg->barcfg_eva));
+        // argv belongs to the kernel and is freed with it
+        // return the barrier config buffer to its pool
+        // Tile groups that never launched hold neither
+        if (tg->barcfg_eva != 0)
+                BSG_CUDA_CALL(hb_mc_device_pod_barcfg_release(device, pod, tg->dim, tg->barcfg_eva));
+        tg->argv_eva = 0;
+        tg->barcfg_eva = 0;
 
         // release tile gorup resources
         tg->dim = HB_MC_DIMENSION(0,0);
@@ -1333,7 +1917,7 @@ static int hb_mc_device_pod_tile_group_exit(hb_mc_device_t *device, hb_mc_pod_t
         // decrement the kernel reference count and free if needed
         tg->kernel->refcount -= 1;
         if (tg->kernel->refcount == 0)
-                BSG_CUDA_CALL(kernel_exit(tg->kernel));
+                BSG_CUDA_CALL(kernel_release(device, pod, tg->kernel));
 
         tg->kernel = NULL;
         return HB_MC_SUCCESS;
@@ -1351,21 +1935,17 @@ static int hb_mc_device_pod_tile_group_kernel_enqueue (hb_mc_device_t* device,
                                                        hb_mc_dimension_t dim,
                                                        hb_mc_kernel_t *kernel)
 {
-        // increaase tile group capacity if necessary
-        int cap = pod->tile_group_capacity;
-        int num = pod->num_tile_groups;
-        if (cap == num) {
-                XREALLOC(pod->tile_groups, cap * 2);
-                pod->tile_group_capacity *= 2;
-        }
+        // reuse a finished slot or grow the slot array
+        uint32_t slot;
+        BSG_CUDA_CALL(pod_tile_group_slot_acquire(pod, &slot));
 
         // initialize tile group
-        hb_mc_tile_group_t* tg = &pod->tile_groups[pod->num_tile_groups];
+        hb_mc_tile_group_t* tg = &pod->tile_groups[slot];
         BSG_CUDA_CALL(hb_mc_device_pod_tile_group_init(device, pod, tg,
                                                        grid_id, tg_id, grid_dim, dim, kernel));
 
-        // incremement the number of tile groups
-        pod->num_tile_groups += 1;
+        // queue it for launch
+        pod_pending_push(pod, slot);
 
         bsg_pr_dbg("%s: Grid %d: %dx%d tile group (%d,%d) initialized.\n",
                    __func__,
@@ -1376,6 +1956,32 @@ static int hb_mc_device_pod_tile_group_kernel_enqueue (hb_mc_device_t* device,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Enqueue every tile group of a grid running kernel.
+ * The tile groups take ownership of the kernel.
+ */
+__attribute__((warn_unused_result))
+static int hb_mc_device_pod_grid_enqueue(hb_mc_device_t *device,
+                                         hb_mc_pod_t *pod,
+                                         hb_mc_dimension_t grid_dim,
+                                         hb_mc_dimension_t tg_dim,
+                                         hb_mc_kernel_t *kernel)
+{
+        // add all tile groups
+        hb_mc_coordinate_t tg_id;
+        foreach_coordinate(tg_id, HB_MC_COORDINATE(0,0), grid_dim)
+        {
+                BSG_CUDA_CALL(hb_mc_device_pod_tile_group_kernel_enqueue(device, pod, pod->num_grids, tg_id, grid_dim, tg_dim, kernel));
+        }
+
+        // an empty grid holds no reference to its kernel
+        if (kernel->refcount == 0)
+                BSG_CUDA_CALL(kernel_release(device, pod, kernel));
+
+        pod->num_grids++;
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Enqueues and schedules a kernel to be run on a pod
  * Takes the grid size, tile group dimensions, kernel name, argc,
@@ -1417,15 +2023,7 @@ int hb_mc_device_pod_kernel_enqueue(hb_mc_device_t    *device,
         XMALLOC(kernel);
         BSG_CUDA_CALL(kernel_init(kernel, name, argc, argv));
 
-        // add all tile groups
-        hb_mc_coordinate_t tg_id;
-        foreach_coordinate(tg_id, HB_MC_COORDINATE(0,0), grid_dim)
-        {
-                BSG_CUDA_CALL(hb_mc_device_pod_tile_group_kernel_enqueue(device, pod, pod->num_grids, tg_id, grid_dim, tg_dim, kernel));
-        }
-
-        pod->num_grids++;
-        return HB_MC_SUCCESS;
+        return hb_mc_device_pod_grid_enqueue(device, pod, grid_dim, tg_dim, kernel);
 }
 
 /**
@@ -1434,12 +2032,10 @@ int hb_mc_device_pod_kernel_enqueue(hb_mc_device_t    *device,
 static
 int hb_mc_device_pod_all_tile_groups_finished(hb_mc_device_t *device, hb_mc_pod_t *pod)
 {
-        hb_mc_tile_group_t *tile_group;
-        pod_foreach_tile_group(pod, tile_group)
-        {
-                if (tile_group->status != HB_MC_TILE_GROUP_STATUS_FINISHED)
-                        return HB_MC_FAIL;
-        }
+        if (pod->num_tile_groups_pending != 0 ||
+            pod->num_tile_groups_launched != 0)
+                return HB_MC_FAIL;
+
         return HB_MC_SUCCESS;
 }
 
@@ -1455,81 +2051,61 @@ int hb_mc_device_pod_tile_group_allocate_tiles(hb_mc_device_t *device, hb_mc_pod
         bsg_pr_dbg("%s: device<%s>: program<%s>: calling\n",
                    __func__, device->name, pod->program->bin_name);
 
-        // calculate boundary condition
-        hb_mc_dimension_t origin_boundary;
-        BSG_CUDA_CALL(hb_mc_coordinate_sub_safe(pod->mesh->dim, tile_group->dim, &origin_boundary));
-        origin_boundary = hb_mc_coordinate_add(origin_boundary, hb_mc_dimension(1,1));
+        // find a free group of tiles
+        hb_mc_coordinate_t relative_origin;
+        int r = hb_mc_tile_allocator_alloc(&pod->mesh->tile_allocator, tile_group->dim, &relative_origin);
+        if (r != HB_MC_SUCCESS)
+                return r;
 
-        // scan for contiguous group of free tile groups
-        hb_mc_coordinate_t origin;
-        int tiles_are_free = 0;
+        // these tiles are free; set the origin as the tile groups origin
+        tile_group->origin = hb_mc_coordinate_add(pod->mesh->origin, relative_origin);
 
 #if defined (DEBUG)
         char origin_str[256];
-        char boundary_str[256];
 #endif
+        bsg_pr_dbg("%s: allocated tiles at %s\n",
+                   __func__, hb_mc_coordinate_to_string(tile_group->origin, origin_str, sizeof(origin_str)));
 
-        bsg_pr_dbg("%s: scanning orig:%s  dim:%s\n",
-                   __func__,
-                   hb_mc_coordinate_to_string(pod->mesh->origin, origin_str, sizeof(origin_str)),
-                   hb_mc_coordinate_to_string(origin_boundary, boundary_str, sizeof(boundary_str)));
-
-        foreach_coordinate(origin, pod->mesh->origin, origin_boundary)
-        {
-                // check if this group of tiles is free
-                // this group is free if the group of tiles about the origin matching
-                // the required tile group size are all free
-                tiles_are_free = 1;
-                hb_mc_coordinate_t xy;
-                foreach_coordinate(xy, origin, tile_group->dim)
-                {
-                        hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, xy);
-                        if (pod->mesh->tiles[tile_id].status != HB_MC_TILE_STATUS_FREE) {
-                                tiles_are_free = 0;
-                                break;
-                        }
-                }
-
-
-                bsg_pr_dbg("%s: %s %s\n",
-                           __func__,
-                           hb_mc_coordinate_to_string(origin, origin_str, sizeof(origin_str)),
-                           tiles_are_free ? "free" : "not free");
+        // initialize eva map to support tile group addressing
+        BSG_CUDA_CALL(hb_mc_origin_eva_map_exit(tile_group->map));
+        BSG_CUDA_CALL(hb_mc_origin_eva_map_init(tile_group->map, tile_group->origin));
 
-                if (!tiles_are_free)
-                        continue;
+        hb_mc_eva_t desc_eva;
+        int use_launch_desc = hb_mc_program_has_launch_desc(pod->program, &desc_eva);
 
-                // these tiles are free; set the origin as the tile groups origin
-                tile_group->origin = origin;
+        // initialize free group of tiles
+        // post every tile's writes and fence once for the whole group
+        BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write_begin(device->mc));
+        hb_mc_coordinate_t xy;
+        foreach_coordinate(xy, tile_group->origin, tile_group->dim)
+        {
+                hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, xy);
 
-                // initialize free group of tiles
-                foreach_coordinate(xy, tile_group->origin, tile_group->dim)
-                {
-                        hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, xy);
-
-                        // initialize eva map to support tile group addressing
-                        BSG_CUDA_CALL(hb_mc_origin_eva_map_exit(tile_group->map));
-                        BSG_CUDA_CALL(hb_mc_origin_eva_map_init(tile_group->map, origin));
-
-                        // set bookkeeping fields
-                        hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
-                        tile->origin = origin;
-                        tile->tile_group_id = tile_group->id;
-                        tile->status = HB_MC_TILE_STATUS_BUSY;
-
-                        // set configuration symbols
-                        BSG_CUDA_CALL(tile_set_config_symbols(device, pod, tile,
-                                                              tile_group->map,
-                                                              tile_group->origin,
-                                                              tile_group->id,
-                                                              tile_group->dim,
-                                                              tile_group->grid_dim));
+                // set bookkeeping fields
+                hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
+                tile->origin = tile_group->origin;
+                tile->tile_group_id = tile_group->id;
+                tile->status = HB_MC_TILE_STATUS_BUSY;
+
+                // set configuration symbols
+                // with a launch descriptor they are sent at launch instead
+                if (use_launch_desc) {
+                        r = hb_mc_tile_set_origin_registers(device->mc, &tile->coord,
+                                                            &tile_group->origin);
+                } else {
+                        r = tile_set_config_symbols(device, pod, tile,
+                                                    tile_group->map,
+                                                    tile_group->origin,
+                                                    tile_group->id,
+                                                    tile_group->dim,
+                                                    tile_group->grid_dim);
                 }
-                break; // done
+                if (r != HB_MC_SUCCESS)
+                        break;
         }
-
-        if (!tiles_are_free)
-                return HB_MC_NOTFOUND;
+        BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_write_commit(device->mc));
+        if (r != HB_MC_SUCCESS)
+                return r;
 
         tile_group->status = HB_MC_TILE_GROUP_STATUS_ALLOCATED;
         return HB_MC_SUCCESS;
@@ -1556,6 +2132,10 @@ int hb_mc_device_pod_tile_group_deallocate_tiles(hb_mc_device_t *device, hb_mc_p
                 tile->status = HB_MC_TILE_STATUS_FREE;
         }
 
+        BSG_CUDA_CALL(hb_mc_tile_allocator_free(&pod->mesh->tile_allocator,
+                                                hb_mc_coordinate_get_relative(pod->mesh->origin, tg->origin),
+                                                tg->dim));
+
         bsg_pr_dbg("%s: Grid %d: %dx%d tile group (%d,%d) de-allocated at origin (%d,%d).\n",
                    __func__,
                    tg->grid_id,
@@ -1567,10 +2147,62 @@ int hb_mc_device_pod_tile_group_deallocate_tiles(hb_mc_device_t *device, hb_mc_p
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Pooled hw barrier config buffers for one tile group shape.
+ * A buffer holds the amoadd lock word followed by one CSR value per tile.
+ * The lock is live while a tile group runs, so buffers are not shared
+ * between running tile groups; a finished group returns its buffer here.
+ */
+struct hb_mc_barcfg {
+        hb_mc_dimension_t dim;
+        hb_mc_dimension_t ruche_factor;
+        std::vector<int> csr;           // CSR values, computed once for this shape
+        std::vector<hb_mc_eva_t> free;  // initialized buffers not held by a tile group
+        uint32_t refcount;              // buffers held by tile groups
+        hb_mc_barcfg_t *next;           // next shape on the same pod
+};
+
+/**
+ * Find the barrier config pool for a tile group shape, creating it if needed.
+ */
+static hb_mc_barcfg_t *hb_mc_device_pod_barcfg_lookup(hb_mc_device_t *device,
+                                                      hb_mc_pod_t *pod,
+                                                      hb_mc_dimension_t dim)
+{
+        hb_mc_dimension_t ruche_factor = device->mc->config.bar_ruche_factor;
+        hb_mc_barcfg_t *barcfg;
+        for (barcfg = pod->barcfgs; barcfg != NULL; barcfg = barcfg->next) {
+                if (barcfg->dim.x == dim.x && barcfg->dim.y == dim.y &&
+                    barcfg->ruche_factor.x == ruche_factor.x &&
+                    barcfg->ruche_factor.y == ruche_factor.y)
+                        return barcfg;
+        }
+
+        barcfg = new hb_mc_barcfg_t;
+        barcfg->dim = dim;
+        barcfg->ruche_factor = ruche_factor;
+        barcfg->refcount = 0;
+
+        // word zero holds the amoadd barrier lock
+        barcfg->csr.resize(1 + dim.x * dim.y);
+        barcfg->csr[0] = 0;
+        hb_mc_coordinate_t cord, og = hb_mc_coordinate(0,0);
+        foreach_coordinate(cord, og, dim) {
+                int id = cord.y * dim.x + cord.x;
+                barcfg->csr[1+id] = hb_mc_hw_barrier_csr_val(&device->mc->config, cord.x, cord.y, dim.x, dim.y);
+        }
+
+        barcfg->next = pod->barcfgs;
+        pod->barcfgs = barcfg;
+        return barcfg;
+}
+
 /**
  * Initialize the array of CSR values for the hw barrier.
- * This function checks if the barrier is used in the kernel, and if so an array is allocated
- * and initialized.
+ * This function checks if the barrier is used in the kernel, and if so a
+ * buffer is taken from the pool for the tile group's shape.
+ * Only a newly allocated buffer needs the full array copied; a recycled
+ * one just has its lock word cleared.
  */
 static int hb_mc_device_pod_tile_group_barrier_init(hb_mc_device_t *device
                                                     , hb_mc_pod_t *pod
@@ -1584,48 +2216,88 @@ static int hb_mc_device_pod_tile_group_barrier_init(hb_mc_device_t *device
                    , kernel->name);
 
         // check that the barrier is used
-        // to do this, look for a symbol "__cuda_barrier_cfg"
-        int err;
-        hb_mc_eva_t barr_config_ptr;
-        err = hb_mc_loader_symbol_to_eva(pod->program->bin
-                                         , pod->program->bin_size
-                                         , "__cuda_barrier_cfg"
-                                         , &barr_config_ptr);
+        // to do this, look for a symbol "__cuda_barrier_cfg" once per program
+        if (pod->uses_hw_barrier < 0) {
+                hb_mc_eva_t barr_config_ptr;
+                int err = hb_mc_program_symbol_to_eva(pod->program
+                                                      , "__cuda_barrier_cfg"
+                                                      , &barr_config_ptr);
+                pod->uses_hw_barrier = (err == HB_MC_NOTFOUND) ? 0 : 1;
+        }
 
         // if not found, no barrier initialization
-        if (err == HB_MC_NOTFOUND) {
+        if (!pod->uses_hw_barrier) {
                 tg->barcfg_eva = 0;
                 return HB_MC_SUCCESS;
         }
 
-        // found the barrier pointer
-        // allocate an array for csr values
-        hb_mc_eva_t barcfg_eva;
+        hb_mc_barcfg_t *barcfg = hb_mc_device_pod_barcfg_lookup(device, pod, tg->dim);
         hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
-        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device
-                                              , pod_id
-                                              , (1 + tg->dim.x * tg->dim.y) * sizeof(int)
-                                              , &barcfg_eva));
-
-        // initialize barcfg
-        int barcfg [tg->dim.x * tg->dim.y + 1];
-        hb_mc_coordinate_t cord, og = hb_mc_coordinate(0,0);
-        foreach_coordinate(cord, og, tg->dim) {
-                int id = cord.y * tg->dim.x + cord.x;
+        hb_mc_eva_t barcfg_eva;
 
-                // compute for id
-                barcfg[1+id] = hb_mc_hw_barrier_csr_val(&device->mc->config, cord.x, cord.y, tg->dim.x, tg->dim.y);
+        if (!barcfg->free.empty()) {
+                // reuse a buffer; only the lock word may have changed
+                barcfg_eva = barcfg->free.back();
+                barcfg->free.pop_back();
+                BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id, barcfg_eva,
+                                                                &barcfg->csr[0], sizeof(barcfg->csr[0])));
+        } else {
+                // allocate an array for csr values and copy them over
+                size_t size = barcfg->csr.size() * sizeof(barcfg->csr[0]);
+                BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod_id, size, &barcfg_eva));
+                BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id, barcfg_eva,
+                                                                barcfg->csr.data(), size));
         }
-        // word zero holds the amoadd barrier lock
-        barcfg[0] = 0;
 
-        // copy csr val vector to device
-        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id, barcfg_eva, barcfg, sizeof(barcfg)));
+        barcfg->refcount += 1;
 
-        // save so we can free later
+        // save so we can return it to the pool later
         tg->barcfg_eva = barcfg_eva;
 
-        return HB_MC_SUCCESS;       
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Return a tile group's barrier config buffer to the pool for its shape.
+ */
+static int hb_mc_device_pod_barcfg_release(hb_mc_device_t *device,
+                                           hb_mc_pod_t *pod,
+                                           hb_mc_dimension_t dim,
+                                           hb_mc_eva_t barcfg_eva)
+{
+        hb_mc_barcfg_t *barcfg = hb_mc_device_pod_barcfg_lookup(device, pod, dim);
+        if (barcfg->refcount == 0) {
+                bsg_pr_err("%s: barrier config buffer 0x%08" PRIx32 " is not in use\n",
+                           __func__, barcfg_eva);
+                return HB_MC_INVALID;
+        }
+
+        barcfg->refcount -= 1;
+        barcfg->free.push_back(barcfg_eva);
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Free every pooled barrier config buffer of a pod.
+ * Called once no tile group holds a buffer.
+ */
+static void hb_mc_device_pod_barcfgs_exit(hb_mc_device_t *device, hb_mc_pod_t *pod)
+{
+        hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
+        while (pod->barcfgs != NULL) {
+                hb_mc_barcfg_t *barcfg = pod->barcfgs;
+                pod->barcfgs = barcfg->next;
+                if (barcfg->refcount != 0)
+                        bsg_pr_warn("%s: %" PRIu32 " barrier config buffers still in use\n",
+                                    __func__, barcfg->refcount);
+                for (hb_mc_eva_t eva : barcfg->free) {
+                        if (hb_mc_device_pod_free(device, pod_id, eva) != HB_MC_SUCCESS)
+                                bsg_pr_warn("%s: failed to free barrier config buffer 0x%08" PRIx32 "\n",
+                                            __func__, eva);
+                }
+                delete barcfg;
+        }
+        pod->uses_hw_barrier = -1;
 }
 
 __attribute__((warn_unused_result))
@@ -1637,38 +2309,47 @@ int hb_mc_device_pod_tile_group_launch(hb_mc_device_t *device, hb_mc_pod_t *pod,
                    __func__, device->name, pod->program->bin_name, kernel->name);
 
         // initialize argv
-        // allocate argv
-        hb_mc_eva_t argv_addr;
-        hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
-        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod_id, kernel->argc * sizeof(*(kernel->argv)), &argv_addr));
-        tile_group->argv_eva = argv_addr;
-
-        // copy argv over
-        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id,
-                                                        tile_group->argv_eva,
-                                                        &kernel->argv[0],
-                                                        kernel->argc * sizeof(*(kernel->argv))));
+        // all tile groups of a kernel share one copy, made by the first to launch
+        if (kernel->argv_eva == 0) {
+                hb_mc_eva_t argv_addr;
+                hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
+                BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod_id, kernel->argc * sizeof(*(kernel->argv)), &argv_addr));
+
+                // copy argv over
+                BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(device, pod_id,
+                                                                argv_addr,
+                                                                &kernel->argv[0],
+                                                                kernel->argc * sizeof(*(kernel->argv))));
+                kernel->argv_eva = argv_addr;
+        }
+        tile_group->argv_eva = kernel->argv_eva;
 
         // initialize hw barrier array
         BSG_CUDA_CALL(hb_mc_device_pod_tile_group_barrier_init(device, pod, tile_group));
 
         // find kernel
         hb_mc_eva_t kernel_addr;
-        BSG_CUDA_CALL(hb_mc_loader_symbol_to_eva(pod->program->bin, pod->program->bin_size, kernel->name, &kernel_addr));
+        BSG_CUDA_CALL(hb_mc_program_symbol_to_eva(pod->program, kernel->name, &kernel_addr));
 
 
-        hb_mc_coordinate_t coord;
-        foreach_coordinate(coord, tile_group->origin, tile_group->dim)
-        {
-                hb_mc_idx_t tile_id = hb_mc_get_tile_id(pod->mesh->origin, pod->mesh->dim, coord);
-                hb_mc_tile_t *tile = &pod->mesh->tiles[tile_id];
-                // this will wake the tile up
-                BSG_CUDA_CALL(tile_set_runtime_symbols(device, pod, tile, tile_group,
-                                                       kernel->argc, kernel_addr));
+        // write the runtime values of every tile, then wake them all at once
+        hb_mc_eva_t desc_eva;
+        if (hb_mc_program_has_launch_desc(pod->program, &desc_eva)) {
+                BSG_CUDA_CALL(tile_group_set_launch_descs(device, pod, tile_group, kernel->argc, desc_eva));
+        } else {
+                BSG_CUDA_CALL(tile_group_set_runtime_symbols(device, pod, tile_group, kernel->argc));
         }
 
+        BSG_CUDA_CALL(tile_group_wake(device, pod, tile_group, kernel_addr));
+
         // make tile group as launched
         tile_group->status = HB_MC_TILE_GROUP_STATUS_LAUNCHED;
+        pod->num_tile_groups_launched += 1;
+
+        // index it by origin so its finish packet can find it
+        hb_mc_idx_t slot;
+        BSG_CUDA_CALL(pod_origin_to_slot(pod, tile_group->origin, &slot));
+        pod->launched_tile_groups[slot] = tile_group - pod->tile_groups;
 
         return HB_MC_SUCCESS;
 }
@@ -1705,23 +2386,27 @@ int hb_mc_device_pod_try_launch_tile_groups(hb_mc_device_t *device,
         hb_mc_tile_group_t *tg;
         hb_mc_dimension_t last_failed = hb_mc_dimension(0,0);
 
-        // scan for ready tile groups
-        pod_foreach_tile_group(pod, tg)
+        // visit each pending tile group once, in enqueue order;
+        // those that cannot launch go back on the end of the ring
+        uint32_t pending = pod->num_tile_groups_pending;
+        for (uint32_t i = 0; i < pending; i++)
         {
-                // only look at ready tile groups
-                if (tg->status != HB_MC_TILE_GROUP_STATUS_INITIALIZED)
-                        continue;
+                uint32_t slot = pod_pending_pop(pod);
+                tg = &pod->tile_groups[slot];
 
                 // skip if we know this shape fails
                 if (last_failed.x == tg->dim.x &&
-                    last_failed.y == tg->dim.y)
+                    last_failed.y == tg->dim.y) {
+                        pod_pending_push(pod, slot);
                         continue;
+                }
 
                 // keep going if we can't allocate
                 r = hb_mc_device_pod_tile_group_allocate_tiles(device, pod, tg);
                 if (r != HB_MC_SUCCESS) {
                         // mark this shape as the last failed
                         last_failed = tg->dim;
+                        pod_pending_push(pod, slot);
                         continue;
                 }
 
@@ -1799,6 +2484,86 @@ int hb_mc_device_podv_try_launch_tile_groups(hb_mc_device_t *device,
         return HB_MC_SUCCESS;
 }
 
+// forward declaration
+static int hb_mc_persistent_complete(hb_mc_persistent_t *persistent, uint32_t seq);
+
+/**
+ * Handle a request packet from the manycore.
+ * Finish packets release their tile group; work completions from a
+ * persistent dispatcher are counted against its queue.
+ * @return HB_MC_SUCCESS if a tile group finished. HB_MC_NOTFOUND if the packet finished no tile group.
+ */
+static
+int hb_mc_device_handle_request(hb_mc_device_t *device,
+                                hb_mc_request_packet_t *rqst,
+                                hb_mc_pod_id_t *pod_done)
+{
+        #ifdef DEBUG
+        char pkt_str[256];
+        hb_mc_request_packet_to_string(rqst, pkt_str, sizeof(pkt_str));
+        bsg_pr_dbg("%s: received packet %s\n",
+                   __func__,
+                   pkt_str);
+        #endif
+
+        // identify the pod
+        hb_mc_coordinate_t src =
+                hb_mc_coordinate(hb_mc_request_packet_get_x_src(rqst),
+                                 hb_mc_request_packet_get_y_src(rqst));
+
+        hb_mc_coordinate_t podco = hb_mc_config_pod(&device->mc->config, src);
+        hb_mc_pod_id_t pid = hb_mc_coordinate_to_index(podco, device->mc->config.pods);
+        hb_mc_pod_t *pod = &device->pods[pid];
+
+        // is it a work completion from a persistent dispatcher?
+        if (pod->persistent != NULL &&
+            hb_mc_request_packet_get_epa(rqst) == HB_MC_CUDA_HOST_WORK_DONE_ADDR) {
+                BSG_CUDA_CALL(hb_mc_persistent_complete(pod->persistent,
+                                                        hb_mc_request_packet_get_data(rqst)));
+                return HB_MC_NOTFOUND;
+        }
+
+        // is it a finish packet?
+        if (hb_mc_request_packet_get_data(rqst) != HB_MC_CUDA_FINISH_SIGNAL_VAL) {
+                bsg_pr_dbg("%s: not a finish packet\n", __func__);
+                return HB_MC_NOTFOUND;
+        }
+
+        // find the launched tile group with matching origin and finish signal
+        hb_mc_tile_group_t *tg = NULL;
+        if (pod->launched_tile_groups != NULL)
+                tg = pod_find_launched_tile_group(pod, src, hb_mc_request_packet_get_epa(rqst));
+
+        if (tg == NULL) {
+                bsg_pr_dbg("%s: packet received with finished signal "
+                           "value but no matching tile-group",
+                           __func__);
+                return HB_MC_NOTFOUND;
+        }
+
+        #ifdef DEBUG
+        bsg_pr_dbg("%s: received finish packet from (%d,%d)\n",
+                   __func__, tg->origin.x, tg->origin.y);
+        #endif
+        // remove it from the launched index
+        hb_mc_idx_t slot;
+        BSG_CUDA_CALL(pod_origin_to_slot(pod, tg->origin, &slot));
+        pod->launched_tile_groups[slot] = POD_NO_TILE_GROUP;
+        pod->num_tile_groups_launched -= 1;
+        pod->num_tile_groups_finished += 1;
+
+        // deallocate tiles
+        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_deallocate_tiles(device, pod, tg));
+
+        // cleanup tile group and recycle its slot
+        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_exit(device, pod, tg));
+        pod_tile_group_slot_release(pod, tg);
+
+        // mark this pod as having completed a tile-group
+        *pod_done = pid;
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Wait for any tile group to complete. Cleanup and release that tile groups resources.
  * @return pod_done  The pod on which a tile-group just completed
@@ -1817,66 +2582,9 @@ int hb_mc_device_podv_wait_for_tile_group_finish_any(hb_mc_device_t *device,
                 // perform a blocking read from the request fifo
                 BSG_CUDA_CALL(hb_mc_manycore_request_rx(device->mc, &rqst, -1));
 
-                #ifdef DEBUG
-                char pkt_str[256];
-                hb_mc_request_packet_to_string(&rqst, pkt_str, sizeof(pkt_str));
-                bsg_pr_dbg("%s: received packet %s\n",
-                           __func__,
-                           pkt_str);
-                #endif
-                // request packet read
-                // is it a finish packet?
-                if (hb_mc_request_packet_get_data(&rqst) != HB_MC_CUDA_FINISH_SIGNAL_VAL) {
-                        bsg_pr_dbg("%s: not a finish packet\n", __func__);
-                        continue;
-                }
-
-                // identify the pod
-                hb_mc_coordinate_t src =
-                        hb_mc_coordinate(hb_mc_request_packet_get_x_src(&rqst),
-                                         hb_mc_request_packet_get_y_src(&rqst));
-
-                hb_mc_coordinate_t podco = hb_mc_config_pod(&device->mc->config, src);
-                hb_mc_pod_id_t pid = hb_mc_coordinate_to_index(podco, device->mc->config.pods);
-                hb_mc_pod_t *pod = &device->pods[pid];
-
-                // find the tile group with matching origin in pod
-                hb_mc_tile_group_t *tg;
-                pod_foreach_tile_group(pod, tg)
-                {
-                        // only look for launched tile groups
-                        if (tg->status != HB_MC_TILE_GROUP_STATUS_LAUNCHED) {
-                                continue;
-                        }
-
-                        // origin matches?
-                        if (!(tg->origin.x == src.x && tg->origin.y == src.y))
-                                continue;
-
-                        // finish signal epa matches?
-                        if (hb_mc_request_packet_get_epa(&rqst)
-                            != hb_mc_npa_get_epa(&tg->finish_signal_npa))
-                                continue;
-
-                        #ifdef DEBUG
-                        bsg_pr_dbg("%s: received finish packet from (%d,%d)\n",
-                                   __func__, tg->origin.x, tg->origin.y);
-                        #endif
-                        // this is the matching tile group
-                        // deallocate tiles
-                        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_deallocate_tiles(device, pod, tg));
-
-                        // cleanup tile group
-                        BSG_CUDA_CALL(hb_mc_device_pod_tile_group_exit(device, pod, tg));
-
-                        // mark this pod as having completed a tile-group
-                        *pod_done = pid;
-                        return HB_MC_SUCCESS;
-                }
-
-                bsg_pr_dbg("%s: packet received with finished signal "
-                           "value but no matching tile-group",
-                           __func__);
+                int r = hb_mc_device_handle_request(device, &rqst, pod_done);
+                if (r != HB_MC_NOTFOUND)
+                        return r;
         }
 }
 
@@ -1935,94 +2643,962 @@ int hb_mc_device_pods_kernels_execute(hb_mc_device_t *device)
 }
 
 
-/********************/
-/* Legacy Interface */
-/********************/
+////////////////////////
+// Streams and Events //
+////////////////////////
+typedef enum {
+        HB_MC_STREAM_OP_MEMCPY,
+        HB_MC_STREAM_OP_KERNEL,
+        HB_MC_STREAM_OP_EVENT,
+} hb_mc_stream_op_type_t;
+
+typedef struct {
+        hb_mc_stream_op_type_t type;
+        int started;
+        int finished;
+        // HB_MC_STREAM_OP_MEMCPY
+        void *dst;
+        const void *src;
+        uint32_t count;
+        enum hb_mc_memcpy_kind kind;
+        // HB_MC_STREAM_OP_KERNEL
+        hb_mc_dimension_t grid_dim;
+        hb_mc_dimension_t tg_dim;
+        hb_mc_kernel_t *kernel; // owned by the stream until started
+        // HB_MC_STREAM_OP_EVENT
+        hb_mc_event_t *event;
+} hb_mc_stream_op_t;
+
+struct hb_mc_stream {
+        hb_mc_device_t *device;
+        hb_mc_pod_id_t pod_id;
+        // std::deque never moves its elements, so kernels can point at their op
+        std::deque<hb_mc_stream_op_t> ops;
+        hb_mc_stream_t *next; // next stream on the same pod
+};
 
+struct hb_mc_event {
+        hb_mc_stream_t *stream; // stream this event is pending on, or NULL
+        int completed;
+        uint64_t cycle;         // device cycle counter when the event completed
+};
 
 /**
- * Takes in a buffer containing the binary and its size,
- * freezes tiles, loads program binary into all tiles and into dram,
- * and sets the symbols and registers for each tile.
- * @param[in]  device        Pointer to device
- * @parma[in]  bin_name      Name of binary elf file
- * @param[in]  bin_data      Buffer containing binary
- * @param[in]  bin_size      Size of the binary to be loaded onto device
- * @param[in]  id            Id of program's memory allocator
- * @param[in]  alloc_name    Unique name of program's memory allocator
- * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ * Add an operation to the back of a stream.
  */
-__attribute__((weak))
-int hb_mc_device_program_init_binary (hb_mc_device_t *device,
-                                      const char *bin_name,
-                                      const unsigned char *bin_data,
-                                      size_t bin_size,
-                                      const char *alloc_name,
-                                      hb_mc_allocator_id_t id)
+static hb_mc_stream_op_t *hb_mc_stream_push(hb_mc_stream_t *stream, hb_mc_stream_op_type_t type)
 {
-        hb_mc_program_options_t opts;
-        hb_mc_program_options_default(&opts);
-        opts.alloc_name = alloc_name;
-        opts.alloc_id = id;
-        opts.program_name = bin_name;
-        return hb_mc_device_pod_program_init_binary_opts(device, device->default_pod_id, bin_data, bin_size, &opts);
+        hb_mc_stream_op_t op = {};
+        op.type = type;
+        stream->ops.push_back(op);
+        return &stream->ops.back();
 }
 
+/**
+ * Start operations at the head of a stream, and retire those that have
+ * finished, until the head is a kernel whose tile groups are still running.
+ */
+__attribute__((warn_unused_result))
+static int hb_mc_stream_advance(hb_mc_stream_t *stream)
+{
+        hb_mc_device_t *device = stream->device;
+        hb_mc_pod_t *pod = &device->pods[stream->pod_id];
+
+        while (!stream->ops.empty()) {
+                hb_mc_stream_op_t *op = &stream->ops.front();
+                if (!op->started) {
+                        op->started = 1;
+                        switch (op->type) {
+                        case HB_MC_STREAM_OP_MEMCPY:
+                                BSG_CUDA_CALL(hb_mc_device_pod_memcpy(device, stream->pod_id,
+                                                                      op->dst, op->src,
+                                                                      op->count, op->kind));
+                                op->finished = 1;
+                                break;
+                        case HB_MC_STREAM_OP_KERNEL: {
+                                // the tile groups own the kernel from here on
+                                hb_mc_kernel_t *kernel = op->kernel;
+                                op->kernel = NULL;
+                                BSG_CUDA_CALL(hb_mc_device_pod_grid_enqueue(device, pod,
+                                                                            op->grid_dim, op->tg_dim,
+                                                                            kernel));
+                                break;
+                        }
+                        case HB_MC_STREAM_OP_EVENT:
+                                BSG_MANYCORE_CALL(device->mc, hb_mc_manycore_get_cycle(device->mc, &op->event->cycle));
+                                op->event->completed = 1;
+                                op->event->stream = NULL;
+                                op->finished = 1;
+                                break;
+                        }
+                }
 
+                if (!op->finished)
+                        break;
 
+                stream->ops.pop_front();
+        }
 
+        return HB_MC_SUCCESS;
+}
 
 /**
- * Takes in a binary name, loads the binary from file onto a buffer,
- * freezes tiles, loads program binary into all tiles and into dram,
- * and sets the symbols and registers for each tile.
- * @param[in]  device        Pointer to device
- * @parma[in]  bin_name      Name of binary elf file
- * @param[in]  id            Id of program's memory allocator
- * @param[in]  alloc_name    Unique name of program's memory allocator
- * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ * Advance every stream on a pod and launch as many tile groups as fit.
  */
-__attribute__((weak))
-int hb_mc_device_program_init (hb_mc_device_t *device,
-                               const char *bin_name,
-                               const char *alloc_name,
-                               hb_mc_allocator_id_t id)
+__attribute__((warn_unused_result))
+static int hb_mc_device_pod_streams_progress(hb_mc_device_t *device, hb_mc_pod_t *pod)
 {
-        hb_mc_program_options_t opts;
-        hb_mc_program_options_default(&opts);
-        opts.alloc_name = alloc_name;
-        opts.alloc_id = id;
-        opts.program_name = bin_name;
-        return hb_mc_device_pod_program_init_opts(device, device->default_pod_id, bin_name, &opts);
+        for (hb_mc_stream_t *stream = pod->streams; stream != NULL; stream = stream->next)
+                BSG_CUDA_CALL(hb_mc_stream_advance(stream));
+
+        return hb_mc_device_pod_try_launch_tile_groups(device, pod);
 }
 
+/**
+ * Handle every request packet that has already arrived, then advance the
+ * streams on a pod. Never blocks.
+ */
+__attribute__((warn_unused_result))
+static int hb_mc_device_pod_streams_poll(hb_mc_device_t *device, hb_mc_pod_t *pod)
+{
+        while (true) {
+                hb_mc_request_packet_t rqst;
+                int r = hb_mc_manycore_request_rx(device->mc, &rqst, 0);
+                if (r == HB_MC_TIMEOUT)
+                        break;
+                if (r != HB_MC_SUCCESS)
+                        return r;
+
+                hb_mc_pod_id_t pod_done;
+                r = hb_mc_device_handle_request(device, &rqst, &pod_done);
+                if (r == HB_MC_NOTFOUND)
+                        continue;
+                if (r != HB_MC_SUCCESS)
+                        return r;
+
+                // refill the pod that just freed tiles
+                BSG_CUDA_CALL(hb_mc_device_pod_streams_progress(device, &device->pods[pod_done]));
+        }
 
+        return hb_mc_device_pod_streams_progress(device, pod);
+}
 
 /**
- * Allocates memory on device DRAM
- * hb_mc_device_program_init() or hb_mc_device_program_init_binary() should
- * have been called before calling this function to set up a memory allocator.
- * @param[in]  device        Pointer to device
- * @parma[in]  size          Size of requested memory
- * @param[out] eva           Eva address of the allocated memory
- * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ * Drive the streams on a pod until done(arg) returns true.
  */
-__attribute__((weak))
-int hb_mc_device_malloc (hb_mc_device_t *device, uint32_t size, hb_mc_eva_t *eva)
+__attribute__((warn_unused_result))
+static int hb_mc_device_pod_streams_wait(hb_mc_device_t *device,
+                                         hb_mc_pod_t *pod,
+                                         int (*done)(const void *arg),
+                                         const void *arg)
 {
-        return hb_mc_device_pod_malloc(device, device->default_pod_id, size, eva);
-}
+        while (true) {
+                BSG_CUDA_CALL(hb_mc_device_pod_streams_progress(device, pod));
+                if (done(arg))
+                        return HB_MC_SUCCESS;
 
+                // every stream is blocked on a kernel, so something must be running
+                if (pod->num_tile_groups_launched == 0) {
+                        bsg_pr_err("%s: waiting on tile groups that cannot be launched\n", __func__);
+                        return HB_MC_FAIL;
+                }
 
+                BSG_CUDA_CALL(hb_mc_device_pod_wait_for_tile_group_finish_any(device, pod));
+        }
+}
 
+static int hb_mc_stream_idle(const void *arg)
+{
+        return static_cast<const hb_mc_stream_t*>(arg)->ops.empty();
+}
 
+static int hb_mc_event_completed(const void *arg)
+{
+        return static_cast<const hb_mc_event_t*>(arg)->completed;
+}
 
 /**
- * Copies a buffer from src on the host/device DRAM to dst on device DRAM/host.
- * @param[in]  device        Pointer to device
- * @parma[in]  src           EVA address of source to be copied from
- * @parma[in]  dst           EVA address of destination to be copied into
- * @param[in]  name          EVA address of dst
+ * Release a stream's resources without waiting for its work.
+ */
+static void hb_mc_stream_release(hb_mc_stream_t *stream)
+{
+        for (hb_mc_stream_op_t &op : stream->ops) {
+                // kernels that never started still belong to the stream
+                if (op.type == HB_MC_STREAM_OP_KERNEL && op.kernel != NULL) {
+                        if (kernel_exit(op.kernel) == HB_MC_SUCCESS)
+                                free(op.kernel);
+                }
+                if (op.type == HB_MC_STREAM_OP_EVENT && !op.started)
+                        op.event->stream = NULL;
+        }
+        delete stream;
+}
+
+/**
+ * Release all streams on a pod. Called when the pod's program finishes,
+ * after its tile groups have been cleaned up.
+ */
+static void hb_mc_device_pod_streams_exit(hb_mc_device_t *device, hb_mc_pod_t *pod)
+{
+        while (pod->streams != NULL) {
+                hb_mc_stream_t *stream = pod->streams;
+                pod->streams = stream->next;
+                bsg_pr_warn("%s: releasing a stream that was not destroyed\n", __func__);
+                hb_mc_stream_release(stream);
+        }
+}
+
+/**
+ * Create a stream on a pod.
+ * The pod must have a program loaded.
+ * @param[in]  device  Pointer to device
+ * @param[in]  pod_id  Pod ID
+ * @param[out] stream  The new stream
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_stream_create(hb_mc_device_t *device,
+                                   hb_mc_pod_id_t pod_id,
+                                   hb_mc_stream_t **stream)
+{
+        CHECK_POD_ID(device, pod_id);
+        CHECK_PTR(stream);
+
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+        if (!pod->program_loaded) {
+                bsg_pr_err("%s: no program loaded on pod %d\n", __func__, pod_id);
+                return HB_MC_UNINITIALIZED;
+        }
+
+        hb_mc_stream_t *s = new hb_mc_stream_t;
+        s->device = device;
+        s->pod_id = pod_id;
+        s->next = pod->streams;
+        pod->streams = s;
+
+        *stream = s;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Create a stream on the default pod.
+ * @param[in]  device  Pointer to device
+ * @param[out] stream  The new stream
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_stream_create(hb_mc_device_t *device, hb_mc_stream_t **stream)
+{
+        return hb_mc_device_pod_stream_create(device, device->default_pod_id, stream);
+}
+
+/**
+ * Wait for all work in a stream to complete and destroy it.
+ * @param[in] stream  A stream created with hb_mc_stream_create()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_stream_destroy(hb_mc_stream_t *stream)
+{
+        CHECK_PTR(stream);
+        BSG_CUDA_CALL(hb_mc_stream_synchronize(stream));
+
+        // unlink from the pod
+        hb_mc_pod_t *pod = &stream->device->pods[stream->pod_id];
+        hb_mc_stream_t **link = &pod->streams;
+        while (*link != stream)
+                link = &(*link)->next;
+        *link = stream->next;
+
+        hb_mc_stream_release(stream);
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Enqueue a copy between the host and device DRAM on a stream.
+ * The host buffer must stay valid until the copy completes.
+ * @param[in] stream  A stream created with hb_mc_stream_create()
+ * @param[in] dst     Destination (EVA for HB_MC_MEMCPY_TO_DEVICE, host pointer otherwise)
+ * @param[in] src     Source (host pointer for HB_MC_MEMCPY_TO_DEVICE, EVA otherwise)
+ * @param[in] count   Size of buffer (number of bytes) to be copied
+ * @param[in] kind    Direction of copy (HB_MC_MEMCPY_TO_DEVICE / HB_MC_MEMCPY_TO_HOST)
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_stream_memcpy_async(hb_mc_stream_t *stream,
+                              void *dst,
+                              const void *src,
+                              uint32_t count,
+                              enum hb_mc_memcpy_kind kind)
+{
+        CHECK_PTR(stream);
+
+        hb_mc_stream_op_t *op = hb_mc_stream_push(stream, HB_MC_STREAM_OP_MEMCPY);
+        op->dst = dst;
+        op->src = src;
+        op->count = count;
+        op->kind = kind;
+
+        // start it now if the stream is otherwise idle
+        return hb_mc_stream_advance(stream);
+}
+
+/**
+ * Enqueue a kernel on a stream.
+ * Its tile groups are scheduled once all earlier work in the stream has completed.
+ * @param[in] stream    A stream created with hb_mc_stream_create()
+ * @param[in] grid_dim  X/Y dimensions of the grid to be initialized
+ * @param[in] tg_dim    X/Y dimensions of tile groups in grid
+ * @param[in] name      Kernel name to be executed on tile groups in grid
+ * @param[in] argc      Number of input arguments to kernel
+ * @param[in] argv      List of input arguments to kernel
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_stream_kernel_enqueue(hb_mc_stream_t *stream,
+                                hb_mc_dimension_t grid_dim,
+                                hb_mc_dimension_t tg_dim,
+                                const char *name,
+                                uint32_t argc,
+                                const uint32_t *argv)
+{
+        CHECK_PTR(stream);
+
+        // copy the name and arguments now; the caller may reuse them
+        hb_mc_kernel_t *kernel;
+        XMALLOC(kernel);
+        BSG_CUDA_CALL(kernel_init(kernel, name, argc, argv));
+
+        hb_mc_stream_op_t *op = hb_mc_stream_push(stream, HB_MC_STREAM_OP_KERNEL);
+        op->grid_dim = grid_dim;
+        op->tg_dim = tg_dim;
+        op->kernel = kernel;
+        kernel->finished = &op->finished;
+
+        // schedule it now if the stream is otherwise idle
+        hb_mc_pod_t *pod = &stream->device->pods[stream->pod_id];
+        return hb_mc_device_pod_streams_progress(stream->device, pod);
+}
+
+/**
+ * Block until all work in a stream has completed.
+ * @param[in] stream  A stream created with hb_mc_stream_create()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_stream_synchronize(hb_mc_stream_t *stream)
+{
+        CHECK_PTR(stream);
+        hb_mc_pod_t *pod = &stream->device->pods[stream->pod_id];
+        return hb_mc_device_pod_streams_wait(stream->device, pod, hb_mc_stream_idle, stream);
+}
+
+/**
+ * Make progress on a stream without blocking.
+ * Handles any finish packets that have arrived, so it may be polled in a loop.
+ * @param[in] stream  A stream created with hb_mc_stream_create()
+ * @return HB_MC_SUCCESS if all work in the stream has completed. HB_MC_BUSY if work remains.
+ */
+int hb_mc_stream_query(hb_mc_stream_t *stream)
+{
+        CHECK_PTR(stream);
+        hb_mc_pod_t *pod = &stream->device->pods[stream->pod_id];
+        BSG_CUDA_CALL(hb_mc_device_pod_streams_poll(stream->device, pod));
+        return hb_mc_stream_idle(stream) ? HB_MC_SUCCESS : HB_MC_BUSY;
+}
+
+/**
+ * Create an event.
+ * @param[out] event  The new event
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_event_create(hb_mc_event_t **event)
+{
+        CHECK_PTR(event);
+
+        hb_mc_event_t *e;
+        XMALLOC(e);
+        e->stream = NULL;
+        e->completed = 0;
+        e->cycle = 0;
+
+        *event = e;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Destroy an event. The event must not be pending on a stream.
+ * @param[in] event  An event created with hb_mc_event_create()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_event_destroy(hb_mc_event_t *event)
+{
+        CHECK_PTR(event);
+        if (event->stream != NULL) {
+                bsg_pr_err("%s: event is still pending on a stream\n", __func__);
+                return HB_MC_BUSY;
+        }
+
+        free(event);
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Record an event on a stream.
+ * The event completes when all work enqueued on the stream before it has completed,
+ * and it records the device cycle counter at that point.
+ * @param[in] event   An event created with hb_mc_event_create()
+ * @param[in] stream  A stream created with hb_mc_stream_create()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_event_record(hb_mc_event_t *event, hb_mc_stream_t *stream)
+{
+        CHECK_PTR(event);
+        CHECK_PTR(stream);
+        if (event->stream != NULL) {
+                bsg_pr_err("%s: event is already pending on a stream\n", __func__);
+                return HB_MC_BUSY;
+        }
+
+        event->stream = stream;
+        event->completed = 0;
+
+        hb_mc_stream_op_t *op = hb_mc_stream_push(stream, HB_MC_STREAM_OP_EVENT);
+        op->event = event;
+
+        // complete it now if the stream is otherwise idle
+        return hb_mc_stream_advance(stream);
+}
+
+/**
+ * Block until an event has completed.
+ * @param[in] event  An event recorded with hb_mc_event_record()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_event_synchronize(hb_mc_event_t *event)
+{
+        CHECK_PTR(event);
+        if (event->completed)
+                return HB_MC_SUCCESS;
+
+        hb_mc_stream_t *stream = event->stream;
+        if (stream == NULL) {
+                bsg_pr_err("%s: event was never recorded\n", __func__);
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_pod_t *pod = &stream->device->pods[stream->pod_id];
+        return hb_mc_device_pod_streams_wait(stream->device, pod, hb_mc_event_completed, event);
+}
+
+/**
+ * Make progress on an event's stream without blocking.
+ * Handles any finish packets that have arrived, so it may be polled in a loop.
+ * @param[in] event  An event recorded with hb_mc_event_record()
+ * @return HB_MC_SUCCESS if the event has completed. HB_MC_BUSY if it has not.
+ */
+int hb_mc_event_query(hb_mc_event_t *event)
+{
+        CHECK_PTR(event);
+        if (!event->completed && event->stream != NULL) {
+                hb_mc_stream_t *stream = event->stream;
+                hb_mc_pod_t *pod = &stream->device->pods[stream->pod_id];
+                BSG_CUDA_CALL(hb_mc_device_pod_streams_poll(stream->device, pod));
+        }
+        return event->completed ? HB_MC_SUCCESS : HB_MC_BUSY;
+}
+
+/**
+ * Get the number of device cycles between two completed events.
+ * @param[in]  start   An event that completed first
+ * @param[in]  end     An event that completed later
+ * @param[out] cycles  Cycles from start to end
+ * @return HB_MC_SUCCESS if succesful. HB_MC_BUSY if either event has not completed.
+ */
+int hb_mc_event_elapsed_cycles(const hb_mc_event_t *start,
+                               const hb_mc_event_t *end,
+                               uint64_t *cycles)
+{
+        CHECK_PTR(start);
+        CHECK_PTR(end);
+        CHECK_PTR(cycles);
+        if (!start->completed || !end->completed)
+                return HB_MC_BUSY;
+
+        *cycles = end->cycle - start->cycle;
+        return HB_MC_SUCCESS;
+}
+
+
+/////////////////////
+// Persistent Mode //
+/////////////////////
+struct hb_mc_persistent {
+        hb_mc_device_t *device;
+        hb_mc_pod_id_t pod_id;
+        hb_mc_eva_t queue_eva;  // hb_mc_cuda_work_queue_t in device DRAM
+        uint32_t capacity;
+        uint32_t tiles;         // every tile of the dispatcher reports every descriptor
+        uint32_t pushed;        // descriptors pushed, not counting the stop descriptor
+        uint32_t completed;     // descriptors every tile has finished; they finish in order
+        uint32_t *done_count;   // tiles that have reported the descriptor in each slot
+        int finished;           // set when the dispatcher tile group returns
+};
+
+/**
+ * Get the EVA of a descriptor slot.
+ */
+static hb_mc_eva_t hb_mc_persistent_slot_eva(const hb_mc_persistent_t *persistent, uint32_t n)
+{
+        return persistent->queue_eva
+                + sizeof(hb_mc_cuda_work_queue_t)
+                + (n % persistent->capacity) * sizeof(hb_mc_cuda_work_desc_t);
+}
+
+/**
+ * Write descriptor n. Its sequence number is written last, after the
+ * rest of the descriptor is visible, so the dispatcher never sees a
+ * partial descriptor.
+ */
+__attribute__((warn_unused_result))
+static int hb_mc_persistent_write_desc(hb_mc_persistent_t *persistent,
+                                       uint32_t n,
+                                       hb_mc_cuda_work_desc_t *desc)
+{
+        hb_mc_eva_t eva = hb_mc_persistent_slot_eva(persistent, n);
+        desc->seq = n + 1;
+
+        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(persistent->device, persistent->pod_id,
+                                                        eva, desc,
+                                                        offsetof(hb_mc_cuda_work_desc_t, seq)));
+        BSG_CUDA_CALL(hb_mc_device_pod_memcpy_to_device(persistent->device, persistent->pod_id,
+                                                        eva + offsetof(hb_mc_cuda_work_desc_t, seq),
+                                                        &desc->seq, sizeof(desc->seq)));
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Count one tile's report that it finished a descriptor.
+ */
+static int hb_mc_persistent_complete(hb_mc_persistent_t *persistent, uint32_t seq)
+{
+        uint32_t n = seq - 1;
+        uint32_t outstanding = persistent->pushed - persistent->completed;
+        if (n - persistent->completed >= outstanding) {
+                bsg_pr_err("%s: completion for descriptor %u, which is not outstanding\n",
+                           __func__, n);
+                return HB_MC_INVALID;
+        }
+
+        persistent->done_count[n % persistent->capacity] += 1;
+
+        // retire descriptors every tile has finished
+        while (persistent->completed != persistent->pushed) {
+                uint32_t *count = &persistent->done_count[persistent->completed % persistent->capacity];
+                if (*count != persistent->tiles)
+                        break;
+                *count = 0;
+                persistent->completed++;
+        }
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Block until the next request packet has been handled.
+ */
+__attribute__((warn_unused_result))
+static int hb_mc_persistent_wait_any(hb_mc_persistent_t *persistent)
+{
+        if (persistent->finished) {
+                bsg_pr_err("%s: dispatcher returned while work was outstanding\n", __func__);
+                return HB_MC_FAIL;
+        }
+
+        hb_mc_request_packet_t rqst;
+        hb_mc_pod_id_t pod_done;
+        BSG_CUDA_CALL(hb_mc_manycore_request_rx(persistent->device->mc, &rqst, -1));
+
+        int r = hb_mc_device_handle_request(persistent->device, &rqst, &pod_done);
+        if (r != HB_MC_NOTFOUND)
+                return r;
+
+        // completions are counted by the handler; anything else is unexpected
+        if (hb_mc_request_packet_get_epa(&rqst) != HB_MC_CUDA_HOST_WORK_DONE_ADDR) {
+                char pkt_str[256];
+                hb_mc_request_packet_to_string(&rqst, pkt_str, sizeof(pkt_str));
+                bsg_pr_warn("%s: dropping unexpected packet %s\n", __func__, pkt_str);
+        }
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Release a dispatcher's host resources. Called when the pod's program
+ * finishes, after its tile groups have been cleaned up.
+ */
+static void hb_mc_device_pod_persistent_exit(hb_mc_device_t *device, hb_mc_pod_t *pod)
+{
+        hb_mc_persistent_t *persistent = pod->persistent;
+        if (persistent == NULL)
+                return;
+
+        bsg_pr_warn("%s: releasing a persistent dispatcher that was not stopped\n", __func__);
+        free(persistent->done_count);
+        free(persistent);
+        pod->persistent = NULL;
+}
+
+/**
+ * Free a dispatcher that never started, with its work queue.
+ */
+static void hb_mc_persistent_free(hb_mc_persistent_t *persistent)
+{
+        if (persistent->queue_eva != 0) {
+                int err = hb_mc_device_pod_free(persistent->device, persistent->pod_id,
+                                                persistent->queue_eva);
+                if (err != HB_MC_SUCCESS)
+                        bsg_pr_err("%s: failed to free work queue: %s\n",
+                                   __func__, hb_mc_strerror(err));
+        }
+        free(persistent->done_count);
+        free(persistent);
+}
+
+/**
+ * Allocate a dispatcher's work queue with every slot invalid.
+ */
+__attribute__((warn_unused_result))
+static int hb_mc_persistent_queue_init(hb_mc_persistent_t *persistent, hb_mc_pod_t *pod)
+{
+        hb_mc_device_t *device = persistent->device;
+        hb_mc_pod_id_t pod_id = persistent->pod_id;
+        size_t queue_size = sizeof(hb_mc_cuda_work_queue_t)
+                + persistent->capacity * sizeof(hb_mc_cuda_work_desc_t);
+        BSG_CUDA_CALL(hb_mc_device_pod_malloc(device, pod_id, queue_size, &persistent->queue_eva));
+        BSG_CUDA_CALL(hb_mc_device_pod_memset(device, pod_id, persistent->queue_eva, 0, queue_size));
+
+        // host addresses map to the same EVA from every tile
+        hb_mc_eva_map_t map;
+        hb_mc_eva_t done_eva;
+        size_t sz;
+        hb_mc_npa_t done_npa = hb_mc_npa(hb_mc_manycore_get_host_coordinate(device->mc),
+                                         HB_MC_CUDA_HOST_WORK_DONE_ADDR);
+        BSG_CUDA_CALL(hb_mc_origin_eva_map_init(&map, pod->mesh->origin));
+        int err = hb_mc_npa_to_eva(device->mc, &map, &pod->mesh->origin, &done_npa, &done_eva, &sz);
+        BSG_CUDA_CALL(hb_mc_origin_eva_map_exit(&map));
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        hb_mc_cuda_work_queue_t header = {};
+        header.capacity = persistent->capacity;
+        header.done_addr = done_eva;
+        return hb_mc_device_pod_memcpy_to_device(device, pod_id, persistent->queue_eva,
+                                                 &header, sizeof(header));
+}
+
+/**
+ * Launch a dispatcher's tile group as an ordinary one-group grid.
+ * If it cannot launch, it is removed from the pod again.
+ */
+__attribute__((warn_unused_result))
+static int hb_mc_persistent_launch(hb_mc_persistent_t *persistent,
+                                   hb_mc_pod_t *pod,
+                                   hb_mc_dimension_t tg_dim,
+                                   const char *dispatcher)
+{
+        hb_mc_device_t *device = persistent->device;
+        uint32_t argv[1] = { persistent->queue_eva };
+        hb_mc_kernel_t *kernel;
+        XMALLOC(kernel);
+        int err = kernel_init(kernel, dispatcher, 1, argv);
+        if (err != HB_MC_SUCCESS) {
+                free(kernel);
+                return err;
+        }
+        kernel->finished = &persistent->finished;
+
+        err = hb_mc_device_pod_grid_enqueue(device, pod, hb_mc_dimension(1,1), tg_dim, kernel);
+        if (err != HB_MC_SUCCESS) {
+                if (kernel->refcount == 0)
+                        BSG_CUDA_CALL(kernel_release(device, pod, kernel));
+                return err;
+        }
+
+        err = hb_mc_device_pod_try_launch_tile_groups(device, pod);
+        if (pod->num_tile_groups_pending != 0) {
+                // the only pending group is the dispatcher; exiting it releases the kernel
+                hb_mc_tile_group_t *tg = &pod->tile_groups[pod_pending_pop(pod)];
+                kernel->finished = NULL;
+                BSG_CUDA_CALL(hb_mc_device_pod_tile_group_exit(device, pod, tg));
+                pod_tile_group_slot_release(pod, tg);
+                if (err == HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: %dx%d dispatcher does not fit on pod %d\n",
+                                   __func__, tg_dim.x, tg_dim.y, persistent->pod_id);
+                        err = HB_MC_NOTFOUND;
+                }
+        } else if (err != HB_MC_SUCCESS) {
+                // the group left the queue but did not launch cleanly;
+                // it must not report to a dispatcher that is about to be freed
+                kernel->finished = NULL;
+        }
+        return err;
+}
+
+/**
+ * Launch a persistent dispatcher on a pod.
+ * No other tile groups may be waiting to launch on the pod.
+ * @param[in]  device      Pointer to device
+ * @param[in]  pod_id      Pod ID
+ * @param[in]  tg_dim      X/Y dimensions of the dispatcher tile group
+ * @param[in]  dispatcher  Name of the dispatcher kernel
+ * @param[in]  capacity    Number of descriptor slots in the work queue
+ * @param[out] persistent  The running dispatcher
+ * @return HB_MC_SUCCESS if succesful. HB_MC_NOTFOUND if the dispatcher does not fit on the pod.
+ *         Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_persistent_start(hb_mc_device_t *device,
+                                      hb_mc_pod_id_t pod_id,
+                                      hb_mc_dimension_t tg_dim,
+                                      const char *dispatcher,
+                                      uint32_t capacity,
+                                      hb_mc_persistent_t **persistent)
+{
+        CHECK_POD_ID(device, pod_id);
+        CHECK_PTR(dispatcher);
+        CHECK_PTR(persistent);
+
+        hb_mc_pod_t *pod = &device->pods[pod_id];
+        if (!pod->program_loaded) {
+                bsg_pr_err("%s: no program loaded on pod %d\n", __func__, pod_id);
+                return HB_MC_UNINITIALIZED;
+        }
+
+        if (pod->persistent != NULL || pod->num_tile_groups_pending != 0) {
+                bsg_pr_err("%s: pod %d already has a dispatcher or queued tile groups\n",
+                           __func__, pod_id);
+                return HB_MC_BUSY;
+        }
+
+        if (capacity == 0)
+                return HB_MC_INVALID;
+
+        hb_mc_persistent_t *p;
+        XMALLOC(p);
+        p->done_count = reinterpret_cast<uint32_t*>(calloc(capacity, sizeof(*p->done_count)));
+        if (p->done_count == NULL) {
+                free(p);
+                return HB_MC_NOMEM;
+        }
+        p->device = device;
+        p->pod_id = pod_id;
+        p->capacity = capacity;
+        p->tiles = hb_mc_dimension_to_length(tg_dim);
+        p->pushed = 0;
+        p->completed = 0;
+        p->finished = 0;
+        p->queue_eva = 0;
+
+        // nothing reaches the pod's handler until the dispatcher is fully started
+        int err = hb_mc_persistent_queue_init(p, pod);
+        if (err == HB_MC_SUCCESS)
+                err = hb_mc_persistent_launch(p, pod, tg_dim, dispatcher);
+        if (err != HB_MC_SUCCESS) {
+                hb_mc_persistent_free(p);
+                return err;
+        }
+
+        pod->persistent = p;
+        *persistent = p;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Push a kernel invocation to a persistent dispatcher.
+ * Blocks while the work queue is full.
+ * @param[in]  persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+ * @param[in]  name        Kernel name to be executed
+ * @param[in]  argc        Number of input arguments to kernel (at most HB_MC_CUDA_WORK_MAX_ARGS)
+ * @param[in]  argv        List of input arguments to kernel
+ * @param[out] ticket      Identifies this invocation to hb_mc_persistent_wait(). May be NULL.
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_persistent_push(hb_mc_persistent_t *persistent,
+                          const char *name,
+                          uint32_t argc,
+                          const uint32_t *argv,
+                          uint32_t *ticket)
+{
+        CHECK_PTR(persistent);
+        CHECK_PTR(name);
+        if (argc > HB_MC_CUDA_WORK_MAX_ARGS) {
+                bsg_pr_err("%s: '%s' takes %u arguments; at most %d are supported\n",
+                           __func__, name, argc, HB_MC_CUDA_WORK_MAX_ARGS);
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_cuda_work_desc_t desc = {};
+        hb_mc_pod_t *pod = &persistent->device->pods[persistent->pod_id];
+        BSG_CUDA_CALL(hb_mc_program_symbol_to_eva(pod->program, name, &desc.kernel_ptr));
+        desc.argc = argc;
+        if (argc > 0)
+                memcpy(desc.argv, argv, argc * sizeof(*argv));
+
+        // wait for the dispatcher to free a slot
+        while (persistent->pushed - persistent->completed == persistent->capacity)
+                BSG_CUDA_CALL(hb_mc_persistent_wait_any(persistent));
+
+        uint32_t n = persistent->pushed;
+        BSG_CUDA_CALL(hb_mc_persistent_write_desc(persistent, n, &desc));
+        persistent->pushed++;
+
+        if (ticket != NULL)
+                *ticket = n;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Block until a kernel invocation, and every one pushed before it, has completed.
+ * @param[in] persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+ * @param[in] ticket      A ticket returned by hb_mc_persistent_push()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_persistent_wait(hb_mc_persistent_t *persistent, uint32_t ticket)
+{
+        CHECK_PTR(persistent);
+        if (ticket - persistent->completed >= persistent->pushed - persistent->completed)
+                return HB_MC_SUCCESS;
+
+        // ticket is outstanding; wait until completed passes it
+        while ((int32_t)(persistent->completed - ticket) <= 0)
+                BSG_CUDA_CALL(hb_mc_persistent_wait_any(persistent));
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Block until every kernel invocation pushed so far has completed.
+ * @param[in] persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_persistent_synchronize(hb_mc_persistent_t *persistent)
+{
+        CHECK_PTR(persistent);
+        while (persistent->completed != persistent->pushed)
+                BSG_CUDA_CALL(hb_mc_persistent_wait_any(persistent));
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Wait for all pushed work, stop the dispatcher and free its work queue.
+ * @param[in] persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_persistent_stop(hb_mc_persistent_t *persistent)
+{
+        CHECK_PTR(persistent);
+        BSG_CUDA_CALL(hb_mc_persistent_synchronize(persistent));
+
+        // a null kernel tells the dispatcher to return; it reports nothing,
+        // so it is not counted as pushed
+        hb_mc_cuda_work_desc_t desc = {};
+        BSG_CUDA_CALL(hb_mc_persistent_write_desc(persistent, persistent->pushed, &desc));
+
+        // the dispatcher tile group now finishes like any other
+        hb_mc_pod_t *pod = &persistent->device->pods[persistent->pod_id];
+        while (!persistent->finished) {
+                BSG_CUDA_CALL(hb_mc_device_pod_wait_for_tile_group_finish_any(persistent->device, pod));
+        }
+
+        BSG_CUDA_CALL(hb_mc_device_pod_free(persistent->device, persistent->pod_id, persistent->queue_eva));
+        pod->persistent = NULL;
+        free(persistent->done_count);
+        free(persistent);
+        return HB_MC_SUCCESS;
+}
+
+
+/********************/
+/* Legacy Interface */
+/********************/
+
+
+/**
+ * Takes in a buffer containing the binary and its size,
+ * freezes tiles, loads program binary into all tiles and into dram,
+ * and sets the symbols and registers for each tile.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  bin_name      Name of binary elf file
+ * @param[in]  bin_data      Buffer containing binary
+ * @param[in]  bin_size      Size of the binary to be loaded onto device
+ * @param[in]  id            Id of program's memory allocator
+ * @param[in]  alloc_name    Unique name of program's memory allocator
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_program_init_binary (hb_mc_device_t *device,
+                                      const char *bin_name,
+                                      const unsigned char *bin_data,
+                                      size_t bin_size,
+                                      const char *alloc_name,
+                                      hb_mc_allocator_id_t id)
+{
+        hb_mc_program_options_t opts;
+        hb_mc_program_options_default(&opts);
+        opts.alloc_name = alloc_name;
+        opts.alloc_id = id;
+        opts.program_name = bin_name;
+        return hb_mc_device_pod_program_init_binary_opts(device, device->default_pod_id, bin_data, bin_size, &opts);
+}
+
+
+
+
+
+/**
+ * Takes in a binary name, loads the binary from file onto a buffer,
+ * freezes tiles, loads program binary into all tiles and into dram,
+ * and sets the symbols and registers for each tile.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  bin_name      Name of binary elf file
+ * @param[in]  id            Id of program's memory allocator
+ * @param[in]  alloc_name    Unique name of program's memory allocator
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_program_init (hb_mc_device_t *device,
+                               const char *bin_name,
+                               const char *alloc_name,
+                               hb_mc_allocator_id_t id)
+{
+        hb_mc_program_options_t opts;
+        hb_mc_program_options_default(&opts);
+        opts.alloc_name = alloc_name;
+        opts.alloc_id = id;
+        opts.program_name = bin_name;
+        return hb_mc_device_pod_program_init_opts(device, device->default_pod_id, bin_name, &opts);
+}
+
+
+
+/**
+ * Allocates memory on device DRAM
+ * hb_mc_device_program_init() or hb_mc_device_program_init_binary() should
+ * have been called before calling this function to set up a memory allocator.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  size          Size of requested memory
+ * @param[out] eva           Eva address of the allocated memory
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_malloc (hb_mc_device_t *device, uint32_t size, hb_mc_eva_t *eva)
+{
+        return hb_mc_device_pod_malloc(device, device->default_pod_id, size, eva);
+}
+
+
+
+
+
+/**
+ * Copies a buffer from src on the host/device DRAM to dst on device DRAM/host.
+ * @param[in]  device        Pointer to device
+ * @parma[in]  src           EVA address of source to be copied from
+ * @parma[in]  dst           EVA address of destination to be copied into
+ * @param[in]  name          EVA address of dst
  * @param[in]  count         Size of buffer (number of bytes) to be copied
  * @param[in]  hb_mc_memcpy_kind         Direction of copy (HB_MC_MEMCPY_TO_DEVICE / HB_MC_MEMCPY_TO_HOST)
  * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
@@ -2094,6 +3670,76 @@ int hb_mc_device_memset (hb_mc_device_t *device,
 }
 
 
+/**
+ * Decides how the victim caches are maintained around a DMA batch and
+ * records the batch in the pod's DMA statistics.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod the jobs target
+ * @param[in]  evas          Device address of each job
+ * @param[in]  szs           Size of each job in bytes
+ * @return true if the batch touches more lines than the pod's sweep
+ *         threshold and every vcache in the pod should be swept.
+ */
+static bool hb_mc_device_pod_dma_sweeps(hb_mc_device_t *device,
+                                        hb_mc_pod_t *pod,
+                                        const std::vector<hb_mc_eva_t> &evas,
+                                        const std::vector<size_t> &szs)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(device->mc);
+        size_t line = hb_mc_config_get_vcache_block_size(cfg);
+
+        // dram is striped at cache line granularity, so eva lines are npa lines
+        uint64_t lines = 0;
+        for (size_t i = 0; i < evas.size(); i++) {
+                if (szs[i] == 0)
+                        continue;
+                lines += (evas[i] + szs[i] - 1) / line - evas[i] / line + 1;
+        }
+
+        if (lines > pod->dma_stats.sweep_threshold) {
+                pod->dma_stats.swept_batches++;
+                return true;
+        }
+
+        pod->dma_stats.targeted_batches++;
+        pod->dma_stats.targeted_lines += lines;
+        return false;
+}
+
+/**
+ * Flushes or invalidates the victim cache lines touched by a DMA batch.
+ * A flush reads back from each cache it touched before returning, so the
+ * dirty lines are in DRAM when the DMA starts. Callers that write DRAM
+ * flush before the DMA and invalidate after it, so a line re-cached by a
+ * running kernel in between is dropped as well.
+ * @param[in]  device        Pointer to device
+ * @param[in]  pod           Pod the jobs target
+ * @param[in]  evas          Device address of each job
+ * @param[in]  szs           Size of each job in bytes
+ * @param[in]  sweep         Sweep every vcache in the pod, as decided by hb_mc_device_pod_dma_sweeps()
+ * @param[in]  cache_op      HB_MC_PACKET_CACHE_OP_AFL or HB_MC_PACKET_CACHE_OP_AINV
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+static int hb_mc_device_pod_dma_vcache_op(hb_mc_device_t *device,
+                                          hb_mc_pod_t *pod,
+                                          const std::vector<hb_mc_eva_t> &evas,
+                                          const std::vector<size_t> &szs,
+                                          bool sweep,
+                                          hb_mc_packet_cache_op_t cache_op)
+{
+        if (sweep) {
+                if (cache_op == HB_MC_PACKET_CACHE_OP_AINV)
+                        return hb_mc_manycore_pod_invalidate_vcache(device->mc, pod->pod_coord);
+
+                return hb_mc_manycore_pod_flush_vcache(device->mc, pod->pod_coord);
+        }
+
+        return hb_mc_manycore_eva_vcache_op(device->mc, &default_map, &pod->mesh->origin,
+                                            evas.data(), szs.data(), evas.size(),
+                                            cache_op);
+}
+
+
 int hb_mc_device_pod_dma_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod_id, const hb_mc_dma_htod_t *jobs, size_t count)
 {
         int err;
@@ -2104,8 +3750,17 @@ int hb_mc_device_pod_dma_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod_id
 
         hb_mc_pod_t *pod = &device->pods[pod_id];
 
-        // flush cache
-        err = hb_mc_manycore_pod_flush_vcache(device->mc, pod->pod_coord);
+        // flush only the lines the jobs overwrite
+        std::vector<hb_mc_eva_t> evas(count);
+        std::vector<size_t> szs(count);
+        for (size_t i = 0; i < count; i++) {
+                evas[i] = jobs[i].d_addr;
+                szs[i] = jobs[i].size;
+        }
+
+        bool sweep = hb_mc_device_pod_dma_sweeps(device, pod, evas, szs);
+        err = hb_mc_device_pod_dma_vcache_op(device, pod, evas, szs, sweep,
+                                             HB_MC_PACKET_CACHE_OP_AFL);
         if (err != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to flush victim cache: %s\n",
                            __func__,
@@ -2135,9 +3790,13 @@ int hb_mc_device_pod_dma_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod_id
                 }
         }
 
-        // invalidate cache
-        err = hb_mc_manycore_pod_invalidate_vcache(device->mc, pod->pod_coord);
+        // invalidate the same lines
+        err = hb_mc_device_pod_dma_vcache_op(device, pod, evas, szs, sweep,
+                                             HB_MC_PACKET_CACHE_OP_AINV);
         if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to invalidate victim cache: %s\n",
+                           __func__,
+                           hb_mc_strerror(err));
                 return err;
         }
 
@@ -2153,9 +3812,18 @@ int hb_mc_device_pod_dma_to_host(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
         if (!hb_mc_manycore_supports_dma_read(device->mc))
                 return HB_MC_NOIMPL;
 
-        // flush cache
+        // flush only the lines the jobs read
         hb_mc_pod_t *pod = &device->pods[pod_id];
-        err = hb_mc_manycore_pod_flush_vcache(device->mc, pod->pod_coord);
+        std::vector<hb_mc_eva_t> evas(count);
+        std::vector<size_t> szs(count);
+        for (size_t i = 0; i < count; i++) {
+                evas[i] = jobs[i].d_addr;
+                szs[i] = jobs[i].size;
+        }
+
+        bool sweep = hb_mc_device_pod_dma_sweeps(device, pod, evas, szs);
+        err = hb_mc_device_pod_dma_vcache_op(device, pod, evas, szs, sweep,
+                                             HB_MC_PACKET_CACHE_OP_AFL);
         if (err != HB_MC_SUCCESS) {
                 bsg_pr_err("%s: failed to flush victim cache: %s\n",
                            __func__,
@@ -2189,6 +3857,23 @@ int hb_mc_device_pod_dma_to_host(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
 }
 
 
+int hb_mc_device_pod_dma_stats(hb_mc_device_t *device, hb_mc_pod_id_t pod_id, hb_mc_dma_stats_t *stats)
+{
+        CHECK_POD_ID(device, pod_id);
+        CHECK_PTR(stats);
+        *stats = device->pods[pod_id].dma_stats;
+        return HB_MC_SUCCESS;
+}
+
+
+int hb_mc_device_pod_set_dma_sweep_threshold(hb_mc_device_t *device, hb_mc_pod_id_t pod_id, uint32_t lines)
+{
+        CHECK_POD_ID(device, pod_id);
+        device->pods[pod_id].dma_stats.sweep_threshold = lines;
+        return HB_MC_SUCCESS;
+}
+
+
 /**
  * Copy data using DMA from the host to the device.
  * @param[in] device  Pointer to device
@@ -2213,6 +3898,271 @@ int hb_mc_device_dma_to_host(hb_mc_device_t *device, const hb_mc_dma_dtoh_t *job
         return hb_mc_device_pod_dma_to_host(device, device->default_pod_id, jobs, count);
 }
 
+/**
+ * Copy a host file into device DRAM using DMA. The file is mapped,
+ * not read, and placed with the same striping as hb_mc_device_pod_dma_to_device().
+ * @param[in]  device  Pointer to device
+ * @param[in]  pod_id  Pod ID
+ * @param[in]  d_addr  Target EVA on the manycore - must map to DRAM
+ * @param[in]  path    Path to the file
+ * @param[out] size    Size of the file in bytes. May be NULL.
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_dma_file_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
+                                        hb_mc_eva_t d_addr, const char *path, size_t *size)
+{
+        CHECK_POD_ID(device, pod_id);
+        CHECK_PTR(path);
+
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+                bsg_pr_err("%s: failed to open '%s': %m\n", __func__, path);
+                return HB_MC_FAIL;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+                bsg_pr_err("%s: failed to stat '%s': %m\n", __func__, path);
+                close(fd);
+                return HB_MC_FAIL;
+        }
+
+        int err = HB_MC_SUCCESS;
+        size_t sz = st.st_size;
+        if (sz > 0) {
+                void *data = mmap(nullptr, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data == MAP_FAILED) {
+                        bsg_pr_err("%s: failed to map '%s': %m\n", __func__, path);
+                        close(fd);
+                        return HB_MC_FAIL;
+                }
+
+                hb_mc_dma_htod_t job = { d_addr, data, sz };
+                err = hb_mc_device_pod_dma_to_device(device, pod_id, &job, 1);
+                munmap(data, sz);
+        }
+        close(fd);
+
+        if (err == HB_MC_SUCCESS && size != nullptr)
+                *size = sz;
+
+        return err;
+}
+
+/**
+ * Copy a range of device DRAM into a host file using DMA. The file is
+ * created or truncated to #size bytes and mapped, not written.
+ * @param[in]  device  Pointer to device
+ * @param[in]  pod_id  Pod ID
+ * @param[in]  d_addr  Source EVA on the manycore - must map to DRAM
+ * @param[in]  size    Size of the range in bytes
+ * @param[in]  path    Path to the file
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_pod_dma_device_to_file(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
+                                        hb_mc_eva_t d_addr, size_t size, const char *path)
+{
+        CHECK_POD_ID(device, pod_id);
+        CHECK_PTR(path);
+
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+                bsg_pr_err("%s: failed to open '%s': %m\n", __func__, path);
+                return HB_MC_FAIL;
+        }
+
+        if (ftruncate(fd, size) != 0) {
+                bsg_pr_err("%s: failed to resize '%s': %m\n", __func__, path);
+                close(fd);
+                return HB_MC_FAIL;
+        }
+
+        int err = HB_MC_SUCCESS;
+        if (size > 0) {
+                void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (data == MAP_FAILED) {
+                        bsg_pr_err("%s: failed to map '%s': %m\n", __func__, path);
+                        close(fd);
+                        return HB_MC_FAIL;
+                }
+
+                hb_mc_dma_dtoh_t job = { d_addr, data, size };
+                err = hb_mc_device_pod_dma_to_host(device, pod_id, &job, 1);
+                munmap(data, size);
+        }
+
+        if (close(fd) != 0 && err == HB_MC_SUCCESS) {
+                bsg_pr_err("%s: failed to close '%s': %m\n", __func__, path);
+                err = HB_MC_FAIL;
+        }
+
+        return err;
+}
+
+/**
+ * Copy a host file into device DRAM using DMA.
+ * @param[in]  device  Pointer to device
+ * @param[in]  d_addr  Target EVA on the manycore - must map to DRAM
+ * @param[in]  path    Path to the file
+ * @param[out] size    Size of the file in bytes. May be NULL.
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_dma_file_to_device(hb_mc_device_t *device, hb_mc_eva_t d_addr,
+                                    const char *path, size_t *size)
+{
+        return hb_mc_device_pod_dma_file_to_device(device, device->default_pod_id, d_addr, path, size);
+}
+
+/**
+ * Copy a range of device DRAM into a host file using DMA.
+ * @param[in]  device  Pointer to device
+ * @param[in]  d_addr  Source EVA on the manycore - must map to DRAM
+ * @param[in]  size    Size of the range in bytes
+ * @param[in]  path    Path to the file
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+__attribute__((weak))
+int hb_mc_device_dma_device_to_file(hb_mc_device_t *device, hb_mc_eva_t d_addr,
+                                    size_t size, const char *path)
+{
+        return hb_mc_device_pod_dma_device_to_file(device, device->default_pod_id, d_addr, size, path);
+}
+
+/**
+ * Parse one comma-separated entry of a DMA file list: up to #nums
+ * colon-terminated numbers, then a file name.
+ * @return A pointer past the entry, or nullptr if it is malformed.
+ */
+static const char *hb_mc_device_dma_file_entry(const char *spec, unsigned long *vals,
+                                               int nums, std::string *path)
+{
+        for (int i = 0; i < nums; i++) {
+                char *end;
+                vals[i] = strtoul(spec, &end, 0);
+                if (end == spec || *end != ':')
+                        return nullptr;
+                spec = end + 1;
+        }
+
+        const char *end = strchr(spec, ',');
+        if (end == nullptr)
+                end = spec + strlen(spec);
+        if (end == spec)
+                return nullptr;
+
+        path->assign(spec, end - spec);
+        return *end == ',' ? end + 1 : end;
+}
+
+/**
+ * Copy host files into device DRAM using DMA.
+ * @param[in]  device  Pointer to device
+ * @param[in]  pod_id  Pod ID
+ * @param[in]  files   Comma-separated EVA:FILE entries. May be NULL.
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+static int hb_mc_device_pod_dma_load_files(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
+                                           const char *files)
+{
+        while (files != nullptr && *files != '\0') {
+                unsigned long eva;
+                std::string path;
+                const char *next = hb_mc_device_dma_file_entry(files, &eva, 1, &path);
+                if (next == nullptr) {
+                        bsg_pr_err("%s: expected EVA:FILE, got '%s'\n", __func__, files);
+                        return HB_MC_INVALID;
+                }
+
+                size_t size;
+                int err = hb_mc_device_pod_dma_file_to_device(device, pod_id, eva, path.c_str(), &size);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+
+                bsg_pr_info("Loaded %zu bytes from '%s' to EVA 0x%08lx\n", size, path.c_str(), eva);
+                files = next;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Copy ranges of device DRAM into host files using DMA.
+ * @param[in]  device  Pointer to device
+ * @param[in]  pod_id  Pod ID
+ * @param[in]  files   Comma-separated EVA:SIZE:FILE entries. May be NULL.
+ * @param[in]  suffix  Appended to every file name
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+static int hb_mc_device_pod_dma_dump_files(hb_mc_device_t *device, hb_mc_pod_id_t pod_id,
+                                           const char *files, const char *suffix)
+{
+        while (files != nullptr && *files != '\0') {
+                unsigned long vals[2];
+                std::string path;
+                const char *next = hb_mc_device_dma_file_entry(files, vals, 2, &path);
+                if (next == nullptr) {
+                        bsg_pr_err("%s: expected EVA:SIZE:FILE, got '%s'\n", __func__, files);
+                        return HB_MC_INVALID;
+                }
+                path += suffix;
+
+                int err = hb_mc_device_pod_dma_device_to_file(device, pod_id, vals[0], vals[1], path.c_str());
+                if (err != HB_MC_SUCCESS)
+                        return err;
+
+                bsg_pr_info("Dumped %lu bytes from EVA 0x%08lx to '%s'\n", vals[1], vals[0], path.c_str());
+                files = next;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Copy host files into device DRAM using DMA.
+ * @param[in]  device  Pointer to device
+ * @param[in]  files   Comma-separated EVA:FILE entries. May be NULL.
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_dma_load_files(hb_mc_device_t *device, const char *files)
+{
+        return hb_mc_device_pod_dma_load_files(device, device->default_pod_id, files);
+}
+
+/**
+ * Copy ranges of device DRAM into host files using DMA.
+ * @param[in]  device  Pointer to device
+ * @param[in]  files   Comma-separated EVA:SIZE:FILE entries. May be NULL.
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_device_dma_dump_files(hb_mc_device_t *device, const char *files)
+{
+        return hb_mc_device_pod_dma_dump_files(device, device->default_pod_id, files, "");
+}
+
+/**
+ * Copy the device's load files into a pod's DRAM.
+ */
+static int hb_mc_device_pod_dram_files_load(hb_mc_device_t *device, hb_mc_pod_t *pod)
+{
+        return hb_mc_device_pod_dma_load_files(device, hb_mc_device_pod_to_pod_id(device, pod),
+                                               device->dram_load);
+}
+
+/**
+ * Copy the device's dump ranges of a pod's DRAM into files,
+ * named per pod when there is more than one.
+ */
+static int hb_mc_device_pod_dram_files_dump(hb_mc_device_t *device, hb_mc_pod_t *pod)
+{
+        hb_mc_pod_id_t pod_id = hb_mc_device_pod_to_pod_id(device, pod);
+        std::string suffix;
+        if (device->num_pods > 1)
+                suffix = ".pod" + std::to_string(pod_id);
+
+        return hb_mc_device_pod_dma_dump_files(device, pod_id, device->dram_dump, suffix.c_str());
+}
+
 /**
  * Frees memory on device DRAM
  * hb_mc_device_program_init() or hb_mc_device_program_init_binary() should
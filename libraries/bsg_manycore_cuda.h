@@ -29,6 +29,9 @@
 #define BSG_MANYCORE_CUDA_H
 #include <bsg_manycore_features.h>
 #include <bsg_manycore_eva.h>
+#include <bsg_manycore_loader.h>
+#include <bsg_manycore_tile_allocator.h>
+#include <bsg_manycore_segfit_allocator.h>
 
 #ifdef __cplusplus
 #include <cstdint>
@@ -48,10 +51,69 @@ extern "C" {
         // The begining of section in host memory intended for tile groups to write finish signals into.
 #define HB_MC_CUDA_HOST_FINISH_SIGNAL_BASE_ADDR 0xF000  
 
+        // Programs that define this symbol opt in to the launch descriptor ABI:
+        // instead of writing each configuration and runtime symbol separately,
+        // the host writes one hb_mc_cuda_launch_desc_t into the symbol on each tile.
+#define HB_MC_CUDA_LAUNCH_DESC_SYMBOL           "__cuda_launch_desc"
+
+        /**
+         * Per-tile launch descriptor. The layout is shared with the kernel
+         * runtime and must only ever be extended at the end.
+         */
+        typedef struct {
+                uint32_t grp_org_x;             // __bsg_grp_org_x
+                uint32_t grp_org_y;             // __bsg_grp_org_y
+                uint32_t x;                     // __bsg_x
+                uint32_t y;                     // __bsg_y
+                uint32_t id;                    // __bsg_id
+                uint32_t tile_group_id_x;       // __bsg_tile_group_id_x
+                uint32_t tile_group_id_y;       // __bsg_tile_group_id_y
+                uint32_t tile_group_id;         // __bsg_tile_group_id
+                uint32_t grid_dim_x;            // __bsg_grid_dim_x
+                uint32_t grid_dim_y;            // __bsg_grid_dim_y
+                uint32_t finish_signal_val;     // cuda_finish_signal_val
+                uint32_t kernel_not_loaded_val; // cuda_kernel_not_loaded_val
+                uint32_t argc;                  // cuda_argc
+                uint32_t argv_ptr;              // cuda_argv_ptr
+                uint32_t finish_signal_addr;    // cuda_finish_signal_addr
+                uint32_t barrier_cfg;           // __cuda_barrier_cfg
+        } hb_mc_cuda_launch_desc_t;
+
+        // Persistent dispatchers store a descriptor's sequence number here when they finish it.
+#define HB_MC_CUDA_HOST_WORK_DONE_ADDR          0xE000
+        // The most kernel arguments a work descriptor can carry (one per argument register).
+#define HB_MC_CUDA_WORK_MAX_ARGS                8
+
+        /**
+         * A unit of work for a persistent dispatcher. The layout is shared
+         * with the dispatcher running on the tiles.
+         *
+         * Descriptor n lives in slot n % capacity and is valid once seq
+         * equals n + 1; the host writes seq last. A kernel_ptr of zero
+         * tells the dispatcher to return.
+         */
+        typedef struct {
+                uint32_t kernel_ptr;                         // EVA of the kernel function
+                uint32_t argc;
+                uint32_t argv[HB_MC_CUDA_WORK_MAX_ARGS];
+                uint32_t seq;
+                uint32_t reserved;
+        } hb_mc_cuda_work_desc_t;
+
+        /**
+         * The header of a work queue in device DRAM. An array of
+         * capacity hb_mc_cuda_work_desc_t follows it.
+         */
+        typedef struct {
+                uint32_t capacity;                           // number of descriptor slots
+                uint32_t done_addr;                          // EVA of HB_MC_CUDA_HOST_WORK_DONE_ADDR on the host
+                uint32_t reserved[2];
+        } hb_mc_cuda_work_queue_t;
+
 
 
-        typedef uint8_t tile_group_id_t;
-        typedef uint8_t grid_id_t;
+        typedef uint32_t tile_group_id_t;
+        typedef uint32_t grid_id_t;
         typedef int hb_mc_allocator_id_t;
 
 
@@ -81,6 +143,8 @@ extern "C" {
                 uint32_t        argc;
                 const uint32_t *argv;
                 int             refcount;
+                int            *finished; // if not NULL, set to 1 when the last tile group finishes
+                hb_mc_eva_t     argv_eva; // device copy of argv shared by all tile groups, 0 until first launch
         } hb_mc_kernel_t;
 
         typedef struct {
@@ -102,13 +166,14 @@ extern "C" {
                 hb_mc_dimension_t dim;
                 hb_mc_coordinate_t origin;
                 hb_mc_tile_t* tiles;
+                hb_mc_tile_allocator_t tile_allocator;
         } hb_mc_mesh_t;
 
 
         typedef struct {
                 hb_mc_allocator_id_t id;
                 const char *name; 
-                void *memory_manager;
+                hb_mc_segfit_allocator_t *memory_manager;
         } hb_mc_allocator_t;
 
 
@@ -127,20 +192,46 @@ extern "C" {
                 const char* bin_name;
                 const unsigned char* bin;
                 size_t bin_size;
+                hb_mc_loader_symbol_index_t *symbols;
                 hb_mc_allocator_t *allocator;
         } hb_mc_program_t;
 
         typedef int hb_mc_pod_id_t;
 
+        typedef struct hb_mc_stream hb_mc_stream_t;
+        typedef struct hb_mc_event  hb_mc_event_t;
+        typedef struct hb_mc_persistent hb_mc_persistent_t;
+        typedef struct hb_mc_barcfg hb_mc_barcfg_t;
+
+        typedef struct {
+                uint32_t sweep_threshold;  // sweep the whole pod when a DMA batch touches more cache lines than this
+                uint64_t targeted_batches; // batches maintained line by line
+                uint64_t targeted_lines;   // cache lines maintained by targeted batches
+                uint64_t swept_batches;    // batches that fell back to a whole-pod sweep
+        } hb_mc_dma_stats_t;
+
         typedef struct {
                 hb_mc_program_t    *program;
                 hb_mc_mesh_t       *mesh;
-                hb_mc_tile_group_t *tile_groups;
-                uint32_t            num_tile_groups;
+                hb_mc_tile_group_t *tile_groups;              // tile group slots, recycled when a group finishes
+                uint32_t            num_tile_groups;          // slots that have ever been used
                 uint32_t            tile_group_capacity;
-                uint8_t             num_grids;
+                uint32_t           *free_tile_groups;         // stack of finished slots ready for reuse
+                uint32_t            num_free_tile_groups;
+                uint32_t           *pending_tile_groups;      // ring of slots waiting to launch, in enqueue order
+                uint32_t            pending_head;
+                uint32_t            num_tile_groups_pending;  // enqueued but not yet launched
+                uint32_t            num_tile_groups_launched; // launched and not yet finished
+                uint32_t            num_tile_groups_finished;
+                uint32_t           *launched_tile_groups;     // slot of the launched tile group at each origin tile
+                grid_id_t           num_grids;
+                hb_mc_stream_t     *streams;                  // streams created on this pod
+                hb_mc_persistent_t *persistent;               // running persistent dispatcher, if any
+                hb_mc_barcfg_t     *barcfgs;                  // hw barrier config buffers pooled by tile group shape
+                int                 uses_hw_barrier;          // -1 until the program is checked for __cuda_barrier_cfg
                 hb_mc_coordinate_t  pod_coord; // what pod am I in the global manycore?
                 int                 program_loaded;
+                hb_mc_dma_stats_t   dma_stats;                // vcache maintenance done by DMA on this pod
         } hb_mc_pod_t;
 
         typedef struct {
@@ -150,6 +241,8 @@ extern "C" {
                 const char       *name;
                 hb_mc_pod_id_t    default_pod_id;
                 hb_mc_dimension_t default_mesh_dim;
+                char             *dram_load; // EVA:FILE[,...] loaded into each pod with its program, or NULL
+                char             *dram_dump; // EVA:SIZE:FILE[,...] dumped when each pod's program finishes, or NULL
         } hb_mc_device_t; 
 
 
@@ -272,6 +365,36 @@ extern "C" {
                                   hb_mc_pod_id_t  pod,
                                   hb_mc_eva_t     eva);
 
+        /**
+         * Resizes memory on device's DRAM associated with the input pod
+         * The block grows or shrinks in place when it can. Otherwise a new
+         * block is allocated, the contents are copied and the old block is freed.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID with a prorgam initialized
+         * @param[in]  eva           Eva address of memory returned by hb_mc_device_pod_malloc()
+         * @param[in]  size          New size of the memory
+         * @param[out] new_eva       Eva address of the resized memory
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_realloc(hb_mc_device_t *device,
+                                     hb_mc_pod_id_t  pod,
+                                     hb_mc_eva_t     eva,
+                                     uint32_t        size,
+                                     hb_mc_eva_t    *new_eva);
+
+        /**
+         * Gets statistics of the DRAM allocator of the input pod
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID with a prorgam initialized
+         * @param[out] stats         Allocator statistics
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_malloc_stats(hb_mc_device_t *device,
+                                          hb_mc_pod_id_t  pod,
+                                          hb_mc_segfit_stats_t *stats);
+
         /*******************************/
         /* Pod Interface Data Movement */
         /*******************************/
@@ -704,6 +827,73 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_device_dma_to_host(hb_mc_device_t *device, const hb_mc_dma_dtoh_t *jobs, size_t count);
 
+        /**
+         * Copy a host file into device DRAM using DMA. The file is mapped,
+         * not read, and placed with the same striping as hb_mc_device_dma_to_device().
+         * @param[in]  device  Pointer to device
+         * @param[in]  d_addr  Target EVA on the manycore - must map to DRAM
+         * @param[in]  path    Path to the file
+         * @param[out] size    Size of the file in bytes. May be NULL.
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_dma_file_to_device(hb_mc_device_t *device, hb_mc_eva_t d_addr,
+                                            const char *path, size_t *size);
+
+        /**
+         * Copy a range of device DRAM into a host file using DMA, for
+         * offline comparison against a golden file.
+         * @param[in]  device  Pointer to device
+         * @param[in]  d_addr  Source EVA on the manycore - must map to DRAM
+         * @param[in]  size    Size of the range in bytes
+         * @param[in]  path    Path to the file, which is created or truncated
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_dma_device_to_file(hb_mc_device_t *device, hb_mc_eva_t d_addr,
+                                            size_t size, const char *path);
+
+        /**
+         * Copy host files into device DRAM using DMA.
+         * @param[in]  device  Pointer to device
+         * @param[in]  files   Comma-separated EVA:FILE entries (e.g. --dram-load). May be NULL.
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_dma_load_files(hb_mc_device_t *device, const char *files);
+
+        /**
+         * Copy ranges of device DRAM into host files using DMA.
+         * @param[in]  device  Pointer to device
+         * @param[in]  files   Comma-separated EVA:SIZE:FILE entries (e.g. --dram-dump). May be NULL.
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_dma_dump_files(hb_mc_device_t *device, const char *files);
+
+        /**
+         * Set the DRAM files of a device. Each pod copies #load into its DRAM
+         * as soon as a program is loaded on it, and copies the #dump ranges
+         * into files when its program finishes. With more than one pod, each
+         * dump file name is suffixed with .pod<N>, where N is the pod ID.
+         * @param[in]  device  Pointer to device
+         * @param[in]  load    Comma-separated EVA:FILE entries, or NULL
+         * @param[in]  dump    Comma-separated EVA:SIZE:FILE entries, or NULL
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_set_dram_files(hb_mc_device_t *device, const char *load, const char *dump);
+
+        /**
+         * Make the next hb_mc_device_init() in this process set the DRAM
+         * files of its device (see hb_mc_device_set_dram_files()). Later
+         * inits are not affected. Regression programs set this from
+         * --dram-load and --dram-dump.
+         * @param[in]  load    Comma-separated EVA:FILE entries, or NULL
+         * @param[in]  dump    Comma-separated EVA:SIZE:FILE entries, or NULL
+         */
+        void hb_mc_device_init_dram_files(const char *load, const char *dump);
+
 
         /*********************/
         /* Pod Interface DMA */
@@ -714,6 +904,274 @@ extern "C" {
         __attribute__((warn_unused_result))
         int hb_mc_device_pod_dma_to_host(hb_mc_device_t *device, hb_mc_pod_id_t pod, const hb_mc_dma_dtoh_t *jobs, size_t count);
 
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_dma_file_to_device(hb_mc_device_t *device, hb_mc_pod_id_t pod,
+                                                hb_mc_eva_t d_addr, const char *path, size_t *size);
+
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_dma_device_to_file(hb_mc_device_t *device, hb_mc_pod_id_t pod,
+                                                hb_mc_eva_t d_addr, size_t size, const char *path);
+
+        /**
+         * Gets the vcache maintenance statistics of DMA on the input pod.
+         * Each DMA batch flushes or invalidates only the cache lines its jobs
+         * touch, unless they exceed the sweep threshold.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID
+         * @param[out] stats         DMA statistics
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_dma_stats(hb_mc_device_t *device, hb_mc_pod_id_t pod, hb_mc_dma_stats_t *stats);
+
+        /**
+         * Sets the number of cache lines a DMA batch may touch before it
+         * sweeps every victim cache of the pod instead.
+         * @param[in]  device        Pointer to device
+         * @param[in]  pod           Pod ID
+         * @param[in]  lines         Sweep threshold in cache lines
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_set_dma_sweep_threshold(hb_mc_device_t *device, hb_mc_pod_id_t pod, uint32_t lines);
+
+
+        /**********************/
+        /* Streams and Events */
+        /**********************/
+        /*
+         * A stream is an ordered queue of copies, kernels and events on a pod.
+         * Each operation starts once the one before it in the same stream has
+         * completed; operations in different streams run independently. The
+         * host copies data for one stream while tile groups from another
+         * stream are running.
+         *
+         * Streams make progress whenever the host synchronizes with or
+         * queries a stream or event on the pod, using the same finish-packet
+         * loop as hb_mc_device_pod_kernels_execute().
+         */
+
+        /**
+         * Create a stream on a pod.
+         * The pod must have a program loaded.
+         * @param[in]  device  Pointer to device
+         * @param[in]  pod_id  Pod ID
+         * @param[out] stream  The new stream
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_stream_create(hb_mc_device_t *device,
+                                           hb_mc_pod_id_t pod_id,
+                                           hb_mc_stream_t **stream);
+
+        /**
+         * Create a stream on the default pod.
+         * @param[in]  device  Pointer to device
+         * @param[out] stream  The new stream
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_stream_create(hb_mc_device_t *device, hb_mc_stream_t **stream);
+
+        /**
+         * Wait for all work in a stream to complete and destroy it.
+         * @param[in] stream  A stream created with hb_mc_stream_create()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_stream_destroy(hb_mc_stream_t *stream);
+
+        /**
+         * Enqueue a copy between the host and device DRAM on a stream.
+         * The host buffer must stay valid until the copy completes.
+         * @param[in] stream  A stream created with hb_mc_stream_create()
+         * @param[in] dst     Destination (EVA for HB_MC_MEMCPY_TO_DEVICE, host pointer otherwise)
+         * @param[in] src     Source (host pointer for HB_MC_MEMCPY_TO_DEVICE, EVA otherwise)
+         * @param[in] count   Size of buffer (number of bytes) to be copied
+         * @param[in] kind    Direction of copy (HB_MC_MEMCPY_TO_DEVICE / HB_MC_MEMCPY_TO_HOST)
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_stream_memcpy_async(hb_mc_stream_t *stream,
+                                      void *dst,
+                                      const void *src,
+                                      uint32_t count,
+                                      enum hb_mc_memcpy_kind kind);
+
+        /**
+         * Enqueue a kernel on a stream.
+         * Its tile groups are scheduled once all earlier work in the stream has completed.
+         * @param[in] stream    A stream created with hb_mc_stream_create()
+         * @param[in] grid_dim  X/Y dimensions of the grid to be initialized
+         * @param[in] tg_dim    X/Y dimensions of tile groups in grid
+         * @param[in] name      Kernel name to be executed on tile groups in grid
+         * @param[in] argc      Number of input arguments to kernel
+         * @param[in] argv      List of input arguments to kernel
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_stream_kernel_enqueue(hb_mc_stream_t *stream,
+                                        hb_mc_dimension_t grid_dim,
+                                        hb_mc_dimension_t tg_dim,
+                                        const char *name,
+                                        uint32_t argc,
+                                        const uint32_t *argv);
+
+        /**
+         * Block until all work in a stream has completed.
+         * @param[in] stream  A stream created with hb_mc_stream_create()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_stream_synchronize(hb_mc_stream_t *stream);
+
+        /**
+         * Make progress on a stream without blocking.
+         * Handles any finish packets that have arrived, so it may be polled in a loop.
+         * @param[in] stream  A stream created with hb_mc_stream_create()
+         * @return HB_MC_SUCCESS if all work in the stream has completed. HB_MC_BUSY if work remains.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_stream_query(hb_mc_stream_t *stream);
+
+        /**
+         * Create an event.
+         * @param[out] event  The new event
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_event_create(hb_mc_event_t **event);
+
+        /**
+         * Destroy an event. The event must not be pending on a stream.
+         * @param[in] event  An event created with hb_mc_event_create()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_event_destroy(hb_mc_event_t *event);
+
+        /**
+         * Record an event on a stream.
+         * The event completes when all work enqueued on the stream before it has completed,
+         * and it records the device cycle counter at that point.
+         * @param[in] event   An event created with hb_mc_event_create()
+         * @param[in] stream  A stream created with hb_mc_stream_create()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_event_record(hb_mc_event_t *event, hb_mc_stream_t *stream);
+
+        /**
+         * Block until an event has completed.
+         * @param[in] event  An event recorded with hb_mc_event_record()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_event_synchronize(hb_mc_event_t *event);
+
+        /**
+         * Make progress on an event's stream without blocking.
+         * Handles any finish packets that have arrived, so it may be polled in a loop.
+         * @param[in] event  An event recorded with hb_mc_event_record()
+         * @return HB_MC_SUCCESS if the event has completed. HB_MC_BUSY if it has not.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_event_query(hb_mc_event_t *event);
+
+        /**
+         * Get the number of device cycles between two completed events.
+         * @param[in]  start   An event that completed first
+         * @param[in]  end     An event that completed later
+         * @param[out] cycles  Cycles from start to end
+         * @return HB_MC_SUCCESS if succesful. HB_MC_BUSY if either event has not completed.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_event_elapsed_cycles(const hb_mc_event_t *start,
+                                       const hb_mc_event_t *end,
+                                       uint64_t *cycles);
+
+
+        /*******************/
+        /* Persistent Mode */
+        /*******************/
+        /*
+         * In persistent mode one tile group stays resident, running a
+         * dispatcher kernel that polls a ring of hb_mc_cuda_work_desc_t in
+         * device DRAM. Each tile calls the kernel named by a descriptor and
+         * fences; the tiles then meet at the tile group barrier, and tile 0
+         * stores the descriptor's sequence number to
+         * hb_mc_cuda_work_queue_t::done_addr. Without the barrier a
+         * multi-tile dispatcher would report a descriptor done while other
+         * tiles are still running it. Launching work costs one
+         * descriptor write instead of per-tile symbol writes, an argv
+         * allocation and a barrier setup.
+         *
+         * The dispatcher is part of the program and must be declared as
+         *   int dispatcher(hb_mc_cuda_work_queue_t *queue);
+         * See examples/cuda/test_persistent_kernel for an implementation.
+         */
+
+        /**
+         * Launch a persistent dispatcher on a pod.
+         * No other tile groups may be waiting to launch on the pod.
+         * @param[in]  device      Pointer to device
+         * @param[in]  pod_id      Pod ID
+         * @param[in]  tg_dim      X/Y dimensions of the dispatcher tile group
+         * @param[in]  dispatcher  Name of the dispatcher kernel
+         * @param[in]  capacity    Number of descriptor slots in the work queue
+         * @param[out] persistent  The running dispatcher
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_device_pod_persistent_start(hb_mc_device_t *device,
+                                              hb_mc_pod_id_t pod_id,
+                                              hb_mc_dimension_t tg_dim,
+                                              const char *dispatcher,
+                                              uint32_t capacity,
+                                              hb_mc_persistent_t **persistent);
+
+        /**
+         * Push a kernel invocation to a persistent dispatcher.
+         * Blocks while the work queue is full.
+         * @param[in]  persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+         * @param[in]  name        Kernel name to be executed
+         * @param[in]  argc        Number of input arguments to kernel (at most HB_MC_CUDA_WORK_MAX_ARGS)
+         * @param[in]  argv        List of input arguments to kernel
+         * @param[out] ticket      Identifies this invocation to hb_mc_persistent_wait(). May be NULL.
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_persistent_push(hb_mc_persistent_t *persistent,
+                                  const char *name,
+                                  uint32_t argc,
+                                  const uint32_t *argv,
+                                  uint32_t *ticket);
+
+        /**
+         * Block until a kernel invocation, and every one pushed before it, has completed.
+         * @param[in] persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+         * @param[in] ticket      A ticket returned by hb_mc_persistent_push()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_persistent_wait(hb_mc_persistent_t *persistent, uint32_t ticket);
+
+        /**
+         * Block until every kernel invocation pushed so far has completed.
+         * @param[in] persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_persistent_synchronize(hb_mc_persistent_t *persistent);
+
+        /**
+         * Wait for all pushed work, stop the dispatcher and free its work queue.
+         * @param[in] persistent  A dispatcher started with hb_mc_device_pod_persistent_start()
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_persistent_stop(hb_mc_persistent_t *persistent);
+
 
         /**
          * Convenience macro for calling a CUDA function and handling an error return code.
@@ -27,7 +27,6 @@
 #define DEBUG
 #include <bsg_manycore_cuda.h>
 #include <bsg_manycore_tile.h>
-#include <bsg_manycore_memory_manager.h>
 #include <bsg_manycore_elf.h>
 #include <bsg_manycore_loader.h>
 #include <bsg_manycore.h>
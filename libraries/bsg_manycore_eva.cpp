@@ -45,6 +45,7 @@
 #ifdef __cplusplus
 #include <cmath>
 #include <climits>
+#include <vector>
 #else
 #include <math.h>
 #include <limits.h>
@@ -1115,6 +1116,93 @@ int hb_mc_manycore_eva_init(hb_mc_manycore_t *mc)
         return default_eva_map_init(&(mc->config));
 }
 
+/**
+ * Translate a contiguous EVA region into the NPA ranges it maps to
+ * @param[in]  mc     An initialized manycore struct
+ * @param[in]  map    An eva map for computing the eva to npa translation
+ * @param[in]  tgt    Coordinate of the tile issuing this #eva
+ * @param[in]  eva    A valid hb_mc_eva_t
+ * @param[in]  sz     The size of the region in bytes
+ * @param[out] ranges Appended with one range per contiguous NPA run, in EVA order
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ *
+ * A DRAM region is split at every stripe.
+ */
+static int hb_mc_manycore_eva_to_npa_ranges(hb_mc_manycore_t *mc,
+                                            const hb_mc_eva_map_t *map,
+                                            const hb_mc_coordinate_t *tgt,
+                                            const hb_mc_eva_t *eva,
+                                            size_t sz,
+                                            std::vector<hb_mc_manycore_npa_range_t> &ranges)
+{
+        int err;
+        size_t npa_sz, xfer_sz;
+        hb_mc_npa_t npa;
+        hb_mc_eva_t curr_eva = *eva;
+
+        while (sz > 0) {
+                err = hb_mc_eva_to_npa(mc, map, tgt, &curr_eva, &npa, &npa_sz);
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
+                                   __func__);
+                        return err;
+                }
+                xfer_sz = min_size_t(sz, npa_sz);
+
+                char npa_str[256];
+                bsg_pr_dbg("eva %08x maps %zd bytes to %s\n",
+                           curr_eva,
+                           xfer_sz,
+                           hb_mc_npa_to_string(&npa, npa_str, sizeof(npa_str)));
+
+                hb_mc_manycore_npa_range_t range = { npa, xfer_sz };
+                ranges.push_back(range);
+
+                sz -= xfer_sz;
+                curr_eva += xfer_sz;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Translate a contiguous EVA region into the NPA segments it maps to
+ * @param[in]  mc     An initialized manycore struct
+ * @param[in]  map    An eva map for computing the eva to npa translation
+ * @param[in]  tgt    Coordinate of the tile issuing this #eva
+ * @param[in]  eva    A valid hb_mc_eva_t
+ * @param[in]  data   The host buffer backing the region
+ * @param[in]  sz     The size of the region in bytes
+ * @param[out] segs   One segment per contiguous NPA run, in EVA order
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ *
+ * Segment is hb_mc_manycore_mem_segment_t or hb_mc_manycore_read_segment_t.
+ */
+template <typename Segment, typename Buffer>
+static int hb_mc_manycore_eva_to_segments(hb_mc_manycore_t *mc,
+                                          const hb_mc_eva_map_t *map,
+                                          const hb_mc_coordinate_t *tgt,
+                                          const hb_mc_eva_t *eva,
+                                          Buffer *data, size_t sz,
+                                          std::vector<Segment> &segs)
+{
+        int err;
+        std::vector<hb_mc_manycore_npa_range_t> ranges;
+        Buffer *bufp = data;
+
+        err = hb_mc_manycore_eva_to_npa_ranges(mc, map, tgt, eva, sz, ranges);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        for (const hb_mc_manycore_npa_range_t &range : ranges) {
+                Segment seg = { range.npa, bufp, range.sz };
+                segs.push_back(seg);
+                bufp += range.sz;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Internal function to write memory out to manycore hardware starting at a given EVA
  * @param[in]  mc     An initialized manycore struct
@@ -1136,37 +1224,19 @@ int hb_mc_manycore_eva_write_internal(hb_mc_manycore_t *mc,
                                       WriteFunction write_function)
 {
         int err;
-        size_t dest_sz, xfer_sz;
-        hb_mc_npa_t dest_npa;
-        char *destp;
-        hb_mc_eva_t curr_eva = *eva;
+        std::vector<hb_mc_manycore_mem_segment_t> segs;
 
-        destp = (char *)data;
-        while(sz > 0){
-                err = hb_mc_eva_to_npa(mc, map, tgt, &curr_eva, &dest_npa, &dest_sz);
-                if(err != HB_MC_SUCCESS){
-                        bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
-                                   __func__);
-                        return err;
-                }
-                xfer_sz = min_size_t(sz, dest_sz);
-
-                char npa_str[256];
-                bsg_pr_dbg("writing %zd bytes to eva %08x (%s)\n",
-                           xfer_sz,
-                           curr_eva,
-                           hb_mc_npa_to_string(&dest_npa, npa_str, sizeof(npa_str)));
+        err = hb_mc_manycore_eva_to_segments(mc, map, tgt, eva, (const char *)data, sz, segs);
+        if (err != HB_MC_SUCCESS)
+                return err;
 
-                err = write_function(mc, &dest_npa, destp, xfer_sz);
+        for (const hb_mc_manycore_mem_segment_t &seg : segs) {
+                err = write_function(mc, &seg.npa, seg.data, seg.sz);
                 if(err != HB_MC_SUCCESS){
                         bsg_pr_err("%s: Failed to copy data from host to NPA\n",
                                    __func__);
                         return err;
                 }
-
-                destp += xfer_sz;
-                sz -= xfer_sz;
-                curr_eva += xfer_sz;
         }
 
         return HB_MC_SUCCESS;
@@ -1208,9 +1278,23 @@ int hb_mc_manycore_eva_write(hb_mc_manycore_t *mc,
                              const hb_mc_eva_t *eva,
                              const void *data, size_t sz)
 {
-        // otherwise do write using the manycore mesh network
-        return hb_mc_manycore_eva_write_internal(mc,map, tgt, eva, data, sz,
-                                                 hb_mc_manycore_write_mem);
+        int err;
+
+        // translate the whole range first; a DRAM range is split at every stripe
+        std::vector<hb_mc_manycore_mem_segment_t> segs;
+        err = hb_mc_manycore_eva_to_segments(mc, map, tgt, eva, (const char *)data, sz, segs);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        // then stream every stripe over the mesh network and fence once
+        err = hb_mc_manycore_write_mem_segments(mc, segs.data(), segs.size());
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: Failed to copy data from host to EVA 0x%08" PRIx32 "\n",
+                           __func__, *eva);
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
 }
 
 
@@ -1235,38 +1319,19 @@ int hb_mc_manycore_eva_read_internal(hb_mc_manycore_t *mc,
                                      ReadFunction read_function)
 {
         int err;
-        size_t src_sz, xfer_sz;
-        hb_mc_npa_t src_npa;
-        char *srcp;
-        hb_mc_eva_t curr_eva = *eva;
+        std::vector<hb_mc_manycore_read_segment_t> segs;
 
-        srcp = (char *)data;
-        while(sz > 0){
-                err = hb_mc_eva_to_npa(mc, map, tgt, &curr_eva, &src_npa, &src_sz);
-                if(err != HB_MC_SUCCESS){
-                        bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
-                                   __func__);
-                        return err;
-                }
-
-                xfer_sz = min_size_t(sz, src_sz);
-
-                char npa_str[256];
-                bsg_pr_dbg("read %zd bytes from eva %08x (%s)\n",
-                           xfer_sz,
-                           curr_eva,
-                           hb_mc_npa_to_string(&src_npa, npa_str, sizeof(npa_str)));
+        err = hb_mc_manycore_eva_to_segments(mc, map, tgt, eva, (char *)data, sz, segs);
+        if (err != HB_MC_SUCCESS)
+                return err;
 
-                err = read_function(mc, &src_npa, srcp, xfer_sz);
+        for (const hb_mc_manycore_read_segment_t &seg : segs) {
+                err = read_function(mc, &seg.npa, seg.data, seg.sz);
                 if(err != HB_MC_SUCCESS){
                         bsg_pr_err("%s: Failed to copy data from host to NPA\n",
                                    __func__);
                         return err;
                 }
-
-                srcp += xfer_sz;
-                sz -= xfer_sz;
-                curr_eva += xfer_sz;
         }
 
         return HB_MC_SUCCESS;
@@ -1308,8 +1373,23 @@ int hb_mc_manycore_eva_read(hb_mc_manycore_t *mc,
                             const hb_mc_eva_t *eva,
                             void *data, size_t sz)
 {
-        return hb_mc_manycore_eva_read_internal(mc, map, tgt, eva, data, sz,
-                                                hb_mc_manycore_read_mem);
+        int err;
+
+        // translate the whole range first; a DRAM range is split at every stripe
+        std::vector<hb_mc_manycore_read_segment_t> segs;
+        err = hb_mc_manycore_eva_to_segments(mc, map, tgt, eva, (char *)data, sz, segs);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        // then keep loads in flight across every stripe until the last one returns
+        err = hb_mc_manycore_read_mem_segments(mc, segs.data(), segs.size());
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: Failed to copy data from EVA 0x%08" PRIx32 " to host\n",
+                           __func__, *eva);
+                return err;
+        }
+
+        return HB_MC_SUCCESS;
 }
 
 /**
@@ -1362,3 +1442,124 @@ int hb_mc_manycore_eva_memset(hb_mc_manycore_t *mc,
 
         return HB_MC_SUCCESS;
 }
+
+/**
+ * Apply a cache operation to every victim cache line of a list of EVA ranges.
+ * @param[in]  mc       An initialized manycore struct
+ * @param[in]  map      An eva map for computing the eva to npa translation
+ * @param[in]  tgt      Coordinate of the tile issuing the EVAs
+ * @param[in]  evas     An array of #n valid hb_mc_eva_t - must map to DRAM
+ * @param[in]  szs      An array of #n range sizes in bytes
+ * @param[in]  n        The number of ranges
+ * @param[in]  cache_op HB_MC_PACKET_CACHE_OP_AFL, _AINV, or _AFLINV
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_manycore_eva_vcache_op(hb_mc_manycore_t *mc,
+                                 const hb_mc_eva_map_t *map,
+                                 const hb_mc_coordinate_t *tgt,
+                                 const hb_mc_eva_t *evas, const size_t *szs, size_t n,
+                                 hb_mc_packet_cache_op_t cache_op)
+{
+        int err;
+        std::vector<hb_mc_manycore_npa_range_t> ranges;
+
+        // translate every range
+        for (size_t i = 0; i < n; i++) {
+                err = hb_mc_manycore_eva_to_npa_ranges(mc, map, tgt, &evas[i], szs[i], ranges);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return hb_mc_manycore_vcache_op_npa_ranges(mc, ranges.data(), ranges.size(), cache_op);
+}
+
+/**
+ * Perform a 32-bit atomic memory operation at a given EVA
+ * and return the value held at the EVA before the operation.
+ * @param[in]  mc       An initialized manycore struct
+ * @param[in]  map      An eva map for computing the eva to npa translation
+ * @param[in]  tgt      Coordinate of the tile issuing this #eva
+ * @param[in]  eva      A valid hb_mc_eva_t aligned to a four byte boundary
+ * @param[in]  op       One of HB_MC_PACKET_OP_REMOTE_AMO*
+ * @param[in]  operand  Operand of the AMO
+ * @param[out] old      Set to the value held at #eva before the AMO. May be NULL.
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_manycore_eva_amo32(hb_mc_manycore_t *mc,
+                             const hb_mc_eva_map_t *map,
+                             const hb_mc_coordinate_t *tgt,
+                             const hb_mc_eva_t *eva,
+                             hb_mc_packet_op_t op, uint32_t operand,
+                             uint32_t *old)
+{
+        int err;
+        size_t npa_sz;
+        hb_mc_npa_t npa;
+
+        err = hb_mc_eva_to_npa(mc, map, tgt, eva, &npa, &npa_sz);
+        if (err != HB_MC_SUCCESS) {
+                bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
+                           __func__);
+                return err;
+        }
+
+        if (npa_sz < sizeof(uint32_t)) {
+                bsg_pr_err("%s: EVA 0x%08" PRIx32 " does not map to a full word\n",
+                           __func__, hb_mc_eva_addr(eva));
+                return HB_MC_INVALID;
+        }
+
+        return hb_mc_manycore_amo32(mc, &npa, op, operand, old);
+}
+
+/**
+ * Perform the same 32-bit atomic memory operation at a list of EVAs.
+ * @param[in]  mc       An initialized manycore struct
+ * @param[in]  map      An eva map for computing the eva to npa translation
+ * @param[in]  tgt      Coordinate of the tile issuing the EVAs
+ * @param[in]  evas     An array of valid hb_mc_eva_t aligned to a four byte boundary
+ * @param[in]  n        The number of EVAs in #evas
+ * @param[in]  op       One of HB_MC_PACKET_OP_REMOTE_AMO*
+ * @param[in]  operands An array of #n operands
+ * @param[out] olds     An array of #n words set to the values held before each AMO. May be NULL.
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_manycore_eva_amo32_multi(hb_mc_manycore_t *mc,
+                                   const hb_mc_eva_map_t *map,
+                                   const hb_mc_coordinate_t *tgt,
+                                   const hb_mc_eva_t *evas, size_t n,
+                                   hb_mc_packet_op_t op, const uint32_t *operands,
+                                   uint32_t *olds)
+{
+        int err;
+        size_t npa_sz;
+        std::vector<hb_mc_manycore_amo_t> amos(n);
+
+        for (size_t i = 0; i < n; i++) {
+                err = hb_mc_eva_to_npa(mc, map, tgt, &evas[i], &amos[i].npa, &npa_sz);
+                if (err != HB_MC_SUCCESS) {
+                        bsg_pr_err("%s: Failed to translate EVA into a NPA\n",
+                                   __func__);
+                        return err;
+                }
+
+                if (npa_sz < sizeof(uint32_t)) {
+                        bsg_pr_err("%s: EVA 0x%08" PRIx32 " does not map to a full word\n",
+                                   __func__, hb_mc_eva_addr(&evas[i]));
+                        return HB_MC_INVALID;
+                }
+
+                amos[i].op = op;
+                amos[i].operand = operands[i];
+        }
+
+        err = hb_mc_manycore_amo32_multi(mc, amos.data(), n);
+        if (err != HB_MC_SUCCESS)
+                return err;
+
+        if (olds != nullptr)
+                for (size_t i = 0; i < n; i++)
+                        olds[i] = amos[i].old;
+
+        return HB_MC_SUCCESS;
+}
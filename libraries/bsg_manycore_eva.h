@@ -301,6 +301,66 @@ extern "C" {
                                         const hb_mc_coordinate_t *tgt,
                                         const hb_mc_eva_t *eva,
 					void *data, size_t sz);
+
+        /**
+         * Apply a cache operation to every victim cache line of a list of EVA ranges.
+         * See hb_mc_manycore_vcache_op_npa_ranges().
+         * @param[in]  mc       An initialized manycore struct
+         * @param[in]  map      An eva map for computing the eva to npa translation
+         * @param[in]  tgt      Coordinate of the tile issuing the EVAs
+         * @param[in]  evas     An array of #n valid hb_mc_eva_t - must map to DRAM
+         * @param[in]  szs      An array of #n range sizes in bytes
+         * @param[in]  n        The number of ranges
+         * @param[in]  cache_op HB_MC_PACKET_CACHE_OP_AFL, _AINV, or _AFLINV
+         * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_eva_vcache_op(hb_mc_manycore_t *mc,
+                                         const hb_mc_eva_map_t *map,
+                                         const hb_mc_coordinate_t *tgt,
+                                         const hb_mc_eva_t *evas, const size_t *szs, size_t n,
+                                         hb_mc_packet_cache_op_t cache_op);
+
+        /**
+         * Perform a 32-bit atomic memory operation at a given EVA
+         * and return the value held at the EVA before the operation.
+         * @param[in]  mc       An initialized manycore struct
+         * @param[in]  map      An eva map for computing the eva to npa translation
+         * @param[in]  tgt      Coordinate of the tile issuing this #eva
+         * @param[in]  eva      A valid hb_mc_eva_t aligned to a four byte boundary
+         * @param[in]  op       One of HB_MC_PACKET_OP_REMOTE_AMO*
+         * @param[in]  operand  Operand of the AMO
+         * @param[out] old      Set to the value held at #eva before the AMO. May be NULL.
+         * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_eva_amo32(hb_mc_manycore_t *mc,
+                                     const hb_mc_eva_map_t *map,
+                                     const hb_mc_coordinate_t *tgt,
+                                     const hb_mc_eva_t *eva,
+                                     hb_mc_packet_op_t op, uint32_t operand,
+                                     uint32_t *old);
+
+        /**
+         * Perform the same 32-bit atomic memory operation at a list of EVAs.
+         * The AMOs are pipelined; see hb_mc_manycore_amo32_multi().
+         * @param[in]  mc       An initialized manycore struct
+         * @param[in]  map      An eva map for computing the eva to npa translation
+         * @param[in]  tgt      Coordinate of the tile issuing the EVAs
+         * @param[in]  evas     An array of valid hb_mc_eva_t aligned to a four byte boundary
+         * @param[in]  n        The number of EVAs in #evas
+         * @param[in]  op       One of HB_MC_PACKET_OP_REMOTE_AMO*
+         * @param[in]  operands An array of #n operands
+         * @param[out] olds     An array of #n words set to the values held before each AMO. May be NULL.
+         * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_manycore_eva_amo32_multi(hb_mc_manycore_t *mc,
+                                           const hb_mc_eva_map_t *map,
+                                           const hb_mc_coordinate_t *tgt,
+                                           const hb_mc_eva_t *evas, size_t n,
+                                           hb_mc_packet_op_t op, const uint32_t *operands,
+                                           uint32_t *olds);
 #ifdef __cplusplus
 }
 #endif
@@ -827,6 +827,11 @@ static int hb_mc_loader_tiles_initialize(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+static int hb_mc_loader_load_at(const void *bin, size_t sz, hb_mc_eva_t pc_init,
+                                hb_mc_manycore_t *mc,
+                                const hb_mc_eva_map_t *map,
+                                const hb_mc_coordinate_t *tiles, uint32_t ntiles);
+
 /**
  * Loads an ELF file into a list of tiles and DRAM
  * @param[in]  bin    A memory buffer containing a valid manycore binary
@@ -850,6 +855,27 @@ int hb_mc_loader_load(const void *bin, size_t sz, hb_mc_manycore_t *mc,
                 pc_init = 0;
         }
 
+        return hb_mc_loader_load_at(bin, sz, pc_init, mc, map, tiles, ntiles);
+}
+
+/**
+ * Loads an ELF file into a list of tiles and DRAM, starting execution at pc_init
+ * @param[in]  bin     A memory buffer containing a valid manycore binary
+ * @param[in]  sz      Size of #bin in bytes
+ * @param[in]  pc_init The EVA at which tiles begin execution
+ * @param[in]  mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  map     An eva map for computing the eva to npa translation
+ * @param[in]  tiles   A list of manycore to load with #bin, with the origin at 0
+ * @param[in]  ntiles  The number of tiles in #tiles
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+static int hb_mc_loader_load_at(const void *bin, size_t sz, hb_mc_eva_t pc_init,
+                                hb_mc_manycore_t *mc,
+                                const hb_mc_eva_map_t *map,
+                                const hb_mc_coordinate_t *tiles, uint32_t ntiles)
+{
+        int rc;
+
         if (ntiles < 1)
                 return HB_MC_INVALID;
 
@@ -860,21 +886,32 @@ int hb_mc_loader_load(const void *bin, size_t sz, hb_mc_manycore_t *mc,
                 return rc;
         }
 
-        // Set CSRs
+        // Once the tiles are frozen nothing reads what we write until
+        // the caller unfreezes them: post the segment writes and fence
+        // once at the end
+        rc = hb_mc_manycore_write_begin(mc);
+        if (rc != HB_MC_SUCCESS)
+                return rc;
+
+        // Set CSRs, then fence even inside the session: every freeze
+        // must land before the segments overwrite a running tile's memory
         rc = hb_mc_loader_tiles_initialize(mc, map, pc_init, tiles, ntiles);
         if (rc != HB_MC_SUCCESS) {
                 bsg_pr_dbg("%s: failed to initialize tiles\n", __func__);
-                return rc;
+        } else if ((rc = hb_mc_manycore_host_request_fence(mc, -1)) != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to fence after freezing tiles\n", __func__);
+        } else {
+                // Load segments
+                rc = hb_mc_loader_load_segments(bin, sz, mc, map, tiles, ntiles);
+                if (rc != HB_MC_SUCCESS)
+                        bsg_pr_dbg("%s: failed to load segments\n", __func__);
         }
 
-        // Load segments
-        rc = hb_mc_loader_load_segments(bin, sz, mc, map, tiles, ntiles);
-        if (rc != HB_MC_SUCCESS) {
-                bsg_pr_dbg("%s: failed to load segments\n", __func__);
+        int commit_rc = hb_mc_manycore_write_commit(mc);
+        if (rc != HB_MC_SUCCESS)
                 return rc;
-        }
 
-        return HB_MC_SUCCESS;
+        return commit_rc;
 }
 
 static int hb_mc_loader_get_section(const void *bin, size_t sz, unsigned idx,
@@ -1034,6 +1071,256 @@ int hb_mc_loader_symbol_to_eva(const void *bin, size_t sz, const char *symbol,
         return HB_MC_SUCCESS;
 }
 
+///////////////////////////
+// Program symbol index  //
+///////////////////////////
+
+typedef struct {
+        const char *name; //!< Points into the index's name pool; NULL if the slot is empty
+        uint32_t    hash;
+        hb_mc_eva_t eva;
+} hb_mc_loader_symbol_index_slot_t;
+
+struct hb_mc_loader_symbol_index {
+        hb_mc_loader_symbol_index_slot_t *slots;
+        size_t capacity; //!< Number of slots, always a power of two
+        size_t count;    //!< Number of occupied slots
+        char  *names;    //!< Pool holding a copy of every indexed name
+        size_t names_sz;
+};
+
+/* 32-bit FNV-1a */
+static uint32_t hb_mc_loader_symbol_hash(const char *name)
+{
+        uint32_t hash = 2166136261u;
+        for (const unsigned char *c = (const unsigned char *)name; *c; c++) {
+                hash ^= *c;
+                hash *= 16777619u;
+        }
+        return hash;
+}
+
+/**
+ * Find the slot for a symbol using linear probing.
+ * @return The slot holding #name, or the empty slot where it belongs.
+ */
+static hb_mc_loader_symbol_index_slot_t *
+hb_mc_loader_symbol_index_probe(const hb_mc_loader_symbol_index_t *index,
+                                const char *name, uint32_t hash)
+{
+        size_t mask = index->capacity - 1;
+        for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+                hb_mc_loader_symbol_index_slot_t *slot = &index->slots[i];
+                if (slot->name == NULL)
+                        return slot;
+                if (slot->hash == hash && strcmp(slot->name, name) == 0)
+                        return slot;
+        }
+}
+
+/**
+ * Call a function on every named symbol in every symbol table of a binary.
+ * Symbols are visited in the same order hb_mc_loader_symbol_to_eva() searches them.
+ * @param[in]  bin     A memory buffer containing a valid manycore binary.
+ * @param[in]  sz      Size of #bin in bytes.
+ * @param[in]  visit   Called as visit(name, eva); a non-success return stops the walk.
+ * @return HB_MC_SUCCESS if every symbol was visited. Otherwise an error code is returned.
+ */
+template <typename SymbolFunction>
+static int hb_mc_loader_foreach_symbol(const void *bin, size_t sz, SymbolFunction visit)
+{
+        const Elf32_Ehdr *ehdr = (const Elf32_Ehdr*) bin;
+        const Elf32_Shdr *symtab_shdr, *strtab_shdr;
+        const unsigned char *symtab_data, *strtab_data;
+        int rc;
+
+        for (unsigned idx = 0; idx < RV32_Half_to_host(ehdr->e_shnum); idx++) {
+                rc = hb_mc_loader_get_section(bin, sz, idx, &symtab_shdr, &symtab_data);
+                if (rc != HB_MC_SUCCESS)
+                        return rc;
+
+                if (!hb_mc_loader_section_is_symbol_table(symtab_shdr))
+                        continue;
+
+                unsigned strtab_idx = RV32_Word_to_host(symtab_shdr->sh_link);
+                rc = hb_mc_loader_get_section(bin, sz, strtab_idx, &strtab_shdr, &strtab_data);
+                if (rc != HB_MC_SUCCESS)
+                        return rc;
+
+                const Elf32_Sym *symbol_table = (const Elf32_Sym*)symtab_data;
+                Elf32_Word strtab_sz = RV32_Word_to_host(strtab_shdr->sh_size);
+                Elf32_Word sym_n = RV32_Word_to_host(symtab_shdr->sh_size)/RV32_Word_to_host(symtab_shdr->sh_entsize);
+
+                for (Elf32_Word sym_i = 0; sym_i < sym_n; sym_i++) {
+                        Elf32_Word sym_name_off = RV32_Word_to_host(symbol_table[sym_i].st_name);
+
+                        /* skip symbols with no name */
+                        if (sym_name_off == 0)
+                                continue;
+
+                        /* symbol's name is in bounds and terminated? */
+                        if (sym_name_off >= strtab_sz ||
+                            memchr(&strtab_data[sym_name_off], '\0', strtab_sz - sym_name_off) == NULL)
+                                return HB_MC_INVALID;
+
+                        rc = visit((const char *)&strtab_data[sym_name_off],
+                                   (hb_mc_eva_t)RV32_Addr_to_host(symbol_table[sym_i].st_value));
+                        if (rc != HB_MC_SUCCESS)
+                                return rc;
+                }
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Build an index of all symbols in a program.
+ * The index keeps its own copy of every symbol name, so #bin may be freed afterwards.
+ * @param[in]  bin     A memory buffer containing a valid manycore binary.
+ * @param[in]  sz      Size of #bin in bytes.
+ * @param[out] index   A new symbol index. Free it with hb_mc_loader_symbol_index_exit().
+ * @return HB_MC_SUCCESS if the index was built. Otherwise an error code is returned.
+ */
+int hb_mc_loader_symbol_index_init(const void *bin, size_t sz,
+                                   hb_mc_loader_symbol_index_t **index)
+{
+        hb_mc_loader_symbol_index_t *idx;
+        size_t nsyms = 0, names_sz = 0;
+        int rc;
+
+        if (!index)
+                return HB_MC_INVALID;
+
+        rc = hb_mc_loader_elf_validate(bin, sz);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to validate binary\n", __func__);
+                return rc;
+        }
+
+        /* size the table and the name pool */
+        rc = hb_mc_loader_foreach_symbol(bin, sz, [&](const char *name, hb_mc_eva_t eva) {
+                        nsyms++;
+                        names_sz += strlen(name) + 1;
+                        return HB_MC_SUCCESS;
+                });
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_dbg("%s: failed to read symbol tables: %s\n",
+                           __func__, hb_mc_strerror(rc));
+                return rc;
+        }
+
+        idx = (hb_mc_loader_symbol_index_t *)calloc(1, sizeof(*idx));
+        if (!idx)
+                return HB_MC_NOMEM;
+
+        /* keep the load factor at or below one half */
+        idx->capacity = 16;
+        while (idx->capacity < 2 * nsyms)
+                idx->capacity <<= 1;
+
+        idx->slots = (hb_mc_loader_symbol_index_slot_t *)calloc(idx->capacity, sizeof(*idx->slots));
+        idx->names = (char *)malloc(names_sz > 0 ? names_sz : 1);
+        if (!idx->slots || !idx->names) {
+                hb_mc_loader_symbol_index_exit(idx);
+                return HB_MC_NOMEM;
+        }
+
+        /* the first definition of a name wins, as in a linear search */
+        rc = hb_mc_loader_foreach_symbol(bin, sz, [&](const char *name, hb_mc_eva_t eva) {
+                        uint32_t hash = hb_mc_loader_symbol_hash(name);
+                        hb_mc_loader_symbol_index_slot_t *slot = hb_mc_loader_symbol_index_probe(idx, name, hash);
+                        if (slot->name != NULL)
+                                return HB_MC_SUCCESS;
+
+                        size_t len = strlen(name) + 1;
+                        memcpy(&idx->names[idx->names_sz], name, len);
+                        slot->name = &idx->names[idx->names_sz];
+                        slot->hash = hash;
+                        slot->eva  = eva;
+                        idx->names_sz += len;
+                        idx->count++;
+                        return HB_MC_SUCCESS;
+                });
+        if (rc != HB_MC_SUCCESS) {
+                hb_mc_loader_symbol_index_exit(idx);
+                return rc;
+        }
+
+        bsg_pr_dbg("%s: indexed %zu symbols in %zu slots\n",
+                   __func__, idx->count, idx->capacity);
+
+        *index = idx;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Get an EVA for a symbol from a symbol index.
+ * @param[in]  index   A symbol index built with hb_mc_loader_symbol_index_init().
+ * @param[in]  symbol  A program symbol.
+ * @param[out] eva     An EVA that addresses #symbol.
+ * @return HB_MC_NOTFOUND if #symbol is not in #index. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_loader_symbol_index_to_eva(const hb_mc_loader_symbol_index_t *index,
+                                     const char *symbol, hb_mc_eva_t *eva)
+{
+        if (!index || !symbol || !eva)
+                return HB_MC_INVALID;
+
+        const hb_mc_loader_symbol_index_slot_t *slot =
+                hb_mc_loader_symbol_index_probe(index, symbol, hb_mc_loader_symbol_hash(symbol));
+        if (slot->name == NULL) {
+                bsg_pr_dbg("%s: failed to find symbol '%s'\n", __func__, symbol);
+                return HB_MC_NOTFOUND;
+        }
+
+        *eva = slot->eva;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Free a symbol index.
+ * @param[in]  index   A symbol index built with hb_mc_loader_symbol_index_init().
+ */
+void hb_mc_loader_symbol_index_exit(hb_mc_loader_symbol_index_t *index)
+{
+        if (!index)
+                return;
+
+        free(index->slots);
+        free(index->names);
+        free(index);
+}
+
+/**
+ * Loads an ELF file into a list of tiles and DRAM, using a symbol index
+ * to find the program entry point.
+ * @param[in]  bin    A memory buffer containing a valid manycore binary
+ * @param[in]  sz     Size of #bin in bytes
+ * @param[in]  index  A symbol index built from #bin with hb_mc_loader_symbol_index_init()
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  map    An eva map for computing the eva to npa translation
+ * @param[in]  tiles  A list of manycore to load with #bin, with the origin at 0
+ * @param[in]  ntiles The number of tiles in #tiles
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_loader_load_indexed(const void *bin, size_t sz,
+                              const hb_mc_loader_symbol_index_t *index,
+                              hb_mc_manycore_t *mc,
+                              const hb_mc_eva_map_t *map,
+                              const hb_mc_coordinate_t *tiles, uint32_t ntiles)
+{
+        int rc;
+        hb_mc_eva_t pc_init;
+
+        rc = hb_mc_loader_symbol_index_to_eva(index, "_start", &pc_init);
+        if (rc != HB_MC_SUCCESS) {
+                bsg_pr_warn("%s: failed to find _start symbol. Defaulting to 0\n", __func__);
+                pc_init = 0;
+        }
+
+        return hb_mc_loader_load_at(bin, sz, pc_init, mc, map, tiles, ntiles);
+}
+
 
 
 
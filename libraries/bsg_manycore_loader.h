@@ -66,6 +66,60 @@ extern "C" {
 
 
 
+        /**
+         * An index of the symbols in a program, keyed by name.
+         * Build one with hb_mc_loader_symbol_index_init() when a program
+         * is looked up more than a handful of times.
+         */
+        typedef struct hb_mc_loader_symbol_index hb_mc_loader_symbol_index_t;
+
+        /**
+         * Build an index of all symbols in a program.
+         * The index keeps its own copy of symbol names; #bin may be freed afterwards.
+         * @param[in]  bin     A memory buffer containing a valid manycore binary.
+         * @param[in]  sz      Size of #bin in bytes.
+         * @param[out] index   A new symbol index. Free with hb_mc_loader_symbol_index_exit().
+         * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+         */
+        int hb_mc_loader_symbol_index_init(const void *bin, size_t sz,
+                                           hb_mc_loader_symbol_index_t **index);
+
+        /**
+         * Get an EVA for a symbol from a symbol index.
+         * @param[in]  index   A symbol index built with hb_mc_loader_symbol_index_init().
+         * @param[in]  symbol  A program symbol. Behavior is undefined if #symbol is not a zero terminated string.
+         * @param[out] eva     An EVA that addresses #symbol.
+         * @return HB_MC_NOTFOUND if #symbol is not in the program. HB_MC_SUCCESS otherwise.
+         */
+        int hb_mc_loader_symbol_index_to_eva(const hb_mc_loader_symbol_index_t *index,
+                                             const char *symbol, hb_mc_eva_t *eva);
+
+        /**
+         * Free a symbol index.
+         * @param[in]  index   A symbol index built with hb_mc_loader_symbol_index_init().
+         */
+        void hb_mc_loader_symbol_index_exit(hb_mc_loader_symbol_index_t *index);
+
+        /**
+         * Loads a binary object into a list of tiles and DRAM, using a symbol
+         * index of the binary to find its entry point.
+         * @param[in]  bin    A memory buffer containing a valid manycore binary
+         * @param[in]  sz     Size of #bin in bytes
+         * @param[in]  index  A symbol index built from #bin with hb_mc_loader_symbol_index_init()
+         * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in]  map    An eva map for computing the eva to npa translation
+         * @param[in]  tiles  A list of manycore to load with #bin, with the origin at 0
+         * @param[in]  len    The number of tiles in #tiles
+         * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+         */
+        int hb_mc_loader_load_indexed(const void *bin, size_t sz,
+                                      const hb_mc_loader_symbol_index_t *index,
+                                      hb_mc_manycore_t *mc,
+                                      const hb_mc_eva_map_t *map,
+                                      const hb_mc_coordinate_t *tiles,
+                                      uint32_t len);
+
+
         /**
          * Takes in the path to a binary and loads it into a buffer and sets the binary size. 
          * @param[in]  file_name A memory buffer containing a valid manycore binary.
@@ -1,57 +1,99 @@
-/**
- * Copyright (C) 2015-2018 Xilinx, Inc
- * Author: Sonal Santan
- * Simple usermode XDMA DDR memory manager used by HAL
- * Eventually the common code here will be used by all HAL drivers.
- *
- * Licensed under the Apache License, Version 2.0 (the "License"). You may
- * not use this file except in compliance with the License. A copy of the
- * License is located at
- *
- *     http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
- * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
- * License for the specific language governing permissions and limitations
- * under the License.
- */
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifndef _XDMA_MEMORY_MANAGER_H_
 #define _XDMA_MEMORY_MANAGER_H_
 
+/*
+ * Deprecated: awsbwhal::MemoryManager has been replaced by the
+ * segregated-fit allocator in bsg_manycore_segfit_allocator.h. This
+ * header keeps the old interface for existing code; each call forwards
+ * to hb_mc_segfit_allocator_*. New code should use that API directly.
+ */
+
 #include <bsg_manycore_features.h>
+#include <bsg_manycore_segfit_allocator.h>
 
-#include <mutex>
-#include <list>
-#include "xclhal.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 
 namespace awsbwhal {
         class MemoryManager {
-                #ifdef _MMAN_MUTEX_
-                  std::mutex mMemManagerMutex;
-                #endif
-                std::list<std::pair<uint64_t, uint64_t> > mFreeBufferList;
-                std::list<std::pair<uint64_t, uint64_t> > mBusyBufferList;
+                hb_mc_segfit_allocator_t *mAllocator;
                 const uint64_t mSize;
                 const uint64_t mStart;
                 const uint64_t mAlignment;
-                const unsigned mCoalesceThreshold;
-                uint64_t mFreeSize;
-
-                typedef std::list<std::pair<uint64_t, uint64_t> > PairList;
 
         public:
                 static const uint64_t mNull = 0xffffffffffffffffull;
 
         public:
-                MemoryManager(uint64_t size, uint64_t start, unsigned alignment);
-                ~MemoryManager();
-                uint64_t alloc(size_t size);
-                void free(uint64_t buf);
-                void reset();
-                std::pair<uint64_t, uint64_t>lookup(uint64_t buf);
-                bool reserve(uint64_t base, size_t size);
+                MemoryManager(uint64_t size, uint64_t start, unsigned alignment)
+                        : mAllocator(nullptr), mSize(size), mStart(start), mAlignment(alignment) {
+                        reset();
+                }
+
+                ~MemoryManager() {
+                        hb_mc_segfit_allocator_exit(mAllocator);
+                }
+
+                uint64_t alloc(size_t size) {
+                        uint64_t addr;
+                        if (!mAllocator || hb_mc_segfit_allocator_alloc(mAllocator, size, &addr) != HB_MC_SUCCESS)
+                                return mNull;
+                        return addr;
+                }
+
+                void free(uint64_t buf) {
+                        // unknown addresses were ignored
+                        uint64_t size;
+                        if (mAllocator && hb_mc_segfit_allocator_lookup(mAllocator, buf, &size) == HB_MC_SUCCESS)
+                                (void)hb_mc_segfit_allocator_free(mAllocator, buf);
+                }
+
+                void reset() {
+                        hb_mc_segfit_allocator_exit(mAllocator);
+                        if (hb_mc_segfit_allocator_init(&mAllocator, mStart, mSize, mAlignment) != HB_MC_SUCCESS)
+                                mAllocator = nullptr;
+                }
+
+                std::pair<uint64_t, uint64_t> lookup(uint64_t buf) {
+                        uint64_t size;
+                        if (mAllocator && hb_mc_segfit_allocator_lookup(mAllocator, buf, &size) == HB_MC_SUCCESS)
+                                return std::make_pair(buf, size);
+                        // copy mNull: make_pair would odr-use it without a definition
+                        const uint64_t v = mNull;
+                        return std::make_pair(v, v);
+                }
+
+                bool reserve(uint64_t base, size_t size) {
+                        return mAllocator && hb_mc_segfit_allocator_reserve(mAllocator, base, size) == HB_MC_SUCCESS;
+                }
 
                 uint64_t size() const {
                         return mSize;
@@ -62,17 +104,15 @@ namespace awsbwhal {
                 }
 
                 uint64_t freeSize() const {
-                        return mFreeSize;
+                        hb_mc_segfit_stats_t stats = {};
+                        if (mAllocator)
+                                hb_mc_segfit_allocator_get_stats(mAllocator, &stats);
+                        return stats.bytes_free;
                 }
 
                 static bool isNullAlloc(const std::pair<uint64_t, uint64_t>& buf) {
                         return ((buf.first == mNull) || (buf.second == mNull));
                 }
-
-        private:
-                /* Note that these should be called after acquiring mMemManagerMutex */
-                void coalesce();
-                PairList::iterator find(uint64_t buf);
         };
 }
 
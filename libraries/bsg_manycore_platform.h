@@ -39,7 +39,7 @@ extern "C" {
          * Transmit a request packet to manycore hardware
          * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] request A request packet to transmit to manycore hardware
-         * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
@@ -47,11 +47,27 @@ extern "C" {
                                     hb_mc_fifo_tx_t type,
                                     long timeout);
 
+        /**
+         * Transmit an array of packets to manycore hardware, in order.
+         * Platforms queue as many packets per simulated cycle (or MMIO
+         * vacancy check) as the interface accepts.
+         * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] packets An array of #n packets to transmit to manycore hardware
+         * @param[in] n       The number of packets
+         * @param[in] timeout Retries per packet before HB_MC_TIMEOUT, or -1 to wait forever.
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                          hb_mc_packet_t *packets,
+                                          size_t n,
+                                          hb_mc_fifo_tx_t type,
+                                          long timeout);
+
         /**
          * Receive a packet from manycore hardware
          * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
          * @param[in] response A packet into which data should be read
-         * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
+         * @param[in] timeout  Retries before HB_MC_TIMEOUT, or -1 to wait forever.
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */
         int hb_mc_platform_receive(hb_mc_manycore_t *mc,
@@ -158,6 +174,25 @@ extern "C" {
          * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
          */        
         int hb_mc_platform_wait_reset_done(hb_mc_manycore_t *mc);
+
+        /**
+         * Save the state of the manycore hardware to a checkpoint. The
+         * simulated model is saved to #path and DRAM to #path.dram.
+         * The hardware should be quiescent: fenced, with no kernels running.
+         * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] path  The checkpoint file
+         * @return HB_MC_NOIMPL if the platform cannot checkpoint. HB_MC_SUCCESS on success.
+         */
+        int hb_mc_platform_checkpoint_save(hb_mc_manycore_t *mc, const char *path);
+
+        /**
+         * Replace the state of the manycore hardware with a checkpoint
+         * saved by hb_mc_platform_checkpoint_save().
+         * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] path  The checkpoint file
+         * @return HB_MC_NOIMPL if the platform cannot checkpoint. HB_MC_SUCCESS on success.
+         */
+        int hb_mc_platform_checkpoint_restore(hb_mc_manycore_t *mc, const char *path);
 #ifdef __cplusplus
 }
 #endif
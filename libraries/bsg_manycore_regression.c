@@ -1,4 +1,6 @@
 #include <bsg_manycore_regression.h>
+#include <bsg_manycore.h>
+#include <bsg_manycore_cuda.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
@@ -6,6 +8,7 @@
 #include <float.h>
 #include <argp.h>
 #include <string.h>
+#include <errno.h>
 
 /****************************/
 /* Array comparison helpers */
@@ -161,6 +164,10 @@ static struct argp_option opts_name[] = {
 static struct argp_option opts_path[] = {
         {0, 'n', "NAME", 0, "Name of Manycore Test to Run"},
         {0, 'p', "PATH", 0, "Path to RISC-V Manycore Binary"},
+        {"dram-load", 'l', "EVA:FILE[,...]", 0, "Copy files into device DRAM through the DMA backdoor"},
+        {"dram-dump", 'd', "EVA:SIZE:FILE[,...]", 0, "Copy device DRAM ranges into files through the DMA backdoor"},
+        {"checkpoint-save", 'S', "FILE", 0, "Save a checkpoint once the manycore is initialized"},
+        {"checkpoint-restore", 'R', "FILE", 0, "Initialize the manycore from a saved checkpoint"},
         {0}};
 
 static struct argp_option opts_spmd[] = {
@@ -206,6 +213,22 @@ static error_t parse_name (int key, char *arg, struct argp_state *state){
         return 0;
 }
 
+// Repeated list options accumulate into one comma-separated list,
+// which is always allocated and replaces (and frees) the previous one
+static char *append_list(struct argp_state *state, char *list, char *arg){
+        char *joined;
+        int r;
+
+        if (!list)
+                r = asprintf(&joined, "%s", arg);
+        else
+                r = asprintf(&joined, "%s,%s", list, arg);
+        if (r < 0)
+                argp_failure(state, 1, errno, "Failed to append \"%s\"", arg);
+        free(list);
+        return joined;
+}
+
 static error_t parse_path (int key, char *arg, struct argp_state *state){
         struct arguments_path *args = (struct arguments_path *)state->input;
 
@@ -217,6 +240,18 @@ static error_t parse_path (int key, char *arg, struct argp_state *state){
                 case 'n':
                         args->name = arg;
                         break;
+                case 'l':
+                        args->dram_load = append_list(state, args->dram_load, arg);
+                        break;
+                case 'd':
+                        args->dram_dump = append_list(state, args->dram_dump, arg);
+                        break;
+                case 'S':
+                        args->checkpoint_save = arg;
+                        break;
+                case 'R':
+                        args->checkpoint_restore = arg;
+                        break;
                 case ARGP_KEY_ARG:
                         if (state->arg_num == 0){
                                 args->path = arg;
@@ -238,6 +273,16 @@ static error_t parse_path (int key, char *arg, struct argp_state *state){
                                 bsg_pr_test_err("Test Name not provided!\n");
                                 argp_usage(state);
                         }
+                        if (args->checkpoint_save || args->checkpoint_restore)
+                                hb_mc_manycore_init_checkpoint(args->checkpoint_save,
+                                                               args->checkpoint_restore);
+                        if (args->dram_load || args->dram_dump)
+                                hb_mc_device_init_dram_files(args->dram_load, args->dram_dump);
+                        // the runtime keeps its own copy
+                        free(args->dram_load);
+                        free(args->dram_dump);
+                        args->dram_load = NULL;
+                        args->dram_dump = NULL;
                         break;
                 default:
                         return ARGP_ERR_UNKNOWN;
@@ -98,6 +98,10 @@ extern struct argp argp_path;
 struct arguments_path{
         char *path; // Path to RISC-V Manycore Binary to run
         char *name; // Name of Test to Run
+        char *dram_load; // --dram-load: EVA:FILE[,...], repeatable, passed to hb_mc_device_init_dram_files() and freed
+        char *dram_dump; // --dram-dump: EVA:SIZE:FILE[,...], repeatable, passed to hb_mc_device_init_dram_files() and freed
+        char *checkpoint_save; // --checkpoint-save: see hb_mc_manycore_init_checkpoint()
+        char *checkpoint_restore; // --checkpoint-restore: see hb_mc_manycore_init_checkpoint()
 };
 
 extern struct argp argp_spmd;
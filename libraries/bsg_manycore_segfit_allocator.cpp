@@ -0,0 +1,321 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_segfit_allocator.h>
+#include <bsg_manycore_printing.h>
+
+#include <cinttypes>
+#include <iterator>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+/* One bin per power of two, in units of the alignment */
+#define HB_MC_SEGFIT_NUM_BINS 64
+
+struct hb_mc_segfit_allocator {
+        uint64_t start;
+        uint64_t size;
+        uint64_t alignment;
+        // free blocks by address, for merging with neighbours
+        std::map<uint64_t, uint64_t> free_by_addr;
+        // free blocks by (size, address), one set per size class
+        std::set<std::pair<uint64_t, uint64_t> > bins[HB_MC_SEGFIT_NUM_BINS];
+        // bit i is set if bins[i] is not empty
+        uint64_t nonempty;
+        // allocated blocks by address
+        std::unordered_map<uint64_t, uint64_t> busy;
+        hb_mc_segfit_stats_t stats;
+};
+
+/* The size class of a block: floor(log2(size / alignment)) */
+static unsigned hb_mc_segfit_bin(const hb_mc_segfit_allocator_t *alloc, uint64_t size)
+{
+        return 63 - __builtin_clzll(size / alloc->alignment);
+}
+
+/* Round size up to a non-zero multiple of the alignment */
+static uint64_t hb_mc_segfit_round(const hb_mc_segfit_allocator_t *alloc, uint64_t size)
+{
+        if (size == 0)
+                return alloc->alignment;
+        return (size + alloc->alignment - 1) & ~(alloc->alignment - 1);
+}
+
+static void hb_mc_segfit_insert_free(hb_mc_segfit_allocator_t *alloc, uint64_t addr, uint64_t size)
+{
+        unsigned bin = hb_mc_segfit_bin(alloc, size);
+        alloc->free_by_addr[addr] = size;
+        alloc->bins[bin].insert(std::make_pair(size, addr));
+        alloc->nonempty |= 1ull << bin;
+        alloc->stats.bytes_free += size;
+        alloc->stats.num_free++;
+}
+
+static void hb_mc_segfit_remove_free(hb_mc_segfit_allocator_t *alloc, uint64_t addr, uint64_t size)
+{
+        unsigned bin = hb_mc_segfit_bin(alloc, size);
+        alloc->free_by_addr.erase(addr);
+        alloc->bins[bin].erase(std::make_pair(size, addr));
+        if (alloc->bins[bin].empty())
+                alloc->nonempty &= ~(1ull << bin);
+        alloc->stats.bytes_free -= size;
+        alloc->stats.num_free--;
+}
+
+/* Return [addr, addr + size) to the free blocks, merging with its neighbours */
+static void hb_mc_segfit_release(hb_mc_segfit_allocator_t *alloc, uint64_t addr, uint64_t size)
+{
+        std::map<uint64_t, uint64_t>::iterator next = alloc->free_by_addr.lower_bound(addr);
+
+        // merge with the following block
+        if (next != alloc->free_by_addr.end() && next->first == addr + size) {
+                uint64_t next_size = next->second;
+                hb_mc_segfit_remove_free(alloc, next->first, next_size);
+                size += next_size;
+                next = alloc->free_by_addr.lower_bound(addr);
+        }
+
+        // merge with the preceding block
+        if (next != alloc->free_by_addr.begin()) {
+                std::map<uint64_t, uint64_t>::iterator prev = std::prev(next);
+                if (prev->first + prev->second == addr) {
+                        uint64_t prev_addr = prev->first;
+                        uint64_t prev_size = prev->second;
+                        hb_mc_segfit_remove_free(alloc, prev_addr, prev_size);
+                        addr = prev_addr;
+                        size += prev_size;
+                }
+        }
+
+        hb_mc_segfit_insert_free(alloc, addr, size);
+}
+
+static void hb_mc_segfit_mark_busy(hb_mc_segfit_allocator_t *alloc, uint64_t addr, uint64_t size)
+{
+        alloc->busy[addr] = size;
+        alloc->stats.bytes_busy += size;
+        alloc->stats.num_busy++;
+        if (alloc->stats.bytes_busy > alloc->stats.peak_bytes_busy)
+                alloc->stats.peak_bytes_busy = alloc->stats.bytes_busy;
+}
+
+int hb_mc_segfit_allocator_init(hb_mc_segfit_allocator_t **alloc,
+                                uint64_t start,
+                                uint64_t size,
+                                uint32_t alignment)
+{
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+                bsg_pr_err("%s: alignment %" PRIu32 " is not a power of two\n",
+                           __func__, alignment);
+                return HB_MC_INVALID;
+        }
+
+        if (start % alignment != 0) {
+                bsg_pr_err("%s: start 0x%" PRIx64 " is not aligned to %" PRIu32 " bytes\n",
+                           __func__, start, alignment);
+                return HB_MC_INVALID;
+        }
+
+        hb_mc_segfit_allocator_t *a = new hb_mc_segfit_allocator_t;
+        a->start = start;
+        a->size = size & ~(uint64_t)(alignment - 1);
+        a->alignment = alignment;
+        a->nonempty = 0;
+        a->stats = {};
+        a->stats.size = a->size;
+
+        if (a->size > 0)
+                hb_mc_segfit_insert_free(a, a->start, a->size);
+
+        *alloc = a;
+        return HB_MC_SUCCESS;
+}
+
+void hb_mc_segfit_allocator_exit(hb_mc_segfit_allocator_t *alloc)
+{
+        delete alloc;
+}
+
+int hb_mc_segfit_allocator_alloc(hb_mc_segfit_allocator_t *alloc,
+                                 uint64_t size,
+                                 uint64_t *addr)
+{
+        size = hb_mc_segfit_round(alloc, size);
+        unsigned bin = hb_mc_segfit_bin(alloc, size);
+
+        // smallest block in the same size class that fits
+        std::set<std::pair<uint64_t, uint64_t> >::iterator it;
+        it = alloc->bins[bin].lower_bound(std::make_pair(size, (uint64_t)0));
+        if (it == alloc->bins[bin].end()) {
+                // otherwise any block in the next non-empty class fits; take its smallest
+                uint64_t larger = (bin + 1 < HB_MC_SEGFIT_NUM_BINS) ? alloc->nonempty & (~0ull << (bin + 1)) : 0;
+                if (larger == 0) {
+                        alloc->stats.num_failed++;
+                        return HB_MC_NOMEM;
+                }
+                it = alloc->bins[__builtin_ctzll(larger)].begin();
+        }
+
+        uint64_t block_size = it->first;
+        uint64_t block_addr = it->second;
+        hb_mc_segfit_remove_free(alloc, block_addr, block_size);
+
+        // return the tail to the free blocks; it has no free neighbours
+        if (block_size > size)
+                hb_mc_segfit_insert_free(alloc, block_addr + size, block_size - size);
+
+        hb_mc_segfit_mark_busy(alloc, block_addr, size);
+        alloc->stats.num_allocs++;
+
+        *addr = block_addr;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_segfit_allocator_free(hb_mc_segfit_allocator_t *alloc,
+                                uint64_t addr)
+{
+        std::unordered_map<uint64_t, uint64_t>::iterator it = alloc->busy.find(addr);
+        if (it == alloc->busy.end()) {
+                bsg_pr_err("%s: 0x%" PRIx64 " is not an allocated block\n",
+                           __func__, addr);
+                return HB_MC_INVALID;
+        }
+
+        uint64_t size = it->second;
+        alloc->busy.erase(it);
+        alloc->stats.bytes_busy -= size;
+        alloc->stats.num_busy--;
+        alloc->stats.num_frees++;
+
+        hb_mc_segfit_release(alloc, addr, size);
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_segfit_allocator_resize(hb_mc_segfit_allocator_t *alloc,
+                                  uint64_t addr,
+                                  uint64_t size)
+{
+        std::unordered_map<uint64_t, uint64_t>::iterator it = alloc->busy.find(addr);
+        if (it == alloc->busy.end()) {
+                bsg_pr_err("%s: 0x%" PRIx64 " is not an allocated block\n",
+                           __func__, addr);
+                return HB_MC_INVALID;
+        }
+
+        size = hb_mc_segfit_round(alloc, size);
+        uint64_t old_size = it->second;
+
+        if (size < old_size) {
+                // shrink: give back the tail
+                hb_mc_segfit_release(alloc, addr + size, old_size - size);
+        } else if (size > old_size) {
+                // grow: take the front of the following free block
+                std::map<uint64_t, uint64_t>::iterator next = alloc->free_by_addr.find(addr + old_size);
+                if (next == alloc->free_by_addr.end() || next->second < size - old_size) {
+                        alloc->stats.num_failed++;
+                        return HB_MC_NOMEM;
+                }
+
+                uint64_t next_size = next->second;
+                hb_mc_segfit_remove_free(alloc, addr + old_size, next_size);
+                if (next_size > size - old_size)
+                        hb_mc_segfit_insert_free(alloc, addr + size, next_size - (size - old_size));
+        }
+
+        it->second = size;
+        alloc->stats.bytes_busy = alloc->stats.bytes_busy - old_size + size;
+        if (alloc->stats.bytes_busy > alloc->stats.peak_bytes_busy)
+                alloc->stats.peak_bytes_busy = alloc->stats.bytes_busy;
+        alloc->stats.num_resizes++;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_segfit_allocator_reserve(hb_mc_segfit_allocator_t *alloc,
+                                   uint64_t addr,
+                                   uint64_t size)
+{
+        if (addr % alloc->alignment != 0) {
+                bsg_pr_err("%s: 0x%" PRIx64 " is not aligned to %" PRIu64 " bytes\n",
+                           __func__, addr, alloc->alignment);
+                return HB_MC_INVALID;
+        }
+
+        size = hb_mc_segfit_round(alloc, size);
+
+        // the free block that starts at or before addr must cover the range
+        std::map<uint64_t, uint64_t>::iterator it = alloc->free_by_addr.upper_bound(addr);
+        if (it == alloc->free_by_addr.begin()) {
+                alloc->stats.num_failed++;
+                return HB_MC_NOMEM;
+        }
+
+        it = std::prev(it);
+        uint64_t block_addr = it->first;
+        uint64_t block_size = it->second;
+        if (block_addr + block_size < addr + size) {
+                alloc->stats.num_failed++;
+                return HB_MC_NOMEM;
+        }
+
+        // split off the free head and tail; neither has a free neighbour
+        hb_mc_segfit_remove_free(alloc, block_addr, block_size);
+        if (addr > block_addr)
+                hb_mc_segfit_insert_free(alloc, block_addr, addr - block_addr);
+        if (block_addr + block_size > addr + size)
+                hb_mc_segfit_insert_free(alloc, addr + size, block_addr + block_size - (addr + size));
+
+        hb_mc_segfit_mark_busy(alloc, addr, size);
+        alloc->stats.num_allocs++;
+        return HB_MC_SUCCESS;
+}
+
+int hb_mc_segfit_allocator_lookup(const hb_mc_segfit_allocator_t *alloc,
+                                  uint64_t addr,
+                                  uint64_t *size)
+{
+        std::unordered_map<uint64_t, uint64_t>::const_iterator it = alloc->busy.find(addr);
+        if (it == alloc->busy.end())
+                return HB_MC_NOTFOUND;
+
+        *size = it->second;
+        return HB_MC_SUCCESS;
+}
+
+void hb_mc_segfit_allocator_get_stats(const hb_mc_segfit_allocator_t *alloc,
+                                      hb_mc_segfit_stats_t *stats)
+{
+        *stats = alloc->stats;
+
+        // the largest free block is the last one in the highest non-empty class
+        stats->largest_free = 0;
+        if (alloc->nonempty != 0) {
+                unsigned bin = 63 - __builtin_clzll(alloc->nonempty);
+                stats->largest_free = alloc->bins[bin].rbegin()->first;
+        }
+}
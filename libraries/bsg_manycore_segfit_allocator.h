@@ -0,0 +1,168 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef BSG_MANYCORE_SEGFIT_ALLOCATOR_H
+#define BSG_MANYCORE_SEGFIT_ALLOCATOR_H
+
+#include <bsg_manycore_features.h>
+#include <bsg_manycore_errno.h>
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+        /**
+         * Allocates aligned blocks from a contiguous address range.
+         *
+         * Free blocks are kept in segregated size-class bins, one per
+         * power of two, and each bin is ordered by size so that the
+         * smallest block that fits is found in O(log n). Busy blocks are
+         * hashed by address, and free blocks are also ordered by address
+         * so that a freed block merges with its neighbours in O(log n).
+         *
+         * Every block size and address is a multiple of the alignment.
+         */
+        typedef struct hb_mc_segfit_allocator hb_mc_segfit_allocator_t;
+
+        /**
+         * Allocator statistics.
+         */
+        typedef struct {
+                uint64_t size;            //!< Bytes managed by the allocator
+                uint64_t bytes_busy;      //!< Bytes in allocated blocks, after alignment
+                uint64_t bytes_free;      //!< Bytes in free blocks
+                uint64_t peak_bytes_busy; //!< Largest value bytes_busy has reached
+                uint64_t largest_free;    //!< Size of the largest free block
+                uint64_t num_busy;        //!< Number of allocated blocks
+                uint64_t num_free;        //!< Number of free blocks
+                uint64_t num_allocs;      //!< Successful calls to alloc
+                uint64_t num_frees;       //!< Successful calls to free
+                uint64_t num_resizes;     //!< Successful calls to resize
+                uint64_t num_failed;      //!< Calls to alloc or resize that found no space
+        } hb_mc_segfit_stats_t;
+
+        /**
+         * Create an allocator that manages [start, start + size).
+         * @param[out] alloc      The new allocator
+         * @param[in]  start      First address to manage. Must be a multiple of alignment.
+         * @param[in]  size       Number of bytes to manage. Rounded down to a multiple of alignment.
+         * @param[in]  alignment  Alignment of every block. Must be a power of two.
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_segfit_allocator_init(hb_mc_segfit_allocator_t **alloc,
+                                        uint64_t start,
+                                        uint64_t size,
+                                        uint32_t alignment);
+
+        /**
+         * Destroy an allocator. Blocks that are still allocated are released.
+         * @param[in] alloc  An allocator created with hb_mc_segfit_allocator_init()
+         */
+        void hb_mc_segfit_allocator_exit(hb_mc_segfit_allocator_t *alloc);
+
+        /**
+         * Allocate a block using the best fit among the free blocks.
+         * @param[in]  alloc  An allocator created with hb_mc_segfit_allocator_init()
+         * @param[in]  size   Bytes to allocate. Zero allocates one aligned unit.
+         * @param[out] addr   Address of the block
+         * @return HB_MC_SUCCESS if succesful. HB_MC_NOMEM if no free block is large enough.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_segfit_allocator_alloc(hb_mc_segfit_allocator_t *alloc,
+                                         uint64_t size,
+                                         uint64_t *addr);
+
+        /**
+         * Free a block and merge it with free neighbours.
+         * @param[in] alloc  An allocator created with hb_mc_segfit_allocator_init()
+         * @param[in] addr   Address returned by hb_mc_segfit_allocator_alloc()
+         * @return HB_MC_SUCCESS if succesful. HB_MC_INVALID if addr is not an allocated block.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_segfit_allocator_free(hb_mc_segfit_allocator_t *alloc,
+                                        uint64_t addr);
+
+        /**
+         * Resize an allocated block without moving it.
+         * Shrinking always succeeds. Growing succeeds if the block is
+         * followed by a free block with enough space.
+         * @param[in] alloc  An allocator created with hb_mc_segfit_allocator_init()
+         * @param[in] addr   Address returned by hb_mc_segfit_allocator_alloc()
+         * @param[in] size   New size in bytes
+         * @return HB_MC_SUCCESS if succesful. HB_MC_NOMEM if the block cannot grow in place.
+         *         HB_MC_INVALID if addr is not an allocated block.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_segfit_allocator_resize(hb_mc_segfit_allocator_t *alloc,
+                                          uint64_t addr,
+                                          uint64_t size);
+
+        /**
+         * Allocate the block [addr, addr + size), which must be free.
+         * @param[in] alloc  An allocator created with hb_mc_segfit_allocator_init()
+         * @param[in] addr   Address of the block. Must be a multiple of the alignment.
+         * @param[in] size   Bytes to allocate. Zero allocates one aligned unit.
+         * @return HB_MC_SUCCESS if succesful. HB_MC_NOMEM if part of the range is not free.
+         *         HB_MC_INVALID if addr is not aligned.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_segfit_allocator_reserve(hb_mc_segfit_allocator_t *alloc,
+                                           uint64_t addr,
+                                           uint64_t size);
+
+        /**
+         * Get the size of an allocated block.
+         * @param[in]  alloc  An allocator created with hb_mc_segfit_allocator_init()
+         * @param[in]  addr   Address returned by hb_mc_segfit_allocator_alloc()
+         * @param[out] size   Size of the block, after alignment
+         * @return HB_MC_SUCCESS if succesful. HB_MC_NOTFOUND if addr is not an allocated block.
+         */
+        __attribute__((warn_unused_result))
+        int hb_mc_segfit_allocator_lookup(const hb_mc_segfit_allocator_t *alloc,
+                                          uint64_t addr,
+                                          uint64_t *size);
+
+        /**
+         * Get allocator statistics.
+         * @param[in]  alloc  An allocator created with hb_mc_segfit_allocator_init()
+         * @param[out] stats  Current statistics
+         */
+        void hb_mc_segfit_allocator_get_stats(const hb_mc_segfit_allocator_t *alloc,
+                                              hb_mc_segfit_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
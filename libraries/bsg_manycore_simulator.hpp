@@ -30,6 +30,7 @@
 #ifndef __BSG_MANYCORE_SIMULATOR_HPP
 #define __BSG_MANYCORE_SIMULATOR_HPP
 #include <string>
+#include <cstdint>
 
 class SimulationWrapper{
         // This is the generic pointer for implementation-specific
@@ -57,5 +58,18 @@ public:
         // Cause time to proceed. 
         // eval() wraps the Vmanycore_tb_top->eval() function.
         void eval();
+
+        // Cause time to proceed for up to #cycles calls to eval(),
+        // without returning to the host, and stop early when the
+        // manycore presents a packet to the host. Returns the number
+        // of cycles that elapsed.
+        uint64_t idle(uint64_t cycles);
+
+        // Save the state of the simulated hardware to #path, or
+        // replace it with the state saved there. State that lives
+        // outside of the model (e.g. DPI memories) is not included.
+        // Returns HB_MC_NOIMPL on simulators that cannot checkpoint.
+        int save(const std::string &path);
+        int restore(const std::string &path);
 };
 #endif // __BSG_MANYCORE_SIMULATOR_HPP
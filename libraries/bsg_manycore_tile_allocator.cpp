@@ -0,0 +1,252 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_tile_allocator.h>
+#include <bsg_manycore_printing.h>
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+/* A mask of w bits starting at bit x */
+static uint64_t hb_mc_tile_allocator_row_mask(hb_mc_idx_t x, hb_mc_idx_t w)
+{
+        uint64_t bits = (w >= 64) ? ~0ull : ((1ull << w) - 1);
+        return bits << x;
+}
+
+/* Bit x of the result is set if bits x .. x+w-1 of bits are all set */
+static uint64_t hb_mc_tile_allocator_runs(uint64_t bits, hb_mc_idx_t w)
+{
+        hb_mc_idx_t run = 1;
+        while (2 * run <= w) {
+                bits &= bits >> run;
+                run *= 2;
+        }
+        if (run < w)
+                bits &= bits >> (w - run);
+        return bits;
+}
+
+/* Is the tile at (x, y) busy? Out-of-bounds tiles count as busy. */
+static int hb_mc_tile_allocator_tile_busy(const hb_mc_tile_allocator_t *alloc, int x, int y)
+{
+        if (x < 0 || y < 0 || x >= (int)alloc->dim.x || y >= (int)alloc->dim.y)
+                return 1;
+        return (alloc->busy[y] >> x) & 1;
+}
+
+/**
+ * Initialize a tile allocator with all tiles free.
+ * @param[in] alloc  A tile allocator
+ * @param[in] dim    Mesh dimensions. dim.x must be at most HB_MC_TILE_ALLOCATOR_MAX_WIDTH.
+ * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+ */
+int hb_mc_tile_allocator_init(hb_mc_tile_allocator_t *alloc, hb_mc_dimension_t dim)
+{
+        if (!alloc || dim.x == 0 || dim.y == 0)
+                return HB_MC_INVALID;
+
+        if (dim.x > HB_MC_TILE_ALLOCATOR_MAX_WIDTH) {
+                bsg_pr_err("%s: mesh width %u exceeds the maximum of %d\n",
+                           __func__, dim.x, HB_MC_TILE_ALLOCATOR_MAX_WIDTH);
+                return HB_MC_NOIMPL;
+        }
+
+        alloc->busy = (uint64_t *)calloc(dim.y, sizeof(*alloc->busy));
+        if (!alloc->busy)
+                return HB_MC_NOMEM;
+
+        alloc->dim = dim;
+        alloc->free_tiles = dim.x * dim.y;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Cleanup a tile allocator.
+ * @param[in] alloc  A tile allocator initialized with hb_mc_tile_allocator_init()
+ */
+void hb_mc_tile_allocator_exit(hb_mc_tile_allocator_t *alloc)
+{
+        if (!alloc)
+                return;
+
+        free(alloc->busy);
+        alloc->busy = NULL;
+        alloc->free_tiles = 0;
+}
+
+/**
+ * Check whether every tile in a rectangle is free.
+ * @param[in] alloc   A tile allocator initialized with hb_mc_tile_allocator_init()
+ * @param[in] origin  Origin of the rectangle
+ * @param[in] dim     Dimensions of the rectangle
+ * @return One if the rectangle is in bounds and free. Zero otherwise.
+ */
+int hb_mc_tile_allocator_is_free(const hb_mc_tile_allocator_t *alloc,
+                                 hb_mc_coordinate_t origin,
+                                 hb_mc_dimension_t dim)
+{
+        if (dim.x == 0 || dim.y == 0 ||
+            origin.x + dim.x > alloc->dim.x ||
+            origin.y + dim.y > alloc->dim.y)
+                return 0;
+
+        uint64_t mask = hb_mc_tile_allocator_row_mask(origin.x, dim.x);
+        for (hb_mc_idx_t y = origin.y; y < origin.y + dim.y; y++) {
+                if (alloc->busy[y] & mask)
+                        return 0;
+        }
+        return 1;
+}
+
+/**
+ * Count the busy or out-of-bounds tiles bordering a rectangle.
+ */
+static unsigned hb_mc_tile_allocator_contact(const hb_mc_tile_allocator_t *alloc,
+                                             hb_mc_idx_t x, hb_mc_idx_t y,
+                                             hb_mc_dimension_t dim)
+{
+        uint64_t mask = hb_mc_tile_allocator_row_mask(x, dim.x);
+        unsigned contact = 0;
+
+        // rows above and below
+        contact += (y == 0) ? dim.x : __builtin_popcountll(alloc->busy[y-1] & mask);
+        contact += (y + dim.y == alloc->dim.y) ? dim.x : __builtin_popcountll(alloc->busy[y+dim.y] & mask);
+
+        // columns to the left and right
+        for (hb_mc_idx_t r = y; r < y + dim.y; r++) {
+                contact += hb_mc_tile_allocator_tile_busy(alloc, (int)x - 1, r);
+                contact += hb_mc_tile_allocator_tile_busy(alloc, x + dim.x, r);
+        }
+
+        return contact;
+}
+
+/**
+ * Find and reserve a free rectangle of tiles using best-fit placement.
+ * @param[in]  alloc   A tile allocator initialized with hb_mc_tile_allocator_init()
+ * @param[in]  dim     Dimensions of the rectangle
+ * @param[out] origin  Origin of the reserved rectangle
+ * @return HB_MC_SUCCESS if a rectangle was reserved. HB_MC_NOTFOUND if no rectangle is free.
+ */
+int hb_mc_tile_allocator_alloc(hb_mc_tile_allocator_t *alloc,
+                               hb_mc_dimension_t dim,
+                               hb_mc_coordinate_t *origin)
+{
+        if (!alloc || !origin || dim.x == 0 || dim.y == 0)
+                return HB_MC_INVALID;
+
+        if (dim.x > alloc->dim.x || dim.y > alloc->dim.y ||
+            dim.x * dim.y > alloc->free_tiles)
+                return HB_MC_NOTFOUND;
+
+        const uint64_t row_free = hb_mc_tile_allocator_row_mask(0, alloc->dim.x);
+        const unsigned perfect = 2 * (dim.x + dim.y);
+        int found = 0;
+        unsigned best_contact = 0;
+        hb_mc_coordinate_t best = hb_mc_coordinate(0, 0);
+
+        for (hb_mc_idx_t y = 0; y + dim.y <= alloc->dim.y; y++) {
+                // tiles free in every row of the band
+                uint64_t busy = 0;
+                for (hb_mc_idx_t r = y; r < y + dim.y; r++)
+                        busy |= alloc->busy[r];
+                uint64_t free_tiles = ~busy & row_free;
+
+                // bit x of starts is set if tiles x .. x+dim.x-1 are free
+                uint64_t starts = hb_mc_tile_allocator_runs(free_tiles, dim.x);
+
+                // Only consider positions that cannot slide up or to the
+                // left. Any free rectangle can slide into one of these, so
+                // nothing is missed, and they are the ones with the most
+                // contact.
+                uint64_t left_blocked = (busy << 1) | 1;
+                uint64_t up_blocked = (y == 0) ? row_free :
+                        ~hb_mc_tile_allocator_runs(~alloc->busy[y-1], dim.x);
+                starts &= left_blocked & up_blocked;
+
+                for (; starts != 0; starts &= starts - 1) {
+                        hb_mc_idx_t x = __builtin_ctzll(starts);
+                        unsigned contact = hb_mc_tile_allocator_contact(alloc, x, y, dim);
+                        if (!found || contact > best_contact) {
+                                found = 1;
+                                best_contact = contact;
+                                best = hb_mc_coordinate(x, y);
+                                if (contact == perfect)
+                                        goto reserve;
+                        }
+                }
+        }
+
+        if (!found)
+                return HB_MC_NOTFOUND;
+
+reserve:
+        uint64_t mask = hb_mc_tile_allocator_row_mask(best.x, dim.x);
+        for (hb_mc_idx_t r = best.y; r < best.y + dim.y; r++)
+                alloc->busy[r] |= mask;
+
+        alloc->free_tiles -= dim.x * dim.y;
+        *origin = best;
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Release a rectangle reserved with hb_mc_tile_allocator_alloc().
+ * @param[in] alloc   A tile allocator initialized with hb_mc_tile_allocator_init()
+ * @param[in] origin  Origin of the rectangle
+ * @param[in] dim     Dimensions of the rectangle
+ * @return HB_MC_SUCCESS if succesful. HB_MC_INVALID if the rectangle was not fully reserved.
+ */
+int hb_mc_tile_allocator_free(hb_mc_tile_allocator_t *alloc,
+                              hb_mc_coordinate_t origin,
+                              hb_mc_dimension_t dim)
+{
+        if (!alloc || dim.x == 0 || dim.y == 0 ||
+            origin.x + dim.x > alloc->dim.x ||
+            origin.y + dim.y > alloc->dim.y)
+                return HB_MC_INVALID;
+
+        uint64_t mask = hb_mc_tile_allocator_row_mask(origin.x, dim.x);
+        for (hb_mc_idx_t y = origin.y; y < origin.y + dim.y; y++) {
+                if ((alloc->busy[y] & mask) != mask) {
+                        bsg_pr_err("%s: freeing tiles that are not allocated\n", __func__);
+                        return HB_MC_INVALID;
+                }
+        }
+
+        for (hb_mc_idx_t y = origin.y; y < origin.y + dim.y; y++)
+                alloc->busy[y] &= ~mask;
+
+        alloc->free_tiles += dim.x * dim.y;
+        return HB_MC_SUCCESS;
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2019, University of Washington All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+// 
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+// 
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+// 
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef BSG_MANYCORE_TILE_ALLOCATOR_H
+#define BSG_MANYCORE_TILE_ALLOCATOR_H
+
+#include <bsg_manycore_features.h>
+#include <bsg_manycore_coordinate.h>
+#include <bsg_manycore_errno.h>
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+        // The widest mesh a tile allocator can manage (one bitmap word per row)
+#define HB_MC_TILE_ALLOCATOR_MAX_WIDTH 64
+
+        /**
+         * Allocates rectangles of tiles from a mesh.
+         *
+         * Each mesh row is an occupancy bitmap, so checking whether a
+         * rectangle is free costs one word operation per row. Placement
+         * is best-fit: among all free positions, the allocator picks the
+         * one whose perimeter touches the most busy tiles and mesh edges,
+         * which keeps large holes open for large tile groups.
+         *
+         * Coordinates are relative to the mesh origin.
+         */
+        typedef struct {
+                hb_mc_dimension_t dim;   //!< Mesh dimensions
+                uint64_t *busy;          //!< One occupancy bitmap per row; bit x is set if tile x is busy
+                uint32_t free_tiles;     //!< Number of free tiles in the mesh
+        } hb_mc_tile_allocator_t;
+
+        /**
+         * Initialize a tile allocator with all tiles free.
+         * @param[in] alloc  A tile allocator
+         * @param[in] dim    Mesh dimensions. dim.x must be at most HB_MC_TILE_ALLOCATOR_MAX_WIDTH.
+         * @return HB_MC_SUCCESS if succesful. Otherwise an error code is returned.
+         */
+        int hb_mc_tile_allocator_init(hb_mc_tile_allocator_t *alloc, hb_mc_dimension_t dim);
+
+        /**
+         * Cleanup a tile allocator.
+         * @param[in] alloc  A tile allocator initialized with hb_mc_tile_allocator_init()
+         */
+        void hb_mc_tile_allocator_exit(hb_mc_tile_allocator_t *alloc);
+
+        /**
+         * Check whether every tile in a rectangle is free.
+         * @param[in] alloc   A tile allocator initialized with hb_mc_tile_allocator_init()
+         * @param[in] origin  Origin of the rectangle
+         * @param[in] dim     Dimensions of the rectangle
+         * @return One if the rectangle is in bounds and free. Zero otherwise.
+         */
+        int hb_mc_tile_allocator_is_free(const hb_mc_tile_allocator_t *alloc,
+                                         hb_mc_coordinate_t origin,
+                                         hb_mc_dimension_t dim);
+
+        /**
+         * Find and reserve a free rectangle of tiles using best-fit placement.
+         * @param[in]  alloc   A tile allocator initialized with hb_mc_tile_allocator_init()
+         * @param[in]  dim     Dimensions of the rectangle
+         * @param[out] origin  Origin of the reserved rectangle
+         * @return HB_MC_SUCCESS if a rectangle was reserved. HB_MC_NOTFOUND if no rectangle is free.
+         */
+        int hb_mc_tile_allocator_alloc(hb_mc_tile_allocator_t *alloc,
+                                       hb_mc_dimension_t dim,
+                                       hb_mc_coordinate_t *origin);
+
+        /**
+         * Release a rectangle reserved with hb_mc_tile_allocator_alloc().
+         * @param[in] alloc   A tile allocator initialized with hb_mc_tile_allocator_init()
+         * @param[in] origin  Origin of the rectangle
+         * @param[in] dim     Dimensions of the rectangle
+         * @return HB_MC_SUCCESS if succesful. HB_MC_INVALID if the rectangle was not fully reserved.
+         */
+        int hb_mc_tile_allocator_free(hb_mc_tile_allocator_t *alloc,
+                                      hb_mc_coordinate_t origin,
+                                      hb_mc_dimension_t dim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
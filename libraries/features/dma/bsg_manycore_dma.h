@@ -51,4 +51,16 @@ int hb_mc_dma_write(hb_mc_manycore_t *mc,
 
 int hb_mc_dma_init(hb_mc_manycore_t *mc);
 
+/**
+ * Get the host buffer that backs one DRAM memory via C++ backdoor.
+ * Memories are numbered from zero, as in hb_mc_dma_init().
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  id     A memory index
+ * @param[out] data   The backing buffer of the memory
+ * @param[out] sz     The size of the backing buffer in bytes
+ * @return HB_MC_NOTFOUND if #id is past the last memory. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_get_memory(hb_mc_manycore_t *mc, unsigned long id,
+                         unsigned char **data, size_t *sz);
+
 #endif
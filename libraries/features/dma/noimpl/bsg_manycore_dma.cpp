@@ -64,3 +64,12 @@ int hb_mc_dma_init(hb_mc_manycore_t *mc)
 {
         return HB_MC_SUCCESS;
 }
+
+__attribute__((weak))
+int hb_mc_dma_get_memory(hb_mc_manycore_t *mc, unsigned long id,
+                         unsigned char **data, size_t *sz)
+{
+        dma_pr_err(mc, "%s: This function is not supported on this platform\n",
+                        __func__);
+        return HB_MC_NOIMPL;
+}
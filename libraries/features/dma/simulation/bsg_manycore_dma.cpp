@@ -5,6 +5,8 @@
 #include <bsg_manycore_config_pod.h>
 #include <bsg_manycore_chip_id.h>
 
+#include <algorithm>
+
 /* these are convenience macros that are only good for one line prints */
 #define dma_pr_dbg(mc, fmt, ...)                   \
         bsg_pr_dbg("%s: " fmt, mc->name, ##__VA_ARGS__)
@@ -360,3 +362,38 @@ int hb_mc_dma_read(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Get the host buffer that backs one DRAM memory via C++ backdoor.
+ * Memories are numbered from zero, as in hb_mc_dma_init().
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  id     A memory index
+ * @param[out] data   The backing buffer of the memory
+ * @param[out] sz     The size of the backing buffer in bytes
+ * @return HB_MC_NOTFOUND if #id is past the last memory. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_get_memory(hb_mc_manycore_t *mc, unsigned long id,
+                         unsigned char **data, size_t *sz)
+{
+        // hb_mc_dma_init() leaves the map empty when it disables DMA
+        if (!hb_mc_config_memsys_feature_dma(&mc->config))
+                return HB_MC_NOIMPL;
+
+        // Memories are numbered densely by the maps above
+        parameter_t memories = 0;
+        for (unsigned long cache_id = 0; cache_id < hb_mc_vcache_num_caches(mc); cache_id++)
+                memories = std::max(memories, cache_id_to_memory_id[cache_id] + 1);
+
+        if (id >= memories)
+                return HB_MC_NOTFOUND;
+
+        Memory *memory = bsg_mem_dma_get_memory(id);
+        if (memory == nullptr) {
+                dma_pr_err(mc, "%s: Could not get memory %lu\n", __func__, id);
+                return HB_MC_FAIL;
+        }
+
+        *data = memory->get_ptr(0);
+        *sz = memory->size();
+
+        return HB_MC_SUCCESS;
+}
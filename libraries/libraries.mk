@@ -39,13 +39,14 @@ LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_cuda.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_elf.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_eva.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_loader.cpp
-LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_memory_manager.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_origin_eva_map.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_print_int_responder.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_printing.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_request_packet_id.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_responder.cpp
+LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_segfit_allocator.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_tile.cpp
+LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_tile_allocator.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_uart_responder.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_trace_responder.cpp
 LIB_CXXSOURCES += $(LIBRARIES_PATH)/bsg_manycore_vcache.cpp
@@ -62,7 +63,9 @@ LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_origin_eva_map.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_printing.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_request_packet_id.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_responder.h
+LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_segfit_allocator.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_tile.h
+LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_tile_allocator.h
 
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_vcache.h
 LIB_HEADERS += $(LIBRARIES_PATH)/bsg_manycore_errno.h
@@ -87,6 +90,8 @@ LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_eva.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_origin_eva_map.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_print_int_responder.o
 LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_memsys.o
+LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_tile_allocator.o
+LIB_STRICT_OBJECTS += $(LIBRARIES_PATH)/bsg_manycore_segfit_allocator.o
 
 # Object in the pod replication extension for CUDA
 LIB_CXXSOURCES_CUDA_POD_REPL += $(LIBRARIES_PATH)/bsg_manycore_cuda_legacy_replicate.cpp
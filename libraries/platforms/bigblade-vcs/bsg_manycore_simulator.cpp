@@ -29,16 +29,22 @@
 // differences in simulators.
 
 #include <bsg_manycore_simulator.hpp>
+#include <bsg_manycore_errno.h>
 #include <svdpi.h>
 
 extern "C" {
         void bsg_dpi_next();
+        svBit bsg_dpi_host_link_v();
 }
 
+// Scope of the testbench top, which exports bsg_dpi_host_link_v
+static svScope tb;
+
 SimulationWrapper::SimulationWrapper(){
         root = new std::string("replicant_tb_top");
         std::string mc_dpi = *root + ".mc_dpi";
         top = svGetScopeFromName(mc_dpi.c_str());
+        tb = svGetScopeFromName(root->c_str());
 }
 
 // Does nothing. Turning on/off assertions is only supported in
@@ -58,6 +64,30 @@ void SimulationWrapper::eval(){
         svSetScope(prev);
 }
 
+uint64_t SimulationWrapper::idle(uint64_t cycles){
+        svScope prev = svGetScope();
+        uint64_t n = 0;
+
+        do {
+                svSetScope(top);
+                bsg_dpi_next();
+                n++;
+                svSetScope(tb);
+        } while (n < cycles && !bsg_dpi_host_link_v());
+
+        svSetScope(prev);
+        return n;
+}
+
+// Checkpointing is not supported by VCS or Xcelium from DPI.
+int SimulationWrapper::save(const std::string &path){
+        return HB_MC_NOIMPL;
+}
+
+int SimulationWrapper::restore(const std::string &path){
+        return HB_MC_NOIMPL;
+}
+
 SimulationWrapper::~SimulationWrapper(){
         this->top = nullptr;
 }
@@ -28,10 +28,22 @@
 // SimulatorWrapper hides Vreplicant_tb_top behind a void *. 
 
 #include <bsg_manycore_simulator.hpp>
+#include <bsg_manycore_errno.h>
 #include <bsg_nonsynth_dpi_clock_gen.hpp>
 #include <verilated.h>
+#ifdef BSG_VERILATOR_SAVABLE
+#include <verilated_save.h>
+#endif
+#include <svdpi.h>
 #include <Vreplicant_tb_top.h>
 
+extern "C" {
+        svBit bsg_dpi_host_link_v();
+}
+
+// Scope of the testbench top, which exports bsg_dpi_host_link_v
+static svScope tb;
+
 SimulationWrapper::SimulationWrapper(){
         Vreplicant_tb_top *top = new Vreplicant_tb_top();
         this->top = reinterpret_cast<void *>(top);
@@ -48,6 +60,7 @@ SimulationWrapper::SimulationWrapper(){
 
         top->eval();
         root = new std::string("TOP.replicant_tb_top");
+        tb = svGetScopeFromName(root->c_str());
 }
 
 // Change the assertion state. This does not need to be implemented in
@@ -63,10 +76,58 @@ void SimulationWrapper::eval(){
         top->eval();
 }
 
+uint64_t SimulationWrapper::idle(uint64_t cycles){
+        Vreplicant_tb_top *top = reinterpret_cast<Vreplicant_tb_top *>(this->top);
+        svScope prev = svGetScope();
+        uint64_t n = 0;
+
+        do {
+                bsg_nonsynth_dpi::bsg_timekeeper::next();
+                top->eval();
+                n++;
+                svSetScope(tb);
+        } while (n < cycles && !bsg_dpi_host_link_v());
+
+        svSetScope(prev);
+        return n;
+}
+
 std::string SimulationWrapper::getRoot(){
         return *root;
 }
 
+// Checkpointing requires a model verilated with --savable, which
+// defines BSG_VERILATOR_SAVABLE (see link.mk).
+int SimulationWrapper::save(const std::string &path){
+#ifdef BSG_VERILATOR_SAVABLE
+        Vreplicant_tb_top *top = reinterpret_cast<Vreplicant_tb_top *>(this->top);
+        VerilatedSave os;
+        os.open(path.c_str());
+        if (!os.isOpen())
+                return HB_MC_FAIL;
+        os << *top;
+        os.close();
+        return HB_MC_SUCCESS;
+#else
+        return HB_MC_NOIMPL;
+#endif
+}
+
+int SimulationWrapper::restore(const std::string &path){
+#ifdef BSG_VERILATOR_SAVABLE
+        Vreplicant_tb_top *top = reinterpret_cast<Vreplicant_tb_top *>(this->top);
+        VerilatedRestore os;
+        os.open(path.c_str());
+        if (!os.isOpen())
+                return HB_MC_FAIL;
+        os >> *top;
+        os.close();
+        return HB_MC_SUCCESS;
+#else
+        return HB_MC_NOIMPL;
+#endif
+}
+
 SimulationWrapper::~SimulationWrapper(){
         Vreplicant_tb_top *top = reinterpret_cast<Vreplicant_tb_top *>(this->top);
         top->final();
@@ -26,16 +26,37 @@
 # SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 .PRECIOUS: threaded.log exec.log profile.log exec.log pc-histogram.log debug.vpd
-.PHONY: platform.execution.clean dve
+.PHONY: platform.execution.clean dve threads-sweep
 
 threaded.log: $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/threaded/simsc
 debug.log: $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/debug/simsc
-exec.log: $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/exec/simsc
+exec.log: $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/$(BSG_VERILATOR_EXEC)/simsc
 profile.log: $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/profile/simsc
 pc-histogram.log: $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/pc-histogram/simsc
 
+# Set BSG_VERILATOR_CPUS to a CPU list (e.g. 0-7) to pin the
+# simulation and its threads to those CPUs.
+BSG_VERILATOR_CPUS ?=
+SIM_LAUNCH = $(if $(BSG_VERILATOR_CPUS),taskset -c $(BSG_VERILATOR_CPUS))
+
 %.log: main.so $(BSG_MANYCORE_KERNELS)
-	$(filter %/simsc, $^) $(CURDIR)/main.so $(C_ARGS) 2>&1 | tee $@
+	$(SIM_LAUNCH) $(filter %/simsc, $^) $(CURDIR)/main.so $(C_ARGS) 2>&1 | tee $@
+
+# Throughput benchmark: run this program on the threaded model at each
+# thread count in BSG_VERILATOR_THREADS_SWEEP and record the simulated
+# cycles per wall-clock second for the machine.
+BSG_VERILATOR_THREADS_SWEEP ?= 1 2 4 8 16
+THROUGHPUT_CSV = $(BSG_MACHINE_PATH)/verilator_throughput.csv
+
+threads-sweep: main.so $(BSG_MANYCORE_KERNELS)
+	echo "threads,cycles,seconds,cycles_per_second" > $(THROUGHPUT_CSV)
+	for t in $(BSG_VERILATOR_THREADS_SWEEP); do \
+		rm -f threaded.log; \
+		BSG_REPORT_THROUGHPUT=1 $(MAKE) threaded.log BSG_VERILATOR_THREADS=$$t || exit 1; \
+		sed -n 's/.*Simulated \([0-9]*\) cycles in \([0-9.]*\) s.*/\1 \2/p' threaded.log | \
+			awk -v t=$$t '{ printf "%s,%s,%s,%.1f\n", t, $$1, $$2, $$1 / $$2 }' >> $(THROUGHPUT_CSV); \
+	done
+	cat $(THROUGHPUT_CSV)
 
 vanilla_stats.csv vcache_stats.csv router_stat.csv: profile.log
 
@@ -46,7 +67,7 @@ dve: debug.vpd
 	$(DVE) -full64 -vpd $< &
 
 platform.execution.clean:
-	rm -rf saifgen.log exec.log profile.log exec.log debug.vpd
+	rm -rf saifgen.log exec.log profile.log exec.log threaded.log debug.vpd
 	rm -rf vanilla_stats.csv
 	rm -rf infinite_mem_stats.csv
 	rm -rf vcache_stats.csv
@@ -64,9 +85,14 @@ execution.clean: platform.execution.clean
 
 help:
 	@echo "Usage:"
-	@echo "make {clean | exec.log | profile.log | debug.log | debug.fst | threaded.log }"
+	@echo "make {clean | exec.log | profile.log | debug.log | debug.fst | threaded.log | threads-sweep }"
 	@echo "      exec.log: Run program with SAIF, profilers, and waveform generation disabled (Fastest)"
+	@echo "                Set BSG_VERILATOR_EXEC=threaded to use the threaded model"
 	@echo "      profile.log: Run program with profilers enabled, SAIF and waveform generation disabled"
-	@echo "      threaded.log: Run program with THREADED VERILATOR, profilers and waveform generation disabled"
+	@echo "      threaded.log: Run program with BSG_VERILATOR_THREADS Verilator threads, profilers and waveform generation disabled"
+	@echo "      threads-sweep: Record simulated cycles per second against BSG_VERILATOR_THREADS_SWEEP"
+	@echo "                     in BSG_MACHINE_PATH/verilator_throughput.csv"
 	@echo "      debug.log debug.fst: Run program with waveform generate enabled"
+	@echo "      Add --checkpoint-save=<file> to C_ARGS to checkpoint the exec model after reset and"
+	@echo "      DRAM/cache init, and --checkpoint-restore=<file> to start later runs from it"
 	@echo "      clean: Remove all subdirectory-specific outputs"
@@ -79,7 +79,7 @@ LIBS  = $(foreach d,$(DIRS),$d/V$(BSG_DESIGN_TOP)__ALL.a)
 SIMSCS = $(foreach d,$(DIRS),$d/simsc)
 
 # Generic Verilator source files that are compiiled into libmachine.so
-VERILATOR_SRCS := verilated.cpp verilated_dpi.cpp
+VERILATOR_SRCS := verilated.cpp verilated_dpi.cpp verilated_save.cpp
 THREADED_SRCS  := $(VERILATOR_SRCS) verilated_threads.cpp
 WAVEFORM_SRCS  := verilated_fst_c.cpp $(VERILATOR_SRCS) 
 
@@ -125,6 +125,10 @@ $(BSG_MACHINExPLATFORM_PATH)/exec/V$(BSG_DESIGN_TOP).mk: VDEFINES += VERILATOR_W
 $(BSG_MACHINExPLATFORM_PATH)/exec/V$(BSG_DESIGN_TOP).mk: VDEFINES += VERILATOR_WORKAROUND_DISABLE_ROUTER_PROFILER
 $(BSG_MACHINExPLATFORM_PATH)/exec/V$(BSG_DESIGN_TOP).mk: VDEFINES += VERILATOR_WORKAROUND_DISABLE_PC_HISTOGRAM
 
+# The exec model supports checkpoint/restore (--checkpoint-save and
+# --checkpoint-restore). Verilator cannot save threaded models.
+$(BSG_MACHINExPLATFORM_PATH)/exec/V$(BSG_DESIGN_TOP).mk: VERILATOR_VFLAGS += --savable
+
 # Disable profiling to turbocharge the exec binary
 $(BSG_MACHINExPLATFORM_PATH)/pc-histogram/V$(BSG_DESIGN_TOP).mk: VDEFINES += BSG_MACHINE_DISABLE_VCORE_PROFILING
 $(BSG_MACHINExPLATFORM_PATH)/pc-histogram/V$(BSG_DESIGN_TOP).mk: VDEFINES += BSG_MACHINE_DISABLE_CACHE_PROFILING
@@ -141,7 +145,36 @@ $(BSG_MACHINExPLATFORM_PATH)/pc-histogram/V$(BSG_DESIGN_TOP).mk: VDEFINES += VER
 $(BSG_MACHINExPLATFORM_PATH)/debug/V$(BSG_DESIGN_TOP).mk: VERILATOR_VFLAGS += --trace-fst --trace-structs
 $(BSG_MACHINExPLATFORM_PATH)/debug/V$(BSG_DESIGN_TOP).mk: VDEFINES += BSG_VERILATOR_WAVEFORM
 
-$(BSG_MACHINExPLATFORM_PATH)/threaded/V$(BSG_DESIGN_TOP).mk: VERILATOR_VFLAGS += --threads 4
+# The threaded model is built with BSG_VERILATOR_THREADS threads. A
+# machine can choose its own count by setting
+# BSG_MACHINE_VERILATOR_THREADS in Makefile.machine.include.
+#
+# BSG_VERILATOR_MTASKS is an optional partitioning hint: the number of
+# macro-tasks Verilator splits the model into before scheduling them
+# on threads (--threads-max-mtasks). On multi-pod machines a multiple
+# of BSG_MACHINE_NUM_PODS keeps partitions from straddling pods.
+BSG_MACHINE_VERILATOR_THREADS ?= 4
+BSG_VERILATOR_THREADS ?= $(BSG_MACHINE_VERILATOR_THREADS)
+BSG_VERILATOR_MTASKS  ?=
+
+# exec.log, and therefore every regression, runs the model in
+# $(BSG_VERILATOR_EXEC): exec (single-threaded) or threaded.
+BSG_VERILATOR_EXEC ?= exec
+ifeq ($(filter $(BSG_VERILATOR_EXEC),exec threaded),)
+$(error $(shell echo -e "$(RED)BSG MAKE ERROR: BSG_VERILATOR_EXEC must be exec or threaded$(NC)"))
+endif
+
+# The model is re-verilated when the thread count or hint changes
+THREADED_STAMP = $(BSG_MACHINExPLATFORM_PATH)/threaded/.threads-$(BSG_VERILATOR_THREADS)-mtasks-$(BSG_VERILATOR_MTASKS)
+$(THREADED_STAMP): | $(BSG_MACHINExPLATFORM_PATH)/threaded
+	rm -f $(dir $@).threads-*
+	touch $@
+
+$(BSG_MACHINExPLATFORM_PATH)/threaded/V$(BSG_DESIGN_TOP).mk: $(THREADED_STAMP)
+$(BSG_MACHINExPLATFORM_PATH)/threaded/V$(BSG_DESIGN_TOP).mk: VERILATOR_VFLAGS += --threads $(BSG_VERILATOR_THREADS)
+ifneq ($(BSG_VERILATOR_MTASKS),)
+$(BSG_MACHINExPLATFORM_PATH)/threaded/V$(BSG_DESIGN_TOP).mk: VERILATOR_VFLAGS += --threads-max-mtasks $(BSG_VERILATOR_MTASKS)
+endif
 $(BSG_MACHINExPLATFORM_PATH)/threaded/V$(BSG_DESIGN_TOP).mk: VDEFINES += BSG_MACHINE_DISABLE_VCORE_PROFILING
 $(BSG_MACHINExPLATFORM_PATH)/threaded/V$(BSG_DESIGN_TOP).mk: VDEFINES += BSG_MACHINE_DISABLE_CACHE_PROFILING
 $(BSG_MACHINExPLATFORM_PATH)/threaded/V$(BSG_DESIGN_TOP).mk: VDEFINES += BSG_MACHINE_DISABLE_ROUTER_PROFILING
@@ -165,7 +198,7 @@ $(BSG_MACHINExPLATFORM_PATH)/operf/V$(BSG_DESIGN_TOP).mk: VERILATOR_VFLAGS += --
 $(FRAGS): %/V$(BSG_DESIGN_TOP).mk : | %
 $(FRAGS): $(VHEADERS) $(VSOURCES)
 	$(info BSG_INFO: Running verilator)
-	@$(VERILATOR) -Mdir $(dir $@) --cc $(VERILATOR_CFLAGS) $(VERILATOR_VFLAGS) $^ --top-module $(BSG_DESIGN_TOP)
+	@$(VERILATOR) -Mdir $(dir $@) --cc $(VERILATOR_CFLAGS) $(VERILATOR_VFLAGS) $(filter-out $(THREADED_STAMP),$^) --top-module $(BSG_DESIGN_TOP)
 
 # Static library build rules
 $(LIBS): %/V$(BSG_DESIGN_TOP)__ALL.a : %/V$(BSG_DESIGN_TOP).mk
@@ -178,6 +211,7 @@ $(LIBS): %/V$(BSG_DESIGN_TOP)__ALL.a : %/V$(BSG_DESIGN_TOP).mk
 # machine.
 $(BSG_MACHINExPLATFORM_PATH)/threaded/bsg_manycore_simulator.o: DEFINES  += -DVL_THREADED
 $(BSG_MACHINExPLATFORM_PATH)/debug/bsg_manycore_simulator.o: DEFINES  += -DBSG_VERILATOR_WAVEFORM
+$(BSG_MACHINExPLATFORM_PATH)/exec/bsg_manycore_simulator.o: DEFINES  += -DBSG_VERILATOR_SAVABLE
 $(SIMOS): INCLUDES := -I$(BSG_PLATFORM_PATH)
 $(SIMOS): INCLUDES := -I$(LIBRARIES_PATH)
 $(SIMOS): INCLUDES += -I$(BSG_MACHINE_PATH)/notrace
@@ -226,6 +260,7 @@ $(SIMSCS): %/simsc : %/bsg_manycore_simulator.o %/V$(BSG_DESIGN_TOP)__ALL.a
 # regression tests can build them before launching parallel
 # compilation and execution
 REGRESSION_PREBUILD += $(BSG_MACHINExPLATFORM_PATH)/exec/simsc
+REGRESSION_PREBUILD += $(BSG_MACHINExPLATFORM_PATH)/$(BSG_VERILATOR_EXEC)/simsc
 REGRESSION_PREBUILD += $(BSG_MACHINExPLATFORM_PATH)/debug/simsc
 REGRESSION_PREBUILD += $(BSG_MACHINExPLATFORM_PATH)/profile/simsc
 REGRESSION_PREBUILD += $(BSG_MACHINExPLATFORM_PATH)/pc-histogram/simsc
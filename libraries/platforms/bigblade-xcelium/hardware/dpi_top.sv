@@ -317,6 +317,15 @@ module replicant_tb_top
       ,.debug_o()
       );
 
+   // While the host waits for a packet it advances the simulation
+   // with SimulationWrapper::idle(), which checks this between
+   // cycles instead of polling the DPI FIFOs. It is high when the
+   // manycore presents a request or response to the host.
+   export "DPI-C" function bsg_dpi_host_link_v;
+   function bit bsg_dpi_host_link_v();
+      return host_link_sif_lo.fwd.v | host_link_sif_lo.rev.v;
+   endfunction
+
    bsg_dff_chain
      #(
        .width_p(1)
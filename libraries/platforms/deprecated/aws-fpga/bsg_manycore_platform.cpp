@@ -249,6 +249,31 @@ int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Transmit an array of packets to manycore hardware, in order.
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n packets to transmit to manycore hardware
+ * @param[in] n       The number of packets
+ * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                  hb_mc_packet_t *packets,
+                                  size_t n,
+                                  hb_mc_fifo_tx_t type,
+                                  long timeout){
+        int err;
+
+        // vacancy is only polled when the cached count runs out
+        for (size_t i = 0; i < n; i++) {
+                err = hb_mc_platform_transmit(mc, &packets[i], type, timeout);
+                if (err != HB_MC_SUCCESS)
+                        return err;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
 /**
  * Receive a packet from manycore hardware
  * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
@@ -624,3 +649,29 @@ int hb_mc_platform_log_disable(hb_mc_manycore_t *mc){
         hb_mc_platform_t *pl = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
         return hb_mc_tracer_log_disable(pl->tracer);
 }
+
+/**
+ * Save the state of the manycore hardware to a checkpoint.
+ * Not supported on this platform.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path  The checkpoint file
+ * @return HB_MC_NOIMPL
+ */
+int hb_mc_platform_checkpoint_save(hb_mc_manycore_t *mc, const char *path)
+{
+        platform_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Replace the state of the manycore hardware with a checkpoint.
+ * Not supported on this platform.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path  The checkpoint file
+ * @return HB_MC_NOIMPL
+ */
+int hb_mc_platform_checkpoint_restore(hb_mc_manycore_t *mc, const char *path)
+{
+        platform_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
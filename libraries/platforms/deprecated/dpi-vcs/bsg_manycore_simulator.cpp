@@ -58,6 +58,13 @@ void SimulationWrapper::eval(){
         svSetScope(prev);
 }
 
+// This testbench does not export a probe of the host link, so the
+// host cannot tell when to stop early. Advance one cycle.
+uint64_t SimulationWrapper::idle(uint64_t cycles){
+        eval();
+        return 1;
+}
+
 SimulationWrapper::~SimulationWrapper(){
         this->top = nullptr;
 }
@@ -37,6 +37,7 @@
 #include <bsg_nonsynth_dpi_cycle_counter.hpp>
 #include <bsg_nonsynth_dpi_clock_gen.hpp>
 
+#include <cstdlib>
 #include <cstring>
 #include <set>
 #include <map>
@@ -61,8 +62,19 @@ typedef struct hb_mc_platform_t {
         hb_mc_manycore_id_t id;
         bsg_nonsynth_dpi::dpi_cycle_counter<uint64_t> *ctr;
         hb_mc_tracer_t tracer;
+        uint64_t idle_cycles;
 } hb_mc_platform_t;
 
+// While a receive finds its FIFO empty, the simulation is advanced up
+// to this many cycles at a time, stopping early when the manycore
+// presents a packet to the host. BSG_HOST_IDLE_CYCLES overrides it;
+// 1 polls the FIFO every cycle.
+#define HB_MC_PLATFORM_IDLE_CYCLES 1024
+
+// After an early stop, this many cycles are stepped one at a time so
+// that the packet can reach the DPI FIFO.
+#define HB_MC_PLATFORM_IDLE_SETTLE_CYCLES 16
+
 /* read all unread packets from a fifo (rx only) */
 int hb_mc_platform_drain(hb_mc_manycore_t *mc, hb_mc_fifo_rx_t type)
 {
@@ -206,6 +218,9 @@ int hb_mc_platform_init(hb_mc_manycore_t *mc, hb_mc_manycore_id_t id)
         active_ids.insert(id);
         platform->id = id;
 
+        const char *idle = getenv("BSG_HOST_IDLE_CYCLES");
+        platform->idle_cycles = idle ? strtoull(idle, nullptr, 0) : HB_MC_PLATFORM_IDLE_CYCLES;
+
         // Instantiate the top-level platform simulation and put it in
         // the map. If it has already been instantiated, don't
         // instantiate it again.
@@ -257,57 +272,85 @@ int hb_mc_platform_init(hb_mc_manycore_t *mc, hb_mc_manycore_id_t id)
  * Transmit a packet to manycore hardware
  * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] request A request packet to transmit to manycore hardware
- * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
- * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ * @param[in] timeout The number of times to retry while the FIFO is not ready, or -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. HB_MC_TIMEOUT if #timeout retries were exhausted.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
                             hb_mc_packet_t *packet,
                             hb_mc_fifo_tx_t type,
                             long timeout)
+{
+        return hb_mc_platform_transmit_batch(mc, packet, 1, type, timeout);
+}
+
+/**
+ * Transmit an array of packets to manycore hardware, in order.
+ * The simulation only advances when the DPI interface refuses a packet,
+ * so packets are queued back to back while the window and credits allow.
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n packets to transmit to manycore hardware
+ * @param[in] n       The number of packets
+ * @param[in] timeout Retries per packet before HB_MC_TIMEOUT, or -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. HB_MC_TIMEOUT if #timeout retries were exhausted.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                  hb_mc_packet_t *packets,
+                                  size_t n,
+                                  hb_mc_fifo_tx_t type,
+                                  long timeout)
 {
         hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
         SimulationWrapper *top = platform->top;
-        __m128i *pkt = reinterpret_cast<__m128i*>(packet);
         const char *typestr = hb_mc_fifo_tx_to_string(type);
+        bool retryable;
 
         int err;
-        if (timeout != -1) {
-                manycore_pr_err(mc, "%s: Only a timeout value of -1 is supported\n",
-                                __func__);
-                return HB_MC_INVALID;
-        }
 
         if (type == HB_MC_FIFO_TX_RSP) {
                 manycore_pr_err(mc, "TX Response Not Supported!\n", typestr);
                 return HB_MC_NOIMPL;
         }
 
-        // The DPI interface doesn't understand packets, but it does
-        // track response fifo occupancy. However, only some requests
-        // produce responses because we use the endpoint standard
-        // (which filters write responses). We use expect_response to
-        // indicate that this request will produce a response, so that
-        // the DPI interface can track the response fifo capacity.
-        bool expect_response =
-                (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_STORE) &&
-                (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_SW) &&
-                (packet->request.op_v2 != HB_MC_PACKET_OP_CACHE_OP);
-
-        do {
-                top->eval();
+        top->eval();
+        for (size_t i = 0; i < n; i++) {
+                hb_mc_packet_t *packet = &packets[i];
+                __m128i *pkt = reinterpret_cast<__m128i*>(packet);
+                long retries = 0;
+
+                // The DPI interface doesn't understand packets, but it does
+                // track response fifo occupancy. However, only some requests
+                // produce responses because we use the endpoint standard
+                // (which filters write responses). We use expect_response to
+                // indicate that this request will produce a response, so that
+                // the DPI interface can track the response fifo capacity.
+                bool expect_response =
+                        (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_STORE) &&
+                        (packet->request.op_v2 != HB_MC_PACKET_OP_REMOTE_SW) &&
+                        (packet->request.op_v2 != HB_MC_PACKET_OP_CACHE_OP);
+
+                // only advance the simulation when the packet is refused
                 err = platform->dpi->tx_req(*pkt, expect_response);
-
-        } while (err != BSG_NONSYNTH_DPI_SUCCESS &&
-                 (err == BSG_NONSYNTH_DPI_NO_CREDITS ||
-                  err == BSG_NONSYNTH_DPI_NO_CAPACITY ||
-                  err == BSG_NONSYNTH_DPI_NOT_WINDOW ||
-                  err == BSG_NONSYNTH_DPI_BUSY ||
-                  err == BSG_NONSYNTH_DPI_NOT_READY ));
-
-        if(err != BSG_NONSYNTH_DPI_SUCCESS){
-                manycore_pr_err(mc, "%s: Failed to transmit packet: %s\n",
-                                __func__, bsg_nonsynth_dpi_strerror(err));
-                return HB_MC_INVALID;
+                while (err != BSG_NONSYNTH_DPI_SUCCESS) {
+                        retryable = (err == BSG_NONSYNTH_DPI_NO_CREDITS ||
+                                     err == BSG_NONSYNTH_DPI_NO_CAPACITY ||
+                                     err == BSG_NONSYNTH_DPI_NOT_WINDOW ||
+                                     err == BSG_NONSYNTH_DPI_BUSY ||
+                                     err == BSG_NONSYNTH_DPI_NOT_READY);
+
+                        if (!retryable) {
+                                manycore_pr_err(mc, "%s: Failed to transmit packet: %s\n",
+                                                __func__, bsg_nonsynth_dpi_strerror(err));
+                                return HB_MC_INVALID;
+                        }
+
+                        if (timeout != -1 && retries++ >= timeout)
+                                return HB_MC_TIMEOUT;
+
+                        top->eval();
+                        err = platform->dpi->tx_req(*pkt, expect_response);
+                }
         }
 
         return HB_MC_SUCCESS;
@@ -317,8 +360,10 @@ int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
  * Receive a packet from manycore hardware
  * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
  * @param[in] response A packet into which data should be read
- * @param[in] timeout  A timeout counter. Unused - set to -1 to wait forever.
- * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ * @param[in] timeout  The number of times to retry while no packet is available, or -1 to wait forever.
+ *                     A retry may advance the simulation by up to BSG_HOST_IDLE_CYCLES cycles.
+ * @return HB_MC_SUCCESS on success. HB_MC_TIMEOUT if #timeout retries were exhausted.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
  */
 int hb_mc_platform_receive(hb_mc_manycore_t *mc,
                            hb_mc_packet_t *packet,
@@ -330,15 +375,22 @@ int hb_mc_platform_receive(hb_mc_manycore_t *mc,
         hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
         SimulationWrapper *top = platform->top;
         __m128i *pkt = reinterpret_cast<__m128i*>(packet);
-
-        if (timeout != -1) {
-                manycore_pr_err(mc, "%s: Only a timeout value of -1 is supported\n",
-                                __func__);
-                return HB_MC_INVALID;
-        }
+        bool retryable, empty = false;
+        long retries = 0;
+        uint64_t settle = 0;
 
         do {
-                top->eval();
+                // Once the FIFO is empty, hand the simulation over until
+                // a packet shows up on the host link instead of polling
+                // the FIFO every cycle.
+                if (empty && settle == 0 && platform->idle_cycles > 1) {
+                        if (top->idle(platform->idle_cycles) < platform->idle_cycles)
+                                settle = HB_MC_PLATFORM_IDLE_SETTLE_CYCLES;
+                } else {
+                        top->eval();
+                        if (settle > 0)
+                                settle--;
+                }
 
                 switch(type){
                 case HB_MC_FIFO_RX_REQ:
@@ -352,10 +404,16 @@ int hb_mc_platform_receive(hb_mc_manycore_t *mc,
                         return HB_MC_NOIMPL;
                 }
 
-        } while (err != BSG_NONSYNTH_DPI_SUCCESS &&
-                 (err == BSG_NONSYNTH_DPI_NOT_WINDOW ||
-                  err == BSG_NONSYNTH_DPI_BUSY ||
-                  err == BSG_NONSYNTH_DPI_NOT_VALID));
+                empty = (err == BSG_NONSYNTH_DPI_NOT_VALID);
+                retryable = (err == BSG_NONSYNTH_DPI_NOT_WINDOW ||
+                             err == BSG_NONSYNTH_DPI_BUSY ||
+                             err == BSG_NONSYNTH_DPI_NOT_VALID);
+
+        } while (err != BSG_NONSYNTH_DPI_SUCCESS && retryable &&
+                 (timeout == -1 || retries++ < timeout));
+
+        if (err != BSG_NONSYNTH_DPI_SUCCESS && retryable)
+                return HB_MC_TIMEOUT;
 
         if(err != BSG_NONSYNTH_DPI_SUCCESS){
                 manycore_pr_err(mc, "%s: Failed to receive packet: %s\n",
@@ -616,3 +674,28 @@ int hb_mc_platform_wait_reset_done(hb_mc_manycore_t *mc)
         return HB_MC_SUCCESS;
 }
 
+/**
+ * Save the state of the manycore hardware to a checkpoint.
+ * Not supported on this platform.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path  The checkpoint file
+ * @return HB_MC_NOIMPL
+ */
+int hb_mc_platform_checkpoint_save(hb_mc_manycore_t *mc, const char *path)
+{
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Replace the state of the manycore hardware with a checkpoint.
+ * Not supported on this platform.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path  The checkpoint file
+ * @return HB_MC_NOIMPL
+ */
+int hb_mc_platform_checkpoint_restore(hb_mc_manycore_t *mc, const char *path)
+{
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
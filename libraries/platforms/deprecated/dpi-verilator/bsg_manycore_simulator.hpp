@@ -30,6 +30,7 @@
 #ifndef __BSG_MANYCORE_SIMULATOR_HPP
 #define __BSG_MANYCORE_SIMULATOR_HPP
 #include <string>
+#include <cstdint>
 
 class SimulationWrapper{
         // This is the generic pointer for implementation-specific
@@ -57,5 +58,11 @@ public:
         // Cause time to proceed. 
         // eval() wraps the Vmanycore_tb_top->eval() function.
         void eval();
+
+        // Cause time to proceed for up to #cycles calls to eval(),
+        // without returning to the host, and stop early when the
+        // manycore presents a packet to the host. Returns the number
+        // of cycles that elapsed.
+        uint64_t idle(uint64_t cycles);
 };
 #endif // __BSG_MANYCORE_SIMULATOR_HPP
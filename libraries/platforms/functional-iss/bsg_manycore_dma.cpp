@@ -0,0 +1,101 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_dma.h>
+#include <bsg_manycore_printing.h>
+#include <bsg_manycore_iss.hpp>
+
+/* these are convenience macros that are only good for one line prints */
+#define dma_pr_dbg(mc, fmt, ...)                   \
+        bsg_pr_dbg("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define dma_pr_err(mc, fmt, ...)                   \
+        bsg_pr_err("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+/**
+ * Initialize DMA for the functional ISS. DRAM is allocated on demand,
+ * so there is nothing to set up.
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS
+ */
+int hb_mc_dma_init(hb_mc_manycore_t *mc)
+{
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Write memory out to manycore DRAM via the ISS backdoor
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t - must be an L2 cache coordinate
+ * @param[in]  data   A buffer to be written out manycore hardware
+ * @param[in]  sz     The number of bytes to write to manycore hardware
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_write(hb_mc_manycore_t *mc,
+                    const hb_mc_npa_t *npa,
+                    const void *data, size_t sz)
+{
+        char npa_str[256];
+
+        dma_pr_dbg(mc, "%s: Writing %3zu bytes to %s\n",
+                   __func__, sz, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+
+        if (!hb_mc_platform_get_iss(mc)->dram_write(npa, data, sz)) {
+                dma_pr_err(mc, "%s: %s is not a DRAM address\n", __func__,
+                           hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+                return HB_MC_INVALID;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Read memory from manycore DRAM via the ISS backdoor
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  npa    A valid hb_mc_npa_t - must be an L2 cache coordinate
+ * @param[in]  data   A host buffer to be read into from manycore hardware
+ * @param[in]  sz     The number of bytes to read from manycore hardware
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_dma_read(hb_mc_manycore_t *mc,
+                   const hb_mc_npa_t *npa,
+                   void *data, size_t sz)
+{
+        char npa_str[256];
+
+        dma_pr_dbg(mc, "%s: Reading %3zu bytes from %s\n",
+                   __func__, sz, hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+
+        if (!hb_mc_platform_get_iss(mc)->dram_read(npa, data, sz)) {
+                dma_pr_err(mc, "%s: %s is not a DRAM address\n", __func__,
+                           hb_mc_npa_to_string(npa, npa_str, sizeof(npa_str)));
+                return HB_MC_INVALID;
+        }
+
+        return HB_MC_SUCCESS;
+}
@@ -0,0 +1,1391 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_iss.hpp>
+#include <bsg_manycore_tile.h>
+#include <bsg_manycore_vcache.h>
+#include <bsg_manycore_printing.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+
+// Instructions are fetched from DRAM at the PC with the DRAM bit set
+#define ISS_DRAM_BIT 0x80000000u
+
+// Direct-mapped EVA->NPA translations cached per core
+#define ISS_TLB_ENTRIES 256
+
+// DRAM banks are allocated in pages on first write
+#define ISS_PAGE_LOGSZ 16
+#define ISS_PAGE_WORDS (1u << (ISS_PAGE_LOGSZ - 2))
+#define ISS_BANK_PAGES (HB_MC_VCACHE_EPA_OFFSET_TAG >> ISS_PAGE_LOGSZ)
+
+// Approximate latencies, in cycles. Everything else takes one cycle.
+#define ISS_LAT_IFETCH_MISS 40
+#define ISS_LAT_DRAM        20
+#define ISS_LAT_TILE        2
+#define ISS_LAT_AMO         10
+#define ISS_LAT_IDIV        32
+#define ISS_LAT_FDIV        20
+
+#define ISS_DEFAULT_QUANTUM 1000
+
+// Hardware barrier CSRs and instructions (FENCE with fm = 1 or 2)
+#define ISS_CSR_BARCFG  0xFC1
+#define ISS_CSR_BAR_PI  0xFC2
+#define ISS_INSN_BARSEND 0x1000000Fu
+#define ISS_INSN_BARRECV 0x2000000Fu
+
+// Barrier directions, shared by the input mask bits and the output
+// field of the barrier configuration CSR
+#define ISS_BAR_W     1
+#define ISS_BAR_E     2
+#define ISS_BAR_N     3
+#define ISS_BAR_S     4
+#define ISS_BAR_RW    5
+#define ISS_BAR_RE    6
+#define ISS_BAR_ROOT  7
+#define ISS_BAR_OUTDIR_OFFSET 16
+
+#define iss_pr_err(c, fmt, ...)                                         \
+        bsg_pr_err("ISS: tile (x: %d, y: %d) pc 0x%08" PRIx32 ": " fmt,  \
+                   (c).coord.x, (c).coord.y, (c).pc, ##__VA_ARGS__)
+
+struct IssTlbEntry {
+        hb_mc_eva_t tag;
+        hb_mc_idx_t x, y;
+        hb_mc_epa_t epa;
+        bool valid;
+};
+
+struct IssCore {
+        hb_mc_coordinate_t coord;
+        std::unique_ptr<std::atomic<uint32_t>[]> dmem;
+
+        // Tile CSRs
+        std::atomic<bool> freeze;
+        uint32_t tgo_x, tgo_y;
+        uint32_t pc_init;
+
+        // Architectural state
+        uint32_t pc;
+        uint32_t x[32];
+        uint32_t f[32];
+        uint32_t frm;
+
+        // LR reservation: (word EPA | 1) while valid, 0 otherwise.
+        // Any store to the reserved word clears it.
+        std::atomic<uint32_t> resv;
+
+        bool halted;
+        uint64_t cycle;
+        uint64_t icount_int, icount_float, icount_all;
+
+        // Fetched instruction words, tagged by (PC | 1)
+        std::vector<uint32_t> itag, idata;
+        std::atomic<bool> icache_stale;
+
+        IssTlbEntry tlb[ISS_TLB_ENTRIES];
+        bool tlb_stale;
+
+        // Hardware barrier: the configuration CSR, the phase the
+        // host or kernel last wrote to Pi, and the number of
+        // barsends and completed barrecvs since then. Neighbors read
+        // barcfg and bar_sent while walking the barrier tree.
+        std::atomic<uint32_t> barcfg;
+        uint32_t bar_pi;
+        std::atomic<uint32_t> bar_sent;
+        uint32_t bar_recv;
+};
+
+struct IssBank {
+        std::unique_ptr<std::atomic<std::atomic<uint32_t> *>[]> pages;
+        std::mutex alloc_lock;
+
+        IssBank() : pages(new std::atomic<std::atomic<uint32_t> *>[ISS_BANK_PAGES]) {
+                for (unsigned i = 0; i < ISS_BANK_PAGES; i++)
+                        pages[i].store(nullptr);
+        }
+
+        ~IssBank() {
+                for (unsigned i = 0; i < ISS_BANK_PAGES; i++)
+                        delete [] pages[i].load();
+        }
+};
+
+/**
+ * Bits of a word written by a packet store mask
+ */
+static inline uint32_t iss_mask_bits(uint8_t mask)
+{
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++)
+                if (mask & (1 << i))
+                        bits |= 0xFFu << (8 * i);
+        return bits;
+}
+
+static inline void iss_store_masked(std::atomic<uint32_t> &w, uint32_t data, uint8_t mask)
+{
+        if (mask == HB_MC_PACKET_REQUEST_MASK_WORD) {
+                w.store(data, std::memory_order_release);
+                return;
+        }
+
+        uint32_t bits = iss_mask_bits(mask);
+        uint32_t old = w.load(std::memory_order_relaxed);
+        while (!w.compare_exchange_weak(old, (old & ~bits) | (data & bits)))
+                ;
+}
+
+static inline uint32_t iss_amo_compute(hb_mc_packet_op_t op, uint32_t old, uint32_t v)
+{
+        switch (op) {
+        case HB_MC_PACKET_OP_REMOTE_AMOSWAP: return v;
+        case HB_MC_PACKET_OP_REMOTE_AMOADD:  return old + v;
+        case HB_MC_PACKET_OP_REMOTE_AMOXOR:  return old ^ v;
+        case HB_MC_PACKET_OP_REMOTE_AMOAND:  return old & v;
+        case HB_MC_PACKET_OP_REMOTE_AMOOR:   return old | v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMIN:  return (int32_t)old < (int32_t)v ? old : v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMAX:  return (int32_t)old > (int32_t)v ? old : v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMINU: return old < v ? old : v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMAXU: return old > v ? old : v;
+        default:                             return old;
+        }
+}
+
+static inline uint32_t iss_amo_apply(std::atomic<uint32_t> &w, hb_mc_packet_op_t op, uint32_t v)
+{
+        uint32_t old = w.load(std::memory_order_relaxed);
+        while (!w.compare_exchange_weak(old, iss_amo_compute(op, old, v)))
+                ;
+        return old;
+}
+
+/**
+ * Break a core's LR reservation on a DMEM word
+ */
+static inline void iss_break_reservation(IssCore &c, hb_mc_epa_t epa)
+{
+        uint32_t r = epa | 1;
+        c.resv.compare_exchange_strong(r, 0);
+}
+
+/******************************************************************************/
+/* Construction                                                               */
+/******************************************************************************/
+
+static bool iss_read_rom(const std::string &path, hb_mc_config_raw_t *rom)
+{
+        std::ifstream in(path);
+        if (!in) {
+                bsg_pr_err("ISS: could not open configuration ROM '%s'\n", path.c_str());
+                return false;
+        }
+
+        std::string line;
+        unsigned idx = 0;
+        while (idx < HB_MC_CONFIG_MAX && std::getline(in, line)) {
+                if (line.empty())
+                        continue;
+                rom[idx++] = static_cast<hb_mc_config_raw_t>(strtoul(line.c_str(), nullptr, 2));
+        }
+
+        if (idx < HB_MC_CONFIG_MAX) {
+                bsg_pr_err("ISS: configuration ROM '%s' has %u of %d entries\n",
+                           path.c_str(), idx, HB_MC_CONFIG_MAX);
+                return false;
+        }
+        return true;
+}
+
+static unsigned iss_env(const char *name, unsigned dflt)
+{
+        const char *v = getenv(name);
+        if (v == nullptr || *v == '\0')
+                return dflt;
+        return static_cast<unsigned>(strtoul(v, nullptr, 0));
+}
+
+IssMachine::IssMachine(const std::string &rom_path)
+{
+        if (!iss_read_rom(rom_path, rom))
+                return;
+
+        if (hb_mc_config_init(rom, &cfg) != HB_MC_SUCCESS) {
+                bsg_pr_err("ISS: failed to parse configuration ROM '%s'\n", rom_path.c_str());
+                return;
+        }
+
+        dmem_size = hb_mc_config_get_dmem_size(&cfg);
+        size_t icache_words = hb_mc_config_get_icache_size(&cfg) / sizeof(uint32_t);
+        size_t ncoords = size_t(1) << (cfg.noc_coord_width.x + cfg.noc_coord_width.y);
+        core_idx.assign(ncoords, -1);
+        bank_idx.assign(ncoords, -1);
+
+        hb_mc_coordinate_t pod, co;
+        hb_mc_config_foreach_pod(pod, &cfg)
+        {
+                hb_mc_config_pod_foreach_vcore(co, pod, &cfg)
+                {
+                        IssCore *c = new IssCore;
+                        c->coord = co;
+                        c->dmem.reset(new std::atomic<uint32_t>[dmem_size / sizeof(uint32_t)]);
+                        for (size_t i = 0; i < dmem_size / sizeof(uint32_t); i++)
+                                c->dmem[i].store(0);
+                        c->freeze.store(true);
+                        c->tgo_x = c->tgo_y = c->pc_init = 0;
+                        c->pc = 0;
+                        memset(c->x, 0, sizeof(c->x));
+                        memset(c->f, 0, sizeof(c->f));
+                        c->frm = 0;
+                        c->resv.store(0);
+                        c->halted = false;
+                        c->cycle = 0;
+                        c->icount_int = c->icount_float = c->icount_all = 0;
+                        c->itag.assign(icache_words, 0);
+                        c->idata.assign(icache_words, 0);
+                        c->icache_stale.store(false);
+                        memset(c->tlb, 0, sizeof(c->tlb));
+                        c->tlb_stale = false;
+                        c->barcfg.store(0);
+                        c->bar_pi = 0;
+                        c->bar_sent.store(0);
+                        c->bar_recv = 0;
+
+                        core_idx[coord_index(co.x, co.y)] = cores.size();
+                        cores.emplace_back(c);
+                }
+
+                hb_mc_config_pod_foreach_dram(co, pod, &cfg)
+                {
+                        bank_idx[coord_index(co.x, co.y)] = banks.size();
+                        banks.emplace_back(new IssBank);
+                }
+        }
+
+        quantum = iss_env("BSG_ISS_QUANTUM", ISS_DEFAULT_QUANTUM);
+        if (quantum == 0)
+                quantum = ISS_DEFAULT_QUANTUM;
+
+        // Slice 0 runs on the calling thread
+        unsigned hw = std::thread::hardware_concurrency();
+        slices = iss_env("BSG_ISS_THREADS", hw ? hw : 1);
+        if (slices == 0)
+                slices = 1;
+        if (slices > cores.size())
+                slices = cores.size();
+
+        for (unsigned s = 1; s < slices; s++)
+                workers.emplace_back(&IssMachine::worker, this, s);
+
+        rom_valid = true;
+}
+
+IssMachine::~IssMachine()
+{
+        {
+                std::lock_guard<std::mutex> lock(pool_lock);
+                stopping = true;
+        }
+        pool_cv.notify_all();
+        for (auto &w : workers)
+                w.join();
+}
+
+size_t IssMachine::coord_index(hb_mc_idx_t x, hb_mc_idx_t y) const
+{
+        return (size_t(y) << cfg.noc_coord_width.x) | x;
+}
+
+IssCore *IssMachine::core_at(hb_mc_idx_t x, hb_mc_idx_t y) const
+{
+        size_t i = coord_index(x, y);
+        if (i >= core_idx.size() || core_idx[i] < 0)
+                return nullptr;
+        return cores[core_idx[i]].get();
+}
+
+IssBank *IssMachine::bank_at(hb_mc_idx_t x, hb_mc_idx_t y) const
+{
+        size_t i = coord_index(x, y);
+        if (i >= bank_idx.size() || bank_idx[i] < 0)
+                return nullptr;
+        return banks[bank_idx[i]].get();
+}
+
+/******************************************************************************/
+/* Endpoints                                                                  */
+/******************************************************************************/
+
+std::atomic<uint32_t> *IssMachine::bank_word(IssBank *bank, hb_mc_epa_t epa, bool allocate)
+{
+        unsigned p = epa >> ISS_PAGE_LOGSZ;
+        if (p >= ISS_BANK_PAGES)
+                return nullptr;
+
+        std::atomic<uint32_t> *page = bank->pages[p].load(std::memory_order_acquire);
+        if (page == nullptr) {
+                if (!allocate)
+                        return nullptr;
+
+                std::lock_guard<std::mutex> lock(bank->alloc_lock);
+                page = bank->pages[p].load(std::memory_order_acquire);
+                if (page == nullptr) {
+                        page = new std::atomic<uint32_t>[ISS_PAGE_WORDS];
+                        for (unsigned i = 0; i < ISS_PAGE_WORDS; i++)
+                                page[i].store(0, std::memory_order_relaxed);
+                        bank->pages[p].store(page, std::memory_order_release);
+                }
+        }
+        return &page[(epa & ((1u << ISS_PAGE_LOGSZ) - 1)) >> 2];
+}
+
+uint32_t IssMachine::csr_read(const IssCore &c, hb_mc_epa_t epa) const
+{
+        switch (epa) {
+        case HB_MC_TILE_EPA_CSR_FREEZE:               return c.freeze.load() ? 1 : 0;
+        case HB_MC_TILE_EPA_CSR_TILE_GROUP_ORIGIN_X:  return c.tgo_x;
+        case HB_MC_TILE_EPA_CSR_TILE_GROUP_ORIGIN_Y:  return c.tgo_y;
+        case HB_MC_TILE_EPA_CSR_PC_INIT_VALUE:        return c.pc_init;
+        default:                                      return 0;
+        }
+}
+
+void IssMachine::csr_write(IssCore &c, hb_mc_epa_t epa, uint32_t data)
+{
+        switch (epa) {
+        case HB_MC_TILE_EPA_CSR_FREEZE:
+                if (data & 1) {
+                        c.freeze.store(true);
+                        break;
+                }
+                if (!c.freeze.load())
+                        break;
+
+                // Unfreezing resets the core to PC_INIT. Nothing else
+                // about the machine changes while the host holds it,
+                // so this is also when cached translations are dropped.
+                if (mc != nullptr) {
+                        unsigned stripe = hb_mc_config_get_vcache_stripe_size(hb_mc_manycore_get_config(mc));
+                        granule_log = 2;
+                        while (granule_log < 5 && (2u << granule_log) <= stripe)
+                                granule_log++;
+                }
+                c.pc = c.pc_init;
+                memset(c.x, 0, sizeof(c.x));
+                memset(c.f, 0, sizeof(c.f));
+                c.frm = 0;
+                c.resv.store(0);
+                c.halted = false;
+                c.cycle = cycle;
+                c.icache_stale.store(true);
+                c.tlb_stale = true;
+                c.barcfg.store(0);
+                c.bar_pi = 0;
+                c.bar_sent.store(0);
+                c.bar_recv = 0;
+                c.freeze.store(false);
+                break;
+        case HB_MC_TILE_EPA_CSR_TILE_GROUP_ORIGIN_X:
+                c.tgo_x = data;
+                c.tlb_stale = true;
+                break;
+        case HB_MC_TILE_EPA_CSR_TILE_GROUP_ORIGIN_Y:
+                c.tgo_y = data;
+                c.tlb_stale = true;
+                break;
+        case HB_MC_TILE_EPA_CSR_PC_INIT_VALUE:
+                c.pc_init = data;
+                break;
+        default:
+                break;
+        }
+}
+
+bool IssMachine::load_word(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa, uint32_t *data)
+{
+        if (IssCore *c = core_at(x, y)) {
+                if (epa < dmem_size)
+                        *data = c->dmem[epa >> 2].load(std::memory_order_acquire);
+                else
+                        *data = csr_read(*c, epa);
+                return true;
+        }
+
+        if (IssBank *b = bank_at(x, y)) {
+                // Tag and other non-data EPAs read as zero
+                std::atomic<uint32_t> *w = epa < HB_MC_VCACHE_EPA_OFFSET_TAG ?
+                        bank_word(b, epa, false) : nullptr;
+                *data = w ? w->load(std::memory_order_acquire) : 0;
+                return true;
+        }
+
+        return false;
+}
+
+bool IssMachine::store_word(hb_mc_coordinate_t src, hb_mc_idx_t x, hb_mc_idx_t y,
+                            hb_mc_epa_t epa, uint32_t data, uint8_t mask)
+{
+        if (IssCore *c = core_at(x, y)) {
+                if (epa < dmem_size) {
+                        iss_store_masked(c->dmem[epa >> 2], data, mask);
+                        iss_break_reservation(*c, epa);
+                } else if (epa >= HB_MC_TILE_EPA_ICACHE_BASE) {
+                        // Instructions are fetched from DRAM; a write to
+                        // the icache only drops what was fetched so far.
+                        c->icache_stale.store(true);
+                } else if (mask == HB_MC_PACKET_REQUEST_MASK_WORD) {
+                        csr_write(*c, epa, data);
+                }
+                return true;
+        }
+
+        if (IssBank *b = bank_at(x, y)) {
+                // Tag writes (vcache init, flushes) have nothing to do
+                if (epa < HB_MC_VCACHE_EPA_OFFSET_TAG) {
+                        std::atomic<uint32_t> *w = bank_word(b, epa, true);
+                        if (w == nullptr)
+                                return false;
+                        iss_store_masked(*w, data, mask);
+                }
+                return true;
+        }
+
+        if (hb_mc_config_is_host(&cfg, hb_mc_coordinate(x, y))) {
+                hb_mc_packet_t pkt = {};
+                hb_mc_request_packet_set_x_dst(&pkt.request, x);
+                hb_mc_request_packet_set_y_dst(&pkt.request, y);
+                hb_mc_request_packet_set_x_src(&pkt.request, src.x);
+                hb_mc_request_packet_set_y_src(&pkt.request, src.y);
+                hb_mc_request_packet_set_epa(&pkt.request, epa);
+                hb_mc_request_packet_set_data(&pkt.request, data);
+                if (mask == HB_MC_PACKET_REQUEST_MASK_WORD) {
+                        hb_mc_request_packet_set_op(&pkt.request, HB_MC_PACKET_OP_REMOTE_SW);
+                } else {
+                        hb_mc_request_packet_set_op(&pkt.request, HB_MC_PACKET_OP_REMOTE_STORE);
+                        hb_mc_request_packet_set_mask(&pkt.request, static_cast<hb_mc_packet_mask_t>(mask));
+                }
+
+                std::lock_guard<std::mutex> lock(host_lock);
+                rx_req.push_back(pkt);
+                return true;
+        }
+
+        return false;
+}
+
+bool IssMachine::amo_word(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa,
+                          hb_mc_packet_op_t op, uint32_t operand, uint32_t *old)
+{
+        if (IssCore *c = core_at(x, y)) {
+                if (epa >= dmem_size)
+                        return false;
+                *old = iss_amo_apply(c->dmem[epa >> 2], op, operand);
+                iss_break_reservation(*c, epa);
+                return true;
+        }
+
+        if (IssBank *b = bank_at(x, y)) {
+                std::atomic<uint32_t> *w = epa < HB_MC_VCACHE_EPA_OFFSET_TAG ?
+                        bank_word(b, epa, true) : nullptr;
+                if (w == nullptr)
+                        return false;
+                *old = iss_amo_apply(*w, op, operand);
+                return true;
+        }
+
+        return false;
+}
+
+/******************************************************************************/
+/* Host Interface                                                             */
+/******************************************************************************/
+
+void IssMachine::host_request(const hb_mc_request_packet_t *rqst)
+{
+        hb_mc_idx_t x = hb_mc_request_packet_get_x_dst(rqst);
+        hb_mc_idx_t y = hb_mc_request_packet_get_y_dst(rqst);
+        hb_mc_coordinate_t src = hb_mc_coordinate(hb_mc_request_packet_get_x_src(rqst),
+                                                  hb_mc_request_packet_get_y_src(rqst));
+        hb_mc_epa_t epa = hb_mc_request_packet_get_epa(rqst);
+        hb_mc_packet_op_t op = static_cast<hb_mc_packet_op_t>(hb_mc_request_packet_get_op(rqst));
+        uint32_t data = hb_mc_request_packet_get_data(rqst);
+        bool ok = true, respond = false;
+
+        switch (op) {
+        case HB_MC_PACKET_OP_REMOTE_LOAD: {
+                hb_mc_request_packet_load_info_t info = hb_mc_request_packet_get_load_info(rqst);
+                uint32_t w = 0;
+                ok = load_word(x, y, epa, &w);
+                w >>= 8 * info.part_sel;
+                if (info.is_byte_op)
+                        data = info.is_unsigned_op ? (w & 0xFF) : (uint32_t)(int8_t)w;
+                else if (info.is_hex_op)
+                        data = info.is_unsigned_op ? (w & 0xFFFF) : (uint32_t)(int16_t)w;
+                else
+                        data = w;
+                respond = true;
+                break;
+        }
+        case HB_MC_PACKET_OP_REMOTE_STORE:
+                ok = store_word(src, x, y, epa, data, hb_mc_request_packet_get_mask(rqst));
+                break;
+        case HB_MC_PACKET_OP_REMOTE_SW:
+                ok = store_word(src, x, y, epa, data, HB_MC_PACKET_REQUEST_MASK_WORD);
+                break;
+        case HB_MC_PACKET_OP_CACHE_OP:
+                // There are no caches to maintain
+                break;
+        default:
+                if (op >= HB_MC_PACKET_OP_REMOTE_AMOSWAP && op <= HB_MC_PACKET_OP_REMOTE_AMOMAXU) {
+                        ok = amo_word(x, y, epa, op, data, &data);
+                        respond = true;
+                } else {
+                        ok = false;
+                }
+                break;
+        }
+
+        if (!ok) {
+                char buf[256];
+                bsg_pr_err("ISS: dropped host request %s\n",
+                           hb_mc_request_packet_to_string(rqst, buf, sizeof(buf)));
+                data = 0;
+        }
+
+        if (!respond)
+                return;
+
+        hb_mc_packet_t rsp = {};
+        hb_mc_response_packet_set_x_dst(&rsp.response, src.x);
+        hb_mc_response_packet_set_y_dst(&rsp.response, src.y);
+        hb_mc_response_packet_set_load_id(&rsp.response, hb_mc_request_packet_get_load_id(rqst));
+        hb_mc_response_packet_set_data(&rsp.response, data);
+        hb_mc_response_packet_set_op(&rsp.response, op);
+
+        std::lock_guard<std::mutex> lock(host_lock);
+        rx_rsp.push_back(rsp);
+}
+
+bool IssMachine::host_receive(hb_mc_fifo_rx_t type, hb_mc_packet_t *packet)
+{
+        std::lock_guard<std::mutex> lock(host_lock);
+        std::deque<hb_mc_packet_t> &q = (type == HB_MC_FIFO_RX_REQ) ? rx_req : rx_rsp;
+        if (q.empty())
+                return false;
+        *packet = q.front();
+        q.pop_front();
+        return true;
+}
+
+bool IssMachine::host_pending()
+{
+        std::lock_guard<std::mutex> lock(host_lock);
+        return !rx_req.empty() || !rx_rsp.empty();
+}
+
+bool IssMachine::dram_write(const hb_mc_npa_t *npa, const void *data, size_t sz)
+{
+        IssBank *b = bank_at(hb_mc_npa_get_x(npa), hb_mc_npa_get_y(npa));
+        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+        if (b == nullptr)
+                return false;
+
+        while (sz > 0) {
+                std::atomic<uint32_t> *w = bank_word(b, epa & ~3u, true);
+                unsigned off = epa & 3;
+                unsigned n = std::min<size_t>(4 - off, sz);
+                uint32_t v = 0;
+                uint8_t mask = 0;
+                if (w == nullptr)
+                        return false;
+                for (unsigned i = 0; i < n; i++) {
+                        v |= uint32_t(src[i]) << (8 * (off + i));
+                        mask |= 1 << (off + i);
+                }
+                iss_store_masked(*w, v, mask);
+                src += n;
+                epa += n;
+                sz -= n;
+        }
+        return true;
+}
+
+bool IssMachine::dram_read(const hb_mc_npa_t *npa, void *data, size_t sz)
+{
+        IssBank *b = bank_at(hb_mc_npa_get_x(npa), hb_mc_npa_get_y(npa));
+        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(data);
+        if (b == nullptr)
+                return false;
+
+        while (sz > 0) {
+                std::atomic<uint32_t> *w = bank_word(b, epa & ~3u, false);
+                unsigned off = epa & 3;
+                unsigned n = std::min<size_t>(4 - off, sz);
+                uint32_t v = w ? w->load(std::memory_order_acquire) : 0;
+                for (unsigned i = 0; i < n; i++)
+                        dst[i] = v >> (8 * (off + i));
+                dst += n;
+                epa += n;
+                sz -= n;
+        }
+        return true;
+}
+
+uint64_t IssMachine::get_icount(bsg_instr_type_e itype) const
+{
+        uint64_t n = 0;
+        for (auto &c : cores) {
+                switch (itype) {
+                case e_instr_float: n += c->icount_float; break;
+                case e_instr_int:   n += c->icount_int;   break;
+                default:            n += c->icount_all;   break;
+                }
+        }
+        return n;
+}
+
+/******************************************************************************/
+/* Scheduling                                                                 */
+/******************************************************************************/
+
+void IssMachine::eval()
+{
+        uint64_t until = cycle + quantum;
+        bool active = false;
+        for (auto &c : cores)
+                active |= !c->freeze.load(std::memory_order_relaxed) && !c->halted;
+
+        if (active) {
+                if (!workers.empty()) {
+                        {
+                                std::lock_guard<std::mutex> lock(pool_lock);
+                                target = until;
+                                pending = workers.size();
+                                generation++;
+                        }
+                        pool_cv.notify_all();
+                }
+
+                run_slice(0, until);
+
+                if (!workers.empty()) {
+                        std::unique_lock<std::mutex> lock(pool_lock);
+                        done_cv.wait(lock, [this] { return pending == 0; });
+                }
+        }
+
+        cycle = until;
+}
+
+void IssMachine::worker(unsigned slice)
+{
+        uint64_t seen = 0;
+        for (;;) {
+                uint64_t until;
+                {
+                        std::unique_lock<std::mutex> lock(pool_lock);
+                        pool_cv.wait(lock, [&] { return stopping || generation != seen; });
+                        if (stopping)
+                                return;
+                        seen = generation;
+                        until = target;
+                }
+
+                run_slice(slice, until);
+
+                {
+                        std::lock_guard<std::mutex> lock(pool_lock);
+                        if (--pending == 0)
+                                done_cv.notify_one();
+                }
+        }
+}
+
+void IssMachine::run_slice(unsigned slice, uint64_t until)
+{
+        for (size_t i = slice; i < cores.size(); i += slices)
+                run(*cores[i], until);
+}
+
+void IssMachine::run(IssCore &c, uint64_t until)
+{
+        if (c.freeze.load(std::memory_order_acquire) || c.halted)
+                return;
+
+        if (c.icache_stale.exchange(false))
+                std::fill(c.itag.begin(), c.itag.end(), 0);
+
+        if (c.tlb_stale) {
+                memset(c.tlb, 0, sizeof(c.tlb));
+                c.tlb_stale = false;
+        }
+
+        while (c.cycle < until && step(c, until))
+                ;
+}
+
+void IssMachine::fault(IssCore &c, const char *reason)
+{
+        iss_pr_err(c, "%s; halting tile\n", reason);
+        c.halted = true;
+}
+
+unsigned IssMachine::hops(const IssCore &c, hb_mc_idx_t x, hb_mc_idx_t y) const
+{
+        return std::abs(int(x) - int(c.coord.x)) + std::abs(int(y) - int(c.coord.y));
+}
+
+/******************************************************************************/
+/* Hardware barrier                                                           */
+/******************************************************************************/
+
+const IssCore *IssMachine::bar_link(const IssCore &c, unsigned dir) const
+{
+        int x = c.coord.x, y = c.coord.y;
+        int ruche = cfg.bar_ruche_factor.x;
+        switch (dir) {
+        case ISS_BAR_W:  x -= 1; break;
+        case ISS_BAR_E:  x += 1; break;
+        case ISS_BAR_N:  y -= 1; break;
+        case ISS_BAR_S:  y += 1; break;
+        case ISS_BAR_RW: x -= ruche; break;
+        case ISS_BAR_RE: x += ruche; break;
+        default: return nullptr;
+        }
+        if (x < 0 || y < 0)
+                return nullptr;
+        return core_at(x, y);
+}
+
+const IssCore *IssMachine::bar_root(const IssCore &c) const
+{
+        // A well-formed tree reaches its root in fewer hops than
+        // there are cores
+        const IssCore *t = &c;
+        for (size_t i = 0; t != nullptr && i < cores.size(); i++) {
+                unsigned out = (t->barcfg.load(std::memory_order_relaxed) >> ISS_BAR_OUTDIR_OFFSET) & 7;
+                if (out == ISS_BAR_ROOT)
+                        return t;
+                t = bar_link(*t, out);
+        }
+        return nullptr;
+}
+
+bool IssMachine::bar_done(const IssCore &c, uint32_t phase, size_t depth) const
+{
+        if (depth == 0)
+                return false;
+        if (c.bar_sent.load(std::memory_order_acquire) < phase)
+                return false;
+
+        uint32_t in = c.barcfg.load(std::memory_order_relaxed);
+        for (unsigned dir = ISS_BAR_W; dir <= ISS_BAR_RE; dir++) {
+                if (!(in & (1u << dir)))
+                        continue;
+                const IssCore *t = bar_link(c, dir);
+                if (t == nullptr || !bar_done(*t, phase, depth - 1))
+                        return false;
+        }
+        return true;
+}
+
+/******************************************************************************/
+/* Memory access from the cores                                               */
+/******************************************************************************/
+
+bool IssMachine::translate(IssCore &c, hb_mc_eva_t eva, hb_mc_npa_t *npa)
+{
+        hb_mc_eva_t base = eva & ~((1u << granule_log) - 1);
+        IssTlbEntry &e = c.tlb[(eva >> granule_log) % ISS_TLB_ENTRIES];
+        if (e.valid && e.tag == base) {
+                *npa = hb_mc_npa_from_x_y(e.x, e.y, e.epa + (eva - base));
+                return true;
+        }
+
+        hb_mc_coordinate_t origin = hb_mc_coordinate(c.tgo_x, c.tgo_y);
+        size_t sz;
+
+        // Cache the translation if the whole granule is contiguous
+        if (default_eva_to_npa(mc, &origin, &c.coord, &base, npa, &sz) == HB_MC_SUCCESS &&
+            sz >= (1u << granule_log)) {
+                e.tag = base;
+                e.x = hb_mc_npa_get_x(npa);
+                e.y = hb_mc_npa_get_y(npa);
+                e.epa = hb_mc_npa_get_epa(npa);
+                e.valid = true;
+                hb_mc_npa_set_epa(npa, e.epa + (eva - base));
+                return true;
+        }
+
+        return default_eva_to_npa(mc, &origin, &c.coord, &eva, npa, &sz) == HB_MC_SUCCESS;
+}
+
+bool IssMachine::fetch(IssCore &c, uint32_t *insn)
+{
+        size_t i = (c.pc >> 2) % c.itag.size();
+        if (c.itag[i] == (c.pc | 1)) {
+                *insn = c.idata[i];
+                return true;
+        }
+
+        hb_mc_npa_t npa;
+        if (!translate(c, c.pc | ISS_DRAM_BIT, &npa) ||
+            !load_word(hb_mc_npa_get_x(&npa), hb_mc_npa_get_y(&npa),
+                       hb_mc_npa_get_epa(&npa), insn)) {
+                fault(c, "instruction fetch failed");
+                return false;
+        }
+
+        c.itag[i] = c.pc | 1;
+        c.idata[i] = *insn;
+        c.cycle += ISS_LAT_IFETCH_MISS;
+        return true;
+}
+
+bool IssMachine::core_load(IssCore &c, hb_mc_eva_t eva, unsigned sz, bool sign, uint32_t *data)
+{
+        unsigned off = eva & 3;
+        uint32_t w;
+
+        if (off + sz > 4) {
+                fault(c, "misaligned load");
+                return false;
+        }
+
+        if (eva < dmem_size) {
+                w = c.dmem[eva >> 2].load(std::memory_order_acquire);
+        } else {
+                hb_mc_npa_t npa;
+                if (!translate(c, eva, &npa)) {
+                        fault(c, "load address does not translate");
+                        return false;
+                }
+                hb_mc_idx_t x = hb_mc_npa_get_x(&npa), y = hb_mc_npa_get_y(&npa);
+                if (!load_word(x, y, hb_mc_npa_get_epa(&npa) & ~3u, &w)) {
+                        fault(c, "load from an endpoint that does not respond");
+                        return false;
+                }
+                c.cycle += 2 * hops(c, x, y) + (bank_at(x, y) ? ISS_LAT_DRAM : ISS_LAT_TILE);
+        }
+
+        w >>= 8 * off;
+        switch (sz) {
+        case 1:  *data = sign ? (uint32_t)(int8_t)w  : (w & 0xFF);   break;
+        case 2:  *data = sign ? (uint32_t)(int16_t)w : (w & 0xFFFF); break;
+        default: *data = w; break;
+        }
+        return true;
+}
+
+bool IssMachine::core_store(IssCore &c, hb_mc_eva_t eva, unsigned sz, uint32_t data)
+{
+        unsigned off = eva & 3;
+        uint8_t mask = ((1u << sz) - 1) << off;
+        data <<= 8 * off;
+
+        if (off + sz > 4) {
+                fault(c, "misaligned store");
+                return false;
+        }
+
+        if (eva < dmem_size) {
+                iss_store_masked(c.dmem[eva >> 2], data, mask);
+                iss_break_reservation(c, eva & ~3u);
+                return true;
+        }
+
+        hb_mc_npa_t npa;
+        if (!translate(c, eva, &npa)) {
+                fault(c, "store address does not translate");
+                return false;
+        }
+        if (!store_word(c.coord, hb_mc_npa_get_x(&npa), hb_mc_npa_get_y(&npa),
+                        hb_mc_npa_get_epa(&npa) & ~3u, data, mask)) {
+                fault(c, "store to an endpoint that does not accept it");
+                return false;
+        }
+        return true;
+}
+
+bool IssMachine::core_amo(IssCore &c, hb_mc_eva_t eva, hb_mc_packet_op_t op,
+                          uint32_t operand, uint32_t *old)
+{
+        if (eva & 3) {
+                fault(c, "misaligned AMO");
+                return false;
+        }
+
+        if (eva < dmem_size) {
+                *old = iss_amo_apply(c.dmem[eva >> 2], op, operand);
+                iss_break_reservation(c, eva);
+                return true;
+        }
+
+        hb_mc_npa_t npa;
+        if (!translate(c, eva, &npa)) {
+                fault(c, "AMO address does not translate");
+                return false;
+        }
+        hb_mc_idx_t x = hb_mc_npa_get_x(&npa), y = hb_mc_npa_get_y(&npa);
+        if (!amo_word(x, y, hb_mc_npa_get_epa(&npa), op, operand, old)) {
+                fault(c, "AMO to an endpoint that does not support it");
+                return false;
+        }
+        c.cycle += 2 * hops(c, x, y) + ISS_LAT_AMO;
+        return true;
+}
+
+/******************************************************************************/
+/* RV32IMAF                                                                   */
+/******************************************************************************/
+
+static inline float iss_f(uint32_t bits)
+{
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+}
+
+static inline uint32_t iss_bits(float f)
+{
+        uint32_t bits;
+        if (std::isnan(f))
+                return 0x7FC00000; // canonical NaN
+        memcpy(&bits, &f, sizeof(bits));
+        return bits;
+}
+
+static inline float iss_round(float v, unsigned rm)
+{
+        switch (rm) {
+        case 1:  return std::trunc(v); // RTZ
+        case 2:  return std::floor(v); // RDN
+        case 3:  return std::ceil(v);  // RUP
+        case 4:  return std::round(v); // RMM
+        default: return std::nearbyint(v); // RNE
+        }
+}
+
+static inline uint32_t iss_fcvt_w(float v, unsigned rm)
+{
+        if (std::isnan(v))
+                return INT32_MAX;
+        float r = iss_round(v, rm);
+        if (r >= 2147483648.0f)
+                return INT32_MAX;
+        if (r < -2147483648.0f)
+                return (uint32_t)INT32_MIN;
+        return (uint32_t)(int32_t)r;
+}
+
+static inline uint32_t iss_fcvt_wu(float v, unsigned rm)
+{
+        if (std::isnan(v))
+                return UINT32_MAX;
+        float r = iss_round(v, rm);
+        if (r < 0.0f)
+                return 0;
+        if (r >= 4294967296.0f)
+                return UINT32_MAX;
+        return (uint32_t)r;
+}
+
+static inline uint32_t iss_fminmax(uint32_t a, uint32_t b, bool max)
+{
+        float fa = iss_f(a), fb = iss_f(b);
+        if (std::isnan(fa) && std::isnan(fb))
+                return 0x7FC00000;
+        if (std::isnan(fa))
+                return b;
+        if (std::isnan(fb))
+                return a;
+        if (fa == fb) // -0.0 < +0.0
+                return max ? (a & b) : (a | b);
+        return (max ? fa > fb : fa < fb) ? a : b;
+}
+
+static inline uint32_t iss_fclass(uint32_t a)
+{
+        float f = iss_f(a);
+        bool neg = a >> 31;
+        switch (std::fpclassify(f)) {
+        case FP_INFINITE:  return neg ? 1u << 0 : 1u << 7;
+        case FP_NORMAL:    return neg ? 1u << 1 : 1u << 6;
+        case FP_SUBNORMAL: return neg ? 1u << 2 : 1u << 5;
+        case FP_ZERO:      return neg ? 1u << 3 : 1u << 4;
+        default:           return (a & 0x00400000) ? 1u << 9 : 1u << 8; // quiet : signaling
+        }
+}
+
+static inline hb_mc_packet_op_t iss_amo_op(uint32_t funct5)
+{
+        switch (funct5) {
+        case 0x01: return HB_MC_PACKET_OP_REMOTE_AMOSWAP;
+        case 0x00: return HB_MC_PACKET_OP_REMOTE_AMOADD;
+        case 0x04: return HB_MC_PACKET_OP_REMOTE_AMOXOR;
+        case 0x0C: return HB_MC_PACKET_OP_REMOTE_AMOAND;
+        case 0x08: return HB_MC_PACKET_OP_REMOTE_AMOOR;
+        case 0x10: return HB_MC_PACKET_OP_REMOTE_AMOMIN;
+        case 0x14: return HB_MC_PACKET_OP_REMOTE_AMOMAX;
+        case 0x18: return HB_MC_PACKET_OP_REMOTE_AMOMINU;
+        case 0x1C: return HB_MC_PACKET_OP_REMOTE_AMOMAXU;
+        default:   return HB_MC_PACKET_OP_REMOTE_LOAD; // not an AMO
+        }
+}
+
+/**
+ * Execute one instruction. Returns false if the core cannot make
+ * progress for the rest of the quantum.
+ */
+bool IssMachine::step(IssCore &c, uint64_t until)
+{
+        uint32_t insn;
+        if (!fetch(c, &insn))
+                return false;
+
+        uint32_t *x = c.x, *f = c.f;
+        uint32_t opcode = insn & 0x7F;
+        uint32_t rd = (insn >> 7) & 0x1F;
+        uint32_t funct3 = (insn >> 12) & 0x7;
+        uint32_t rs1 = (insn >> 15) & 0x1F;
+        uint32_t rs2 = (insn >> 20) & 0x1F;
+        uint32_t rs3 = insn >> 27;
+        uint32_t funct7 = insn >> 25;
+        int32_t imm_i = (int32_t)insn >> 20;
+        int32_t imm_s = ((int32_t)insn >> 25 << 5) | ((insn >> 7) & 0x1F);
+        int32_t imm_b = ((int32_t)insn >> 31 << 12) | (((insn >> 7) & 1) << 11) |
+                ((insn >> 20) & 0x7E0) | ((insn >> 7) & 0x1E);
+        int32_t imm_j = ((int32_t)insn >> 31 << 20) | (insn & 0xFF000) |
+                (((insn >> 20) & 1) << 11) | ((insn >> 20) & 0x7FE);
+        uint32_t next = c.pc + 4;
+        uint32_t a = x[rs1], b = x[rs2], v;
+        bool is_float = false;
+
+        switch (opcode) {
+        case 0x37: // LUI
+                x[rd] = insn & 0xFFFFF000;
+                break;
+        case 0x17: // AUIPC
+                x[rd] = c.pc + (insn & 0xFFFFF000);
+                break;
+        case 0x6F: // JAL
+                x[rd] = next;
+                next = c.pc + imm_j;
+                break;
+        case 0x67: // JALR
+                next = (a + imm_i) & ~1u;
+                x[rd] = c.pc + 4;
+                break;
+        case 0x63: { // BRANCH
+                bool taken;
+                switch (funct3) {
+                case 0: taken = a == b; break;
+                case 1: taken = a != b; break;
+                case 4: taken = (int32_t)a < (int32_t)b; break;
+                case 5: taken = (int32_t)a >= (int32_t)b; break;
+                case 6: taken = a < b; break;
+                case 7: taken = a >= b; break;
+                default: fault(c, "illegal branch"); return false;
+                }
+                if (taken)
+                        next = c.pc + imm_b;
+                break;
+        }
+        case 0x03: // LOAD
+                if ((funct3 & 3) == 3 || funct3 > 5) {
+                        fault(c, "illegal load");
+                        return false;
+                }
+                if (!core_load(c, a + imm_i, 1u << (funct3 & 3), !(funct3 & 4), &v))
+                        return false;
+                x[rd] = v;
+                break;
+        case 0x23: // STORE
+                if (funct3 > 2) {
+                        fault(c, "illegal store");
+                        return false;
+                }
+                if (!core_store(c, a + imm_s, 1u << funct3, b))
+                        return false;
+                break;
+        case 0x13: { // OP-IMM
+                uint32_t shamt = rs2;
+                switch (funct3) {
+                case 0: x[rd] = a + imm_i; break;
+                case 1: x[rd] = a << shamt; break;
+                case 2: x[rd] = (int32_t)a < imm_i; break;
+                case 3: x[rd] = a < (uint32_t)imm_i; break;
+                case 4: x[rd] = a ^ imm_i; break;
+                case 5: x[rd] = (funct7 & 0x20) ? (uint32_t)((int32_t)a >> shamt) : a >> shamt; break;
+                case 6: x[rd] = a | imm_i; break;
+                case 7: x[rd] = a & imm_i; break;
+                }
+                break;
+        }
+        case 0x33: // OP
+                if (funct7 == 0x01) {
+                        int32_t sa = a, sb = b;
+                        switch (funct3) {
+                        case 0: v = a * b; break;
+                        case 1: v = (uint64_t)((int64_t)sa * (int64_t)sb) >> 32; break;
+                        case 2: v = (uint64_t)((int64_t)sa * (int64_t)(uint64_t)b) >> 32; break;
+                        case 3: v = ((uint64_t)a * (uint64_t)b) >> 32; break;
+                        case 4: v = b == 0 ? UINT32_MAX : (sa == INT32_MIN && sb == -1) ? a : (uint32_t)(sa / sb); break;
+                        case 5: v = b == 0 ? UINT32_MAX : a / b; break;
+                        case 6: v = b == 0 ? a : (sa == INT32_MIN && sb == -1) ? 0 : (uint32_t)(sa % sb); break;
+                        default: v = b == 0 ? a : a % b; break;
+                        }
+                        if (funct3 >= 4)
+                                c.cycle += ISS_LAT_IDIV;
+                        x[rd] = v;
+                        break;
+                }
+                switch (funct3 | (funct7 << 3)) {
+                case 0x000: x[rd] = a + b; break;
+                case 0x100: x[rd] = a - b; break;
+                case 0x001: x[rd] = a << (b & 0x1F); break;
+                case 0x002: x[rd] = (int32_t)a < (int32_t)b; break;
+                case 0x003: x[rd] = a < b; break;
+                case 0x004: x[rd] = a ^ b; break;
+                case 0x005: x[rd] = a >> (b & 0x1F); break;
+                case 0x105: x[rd] = (int32_t)a >> (b & 0x1F); break;
+                case 0x006: x[rd] = a | b; break;
+                case 0x007: x[rd] = a & b; break;
+                default: fault(c, "illegal ALU instruction"); return false;
+                }
+                break;
+        case 0x0F: // FENCE: remote operations complete in order
+                if (insn == ISS_INSN_BARSEND) {
+                        c.bar_sent.fetch_add(1, std::memory_order_release);
+                } else if (insn == ISS_INSN_BARRECV) {
+                        uint32_t phase = c.bar_recv + 1;
+                        if (c.bar_recv != c.bar_sent.load(std::memory_order_relaxed)) {
+                                const IssCore *root = bar_root(c);
+                                if (root == nullptr) {
+                                        fault(c, "hardware barrier has no root");
+                                        return false;
+                                }
+                                // Wait for the whole tree, like LR.W.AQ
+                                if (!bar_done(*root, phase, cores.size())) {
+                                        c.cycle = until;
+                                        return false;
+                                }
+                                c.bar_recv = phase;
+                        }
+                }
+                break;
+        case 0x73: { // SYSTEM
+                if (funct3 == 0) {
+                        if (insn == 0x10500073) { // WFI
+                                c.pc = next;
+                                c.cycle = until;
+                                return false;
+                        }
+                        fault(c, "unsupported system instruction");
+                        return false;
+                }
+                uint32_t csr = insn >> 20;
+                uint32_t src = (funct3 & 4) ? rs1 : a;
+                uint32_t old;
+                switch (csr) {
+                case 0x001: old = 0; break;             // fflags are not tracked
+                case 0x002: old = c.frm; break;
+                case 0x003: old = c.frm << 5; break;
+                case 0xC00: case 0xB00: old = c.cycle; break;
+                case 0xC80: case 0xB80: old = c.cycle >> 32; break;
+                case 0xC02: case 0xB02: old = c.icount_all; break;
+                case 0xC82: case 0xB82: old = c.icount_all >> 32; break;
+                case ISS_CSR_BARCFG: old = c.barcfg.load(std::memory_order_relaxed); break;
+                case ISS_CSR_BAR_PI: old = (c.bar_pi + c.bar_sent.load(std::memory_order_relaxed)) & 1; break;
+                default: old = 0; break;
+                }
+                uint32_t nv = old;
+                switch (funct3 & 3) {
+                case 1: nv = src; break;
+                case 2: nv = old | src; break;
+                case 3: nv = old & ~src; break;
+                }
+                if (csr == 0x002)
+                        c.frm = nv & 7;
+                else if (csr == 0x003)
+                        c.frm = (nv >> 5) & 7;
+                // CSRRS/CSRRC with x0 only read, so they must not
+                // restart the barrier
+                if ((funct3 & 3) == 1 || rs1 != 0) {
+                        if (csr == ISS_CSR_BARCFG) {
+                                c.barcfg.store(nv, std::memory_order_relaxed);
+                        } else if (csr == ISS_CSR_BAR_PI) {
+                                c.bar_pi = nv & 1;
+                                c.bar_sent.store(0, std::memory_order_relaxed);
+                                c.bar_recv = 0;
+                        }
+                }
+                x[rd] = old;
+                break;
+        }
+        case 0x2F: { // AMO
+                uint32_t funct5 = insn >> 27;
+                bool aq = (insn >> 26) & 1;
+                if (funct3 != 2) {
+                        fault(c, "illegal atomic");
+                        return false;
+                }
+                if (funct5 == 0x02) { // LR.W
+                        uint32_t r = c.resv.load();
+                        if (aq && r == (a | 1)) {
+                                // LR.W.AQ waits for the reservation to be broken
+                                c.cycle = until;
+                                return false;
+                        }
+                        if (!core_load(c, a, 4, false, &v))
+                                return false;
+                        c.resv.store(aq ? 0 : (a | 1));
+                        x[rd] = v;
+                } else if (funct5 == 0x03) { // SC.W
+                        uint32_t r = a | 1;
+                        bool held = c.resv.compare_exchange_strong(r, 0);
+                        if (held && !core_store(c, a, 4, b))
+                                return false;
+                        x[rd] = held ? 0 : 1;
+                } else {
+                        hb_mc_packet_op_t op = iss_amo_op(funct5);
+                        if (op == HB_MC_PACKET_OP_REMOTE_LOAD) {
+                                fault(c, "illegal atomic");
+                                return false;
+                        }
+                        if (!core_amo(c, a, op, b, &v))
+                                return false;
+                        x[rd] = v;
+                }
+                break;
+        }
+        case 0x07: // FLW
+                is_float = true;
+                if (funct3 != 2) {
+                        fault(c, "illegal floating-point load");
+                        return false;
+                }
+                if (!core_load(c, a + imm_i, 4, false, &v))
+                        return false;
+                f[rd] = v;
+                break;
+        case 0x27: // FSW
+                is_float = true;
+                if (funct3 != 2) {
+                        fault(c, "illegal floating-point store");
+                        return false;
+                }
+                if (!core_store(c, a + imm_s, 4, f[rs2]))
+                        return false;
+                break;
+        case 0x43: case 0x47: case 0x4B: case 0x4F: { // FMADD, FMSUB, FNMSUB, FNMADD
+                is_float = true;
+                float fa = iss_f(f[rs1]), fb = iss_f(f[rs2]), fc = iss_f(f[rs3]);
+                if (opcode == 0x4B || opcode == 0x4F)
+                        fa = -fa;
+                if (opcode == 0x47 || opcode == 0x4F)
+                        fc = -fc;
+                f[rd] = iss_bits(std::fma(fa, fb, fc));
+                break;
+        }
+        case 0x53: { // OP-FP
+                is_float = true;
+                float fa = iss_f(f[rs1]), fb = iss_f(f[rs2]);
+                unsigned rm = funct3 == 7 ? c.frm : funct3;
+                switch (funct7) {
+                case 0x00: f[rd] = iss_bits(fa + fb); break;
+                case 0x04: f[rd] = iss_bits(fa - fb); break;
+                case 0x08: f[rd] = iss_bits(fa * fb); break;
+                case 0x0C: f[rd] = iss_bits(fa / fb); c.cycle += ISS_LAT_FDIV; break;
+                case 0x2C: f[rd] = iss_bits(std::sqrt(fa)); c.cycle += ISS_LAT_FDIV; break;
+                case 0x10:
+                        switch (funct3) {
+                        case 0: f[rd] = (f[rs1] & 0x7FFFFFFF) | (f[rs2] & 0x80000000); break;
+                        case 1: f[rd] = (f[rs1] & 0x7FFFFFFF) | (~f[rs2] & 0x80000000); break;
+                        default: f[rd] = f[rs1] ^ (f[rs2] & 0x80000000); break;
+                        }
+                        break;
+                case 0x14: f[rd] = iss_fminmax(f[rs1], f[rs2], funct3 == 1); break;
+                case 0x50:
+                        switch (funct3) {
+                        case 2: x[rd] = fa == fb; break;
+                        case 1: x[rd] = fa < fb; break;
+                        default: x[rd] = fa <= fb; break;
+                        }
+                        break;
+                case 0x60: x[rd] = rs2 ? iss_fcvt_wu(fa, rm) : iss_fcvt_w(fa, rm); break;
+                case 0x68: f[rd] = iss_bits(rs2 ? (float)a : (float)(int32_t)a); break;
+                case 0x70: x[rd] = funct3 ? iss_fclass(f[rs1]) : f[rs1]; break;
+                case 0x78: f[rd] = a; break;
+                default: fault(c, "illegal floating-point instruction"); return false;
+                }
+                break;
+        }
+        default:
+                fault(c, "illegal instruction");
+                return false;
+        }
+
+        x[0] = 0;
+        c.pc = next;
+        c.cycle++;
+        c.icount_all++;
+        if (is_float)
+                c.icount_float++;
+        else
+                c.icount_int++;
+        return true;
+}
+
+/******************************************************************************/
+/* Registry                                                                   */
+/******************************************************************************/
+
+static std::map<std::string, IssMachine *> iss_machines;
+
+void hb_mc_iss_register(const std::string &root, IssMachine *iss)
+{
+        iss_machines[root] = iss;
+}
+
+void hb_mc_iss_unregister(const std::string &root)
+{
+        iss_machines.erase(root);
+}
+
+IssMachine *hb_mc_iss_lookup(const std::string &root)
+{
+        auto it = iss_machines.find(root);
+        return it == iss_machines.end() ? nullptr : it->second;
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// IssMachine is a functional model of a HammerBlade machine. It
+// interprets RV32IMAF on every vanilla core, keeps DMEM and DRAM
+// in host memory, and applies remote load/store/AMO packets directly
+// to the destination endpoint. There are no caches, no network, and
+// no DPI: host packets are serviced as soon as they are transmitted.
+
+#ifndef __BSG_MANYCORE_ISS_HPP
+#define __BSG_MANYCORE_ISS_HPP
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_eva.h>
+#include <bsg_manycore_fifo.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_packet.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct IssCore;
+struct IssBank;
+
+class IssMachine {
+public:
+        // Reads the configuration ROM at rom_path (ASCII, one
+        // 32-bit binary word per line) and builds every core and
+        // DRAM bank it describes.
+        IssMachine(const std::string &rom_path);
+        ~IssMachine();
+
+        // True if the configuration ROM was read successfully
+        bool valid() const { return rom_valid; }
+
+        // Raw configuration ROM word at idx
+        hb_mc_config_raw_t config_at(unsigned idx) const { return rom[idx]; }
+
+        // EVA translation for the cores goes through the runtime's
+        // default EVA map, which needs the manycore instance.
+        void attach(hb_mc_manycore_t *mc) { this->mc = mc; }
+
+        // Advance every unfrozen core by one quantum of cycles.
+        void eval();
+
+        // Service a request packet from the host. Loads and AMOs
+        // enqueue a response packet.
+        void host_request(const hb_mc_request_packet_t *rqst);
+
+        // Pop a packet destined for the host. Returns false if the
+        // FIFO is empty.
+        bool host_receive(hb_mc_fifo_rx_t type, hb_mc_packet_t *packet);
+
+        // True if a packet is waiting for the host in either FIFO
+        bool host_pending();
+
+        // Backdoor access to DRAM, used by the DMA feature. Returns
+        // false if #npa does not address a DRAM bank.
+        bool dram_write(const hb_mc_npa_t *npa, const void *data, size_t sz);
+        bool dram_read(const hb_mc_npa_t *npa, void *data, size_t sz);
+
+        uint64_t get_cycle() const { return cycle; }
+        uint64_t get_icount(bsg_instr_type_e itype) const;
+
+private:
+        // Cores and DRAM banks, indexed by NoC coordinate
+        IssCore *core_at(hb_mc_idx_t x, hb_mc_idx_t y) const;
+        IssBank *bank_at(hb_mc_idx_t x, hb_mc_idx_t y) const;
+        size_t coord_index(hb_mc_idx_t x, hb_mc_idx_t y) const;
+
+        // Endpoint semantics shared by host packets and remote
+        // operations from the cores. epa is word-aligned.
+        bool load_word(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa, uint32_t *data);
+        bool store_word(hb_mc_coordinate_t src, hb_mc_idx_t x, hb_mc_idx_t y,
+                        hb_mc_epa_t epa, uint32_t data, uint8_t mask);
+        bool amo_word(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa,
+                      hb_mc_packet_op_t op, uint32_t operand, uint32_t *old);
+        std::atomic<uint32_t> *bank_word(IssBank *bank, hb_mc_epa_t epa, bool allocate);
+
+        void csr_write(IssCore &c, hb_mc_epa_t epa, uint32_t data);
+        uint32_t csr_read(const IssCore &c, hb_mc_epa_t epa) const;
+
+        // Core execution
+        void run(IssCore &c, uint64_t until);
+        bool step(IssCore &c, uint64_t until);
+        bool fetch(IssCore &c, uint32_t *insn);
+        bool translate(IssCore &c, hb_mc_eva_t eva, hb_mc_npa_t *npa);
+        bool core_load(IssCore &c, hb_mc_eva_t eva, unsigned sz, bool sign, uint32_t *data);
+        bool core_store(IssCore &c, hb_mc_eva_t eva, unsigned sz, uint32_t data);
+        bool core_amo(IssCore &c, hb_mc_eva_t eva, hb_mc_packet_op_t op,
+                      uint32_t operand, uint32_t *old);
+        void fault(IssCore &c, const char *reason);
+        unsigned hops(const IssCore &c, hb_mc_idx_t x, hb_mc_idx_t y) const;
+
+        // Hardware barrier tree. bar_link follows one direction from
+        // a tile, bar_root follows the output directions to the root,
+        // and bar_done is true once every tile below c has executed
+        // #phase barsends.
+        const IssCore *bar_link(const IssCore &c, unsigned dir) const;
+        const IssCore *bar_root(const IssCore &c) const;
+        bool bar_done(const IssCore &c, uint32_t phase, size_t depth) const;
+
+        // Worker threads each run an interleaved slice of the cores
+        void run_slice(unsigned slice, uint64_t until);
+        void worker(unsigned slice);
+
+        hb_mc_config_raw_t rom[HB_MC_CONFIG_MAX] = {};
+        bool rom_valid = false;
+        hb_mc_config_t cfg;
+        hb_mc_manycore_t *mc = nullptr;
+
+        std::vector<std::unique_ptr<IssCore>> cores;
+        std::vector<std::unique_ptr<IssBank>> banks;
+        std::vector<int> core_idx;
+        std::vector<int> bank_idx;
+        size_t dmem_size;
+        unsigned granule_log = 2;
+
+        std::mutex host_lock;
+        std::deque<hb_mc_packet_t> rx_req;
+        std::deque<hb_mc_packet_t> rx_rsp;
+
+        uint64_t cycle = 0;
+        uint64_t quantum;
+
+        unsigned slices;
+        std::vector<std::thread> workers;
+        std::mutex pool_lock;
+        std::condition_variable pool_cv;
+        std::condition_variable done_cv;
+        uint64_t generation = 0;
+        uint64_t target = 0;
+        unsigned pending = 0;
+        bool stopping = false;
+};
+
+// SimulationWrapper registers its machine under getRoot() so that the
+// platform layer can find it, the same way DPI platforms look up their
+// interfaces by hierarchy.
+void hb_mc_iss_register(const std::string &root, IssMachine *iss);
+void hb_mc_iss_unregister(const std::string &root);
+IssMachine *hb_mc_iss_lookup(const std::string &root);
+
+// The machine behind a manycore instance (defined by the platform)
+IssMachine *hb_mc_platform_get_iss(hb_mc_manycore_t *mc);
+
+#endif // __BSG_MANYCORE_ISS_HPP
@@ -0,0 +1,391 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_platform.h>
+#include <bsg_manycore_printing.h>
+
+#include <bsg_manycore_simulator.hpp>
+#include <bsg_manycore_iss.hpp>
+
+#include <set>
+#include <map>
+
+/* these are convenience macros that are only good for one line prints */
+#define manycore_pr_dbg(mc, fmt, ...)                   \
+        bsg_pr_dbg("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define manycore_pr_err(mc, fmt, ...)                   \
+        bsg_pr_err("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define manycore_pr_warn(mc, fmt, ...)                          \
+        bsg_pr_warn("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+#define manycore_pr_info(mc, fmt, ...)                          \
+        bsg_pr_info("%s: " fmt, mc->name, ##__VA_ARGS__)
+
+typedef struct hb_mc_platform_t {
+        SimulationWrapper *top;
+        IssMachine *iss;
+        hb_mc_manycore_id_t id;
+} hb_mc_platform_t;
+
+// These track active manycore machine IDs, and top-level
+// instantiations.
+static std::set<hb_mc_manycore_id_t> active_ids;
+static std::map<hb_mc_manycore_id_t,SimulationWrapper*> machines;
+
+/**
+ * Get the instruction set simulator behind a manycore instance
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return The IssMachine, or nullptr if the platform is not initialized.
+ */
+IssMachine *hb_mc_platform_get_iss(hb_mc_manycore_t *mc)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        return platform ? platform->iss : nullptr;
+}
+
+/**
+ * Clean up the runtime platform
+ * @param[in] mc    A manycore to clean up
+ */
+void hb_mc_platform_cleanup(hb_mc_manycore_t *mc)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        // Remove the key
+        auto key = active_ids.find(platform->id);
+        active_ids.erase(key);
+
+        auto m = machines.find(platform->id);
+        if(m != machines.end()){
+                delete m->second;
+                machines.erase(m);
+        } else {
+                // Possible causes: Cleanup before init, memory corruption
+                manycore_pr_err(mc, "Machine ID %d was not found during platform cleanup. Memory corruption?", platform->id);
+        }
+
+        delete platform;
+        mc->platform = nullptr;
+        return;
+}
+
+/**
+ * Initialize the runtime platform
+ * @param[in] mc    A manycore to initialize
+ * @param[in] id    ID which selects the physical hardware from which this manycore is configured
+ * @return HB_MC_FAIL if an error occured. HB_MC_SUCCESS otherwise.
+ */
+int hb_mc_platform_init(hb_mc_manycore_t *mc, hb_mc_manycore_id_t id)
+{
+        hb_mc_platform_t *platform;
+
+        // check if mc is already initialized
+        if (mc->platform)
+                return HB_MC_INITIALIZED_TWICE;
+
+        if (id != 0) {
+                manycore_pr_err(mc, "Failed to init platform: invalid ID\n");
+                return HB_MC_INVALID;
+        }
+
+        // Check if the ID has already been initialized
+        if(active_ids.find(id) != active_ids.end()){
+                manycore_pr_err(mc, "Already initialized ID\n");
+                return HB_MC_INVALID;
+        }
+
+        // Instantiate the machine and put it in the map. If it has
+        // already been instantiated, don't instantiate it again.
+        auto m = machines.find(id);
+        if(m == machines.end()){
+                machines[id] = new SimulationWrapper();
+        }
+
+        platform = new hb_mc_platform_t;
+        platform->top = machines[id];
+        platform->iss = hb_mc_iss_lookup(platform->top->getRoot());
+        platform->id = id;
+
+        if (platform->iss == nullptr || !platform->iss->valid()) {
+                manycore_pr_err(mc, "Failed to init platform: no configuration ROM. "
+                                "Set BSG_ISS_CONFIG_ROM to bsg_bladerunner_configuration.rom\n");
+                delete platform;
+                return HB_MC_INVALID;
+        }
+
+        active_ids.insert(id);
+        platform->iss->attach(mc);
+        mc->platform = reinterpret_cast<void *>(platform);
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Transmit a packet to manycore hardware
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] request A request packet to transmit to manycore hardware
+ * @param[in] timeout Unused: the ISS never refuses a packet.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit(hb_mc_manycore_t *mc,
+                            hb_mc_packet_t *packet,
+                            hb_mc_fifo_tx_t type,
+                            long timeout)
+{
+        return hb_mc_platform_transmit_batch(mc, packet, 1, type, timeout);
+}
+
+/**
+ * Transmit an array of packets to manycore hardware, in order.
+ * Each request is applied to its destination as soon as it is
+ * transmitted; the ISS does not advance.
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] packets An array of #n packets to transmit to manycore hardware
+ * @param[in] n       The number of packets
+ * @param[in] timeout Unused: the ISS never refuses a packet.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_transmit_batch(hb_mc_manycore_t *mc,
+                                  hb_mc_packet_t *packets,
+                                  size_t n,
+                                  hb_mc_fifo_tx_t type,
+                                  long timeout)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        if (type == HB_MC_FIFO_TX_RSP) {
+                manycore_pr_err(mc, "TX Response Not Supported!\n");
+                return HB_MC_NOIMPL;
+        }
+
+        for (size_t i = 0; i < n; i++)
+                platform->iss->host_request(&packets[i].request);
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Receive a packet from manycore hardware
+ * @param[in] mc       A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] response A packet into which data should be read
+ * @param[in] timeout  The number of ISS quanta to run while no packet is available, or -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. HB_MC_TIMEOUT if #timeout retries were exhausted.
+ *         Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_receive(hb_mc_manycore_t *mc,
+                           hb_mc_packet_t *packet,
+                           hb_mc_fifo_rx_t type,
+                           long timeout)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+        long retries = 0;
+
+        if (type != HB_MC_FIFO_RX_REQ && type != HB_MC_FIFO_RX_RSP) {
+                manycore_pr_err(mc, "%s: Unknown packet type\n", __func__);
+                return HB_MC_NOIMPL;
+        }
+
+        while (!platform->iss->host_receive(type, packet)) {
+                if (timeout != -1 && retries++ >= timeout)
+                        return HB_MC_TIMEOUT;
+
+                platform->top->eval();
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Read the configuration register at an index
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in]  idx    Configuration register index to access
+ * @param[out] config Configuration value at index
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_config_at(hb_mc_manycore_t *mc,
+                                 unsigned int idx,
+                                 hb_mc_config_raw_t *config)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        if(idx < HB_MC_CONFIG_MAX){
+                *config = platform->iss->config_at(idx);
+                return HB_MC_SUCCESS;
+        }
+
+        return HB_MC_INVALID;
+}
+
+/**
+ * Stall until the all requests (and responses) have reached their destination.
+ * Requests are applied when they are transmitted, so there is nothing to wait for.
+ * @param[in] mc      A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] timeout A timeout counter. Unused - set to -1 to wait forever.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_fence(hb_mc_manycore_t *mc, long timeout)
+{
+        if (timeout != -1) {
+                manycore_pr_err(mc, "%s: Only a timeout value of -1 is supported\n",
+                                __func__);
+                return HB_MC_NOIMPL;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Signal the hardware to start a bulk transfer over the network
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_start_bulk_transfer(hb_mc_manycore_t *mc)
+{
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Signal the hardware to end a bulk transfer over the network
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_finish_bulk_transfer(hb_mc_manycore_t *mc)
+{
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Get the current cycle counter of the Manycore Platform
+ *
+ * @param[in]  mc     A manycore instance initialized with hb_mc_manycore_init()
+ * @param[out] time   The current counter value.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_cycle(hb_mc_manycore_t *mc, uint64_t *time)
+{
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        *time = platform->iss->get_cycle();
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Get the number of instructions executed for a certain class of instructions
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] itype An enum defining the class of instructions to query.
+ * @param[out] count The number of instructions executed in the queried class.
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_get_icount(hb_mc_manycore_t *mc, bsg_instr_type_e itype, int *count){
+        hb_mc_platform_t *platform = reinterpret_cast<hb_mc_platform_t *>(mc->platform);
+
+        *count = static_cast<int>(platform->iss->get_icount(itype));
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Enable trace file generation (vanilla_operation_trace.csv)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_trace_enable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Disable trace file generation (vanilla_operation_trace.csv)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_trace_disable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Enable log file generation (vanilla.log)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_log_enable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Disable log file generation (vanilla.log)
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_log_disable(hb_mc_manycore_t *mc){
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Check if chip reset has completed.
+ * The ISS comes out of reset when it is constructed.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_platform_wait_reset_done(hb_mc_manycore_t *mc)
+{
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Save the state of the manycore hardware to a checkpoint.
+ * Not supported on this platform.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path  The checkpoint file
+ * @return HB_MC_NOIMPL
+ */
+int hb_mc_platform_checkpoint_save(hb_mc_manycore_t *mc, const char *path)
+{
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
+
+/**
+ * Replace the state of the manycore hardware with a checkpoint.
+ * Not supported on this platform.
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] path  The checkpoint file
+ * @return HB_MC_NOIMPL
+ */
+int hb_mc_platform_checkpoint_restore(hb_mc_manycore_t *mc, const char *path)
+{
+        manycore_pr_warn(mc, "%s: Not supported.\n", __func__);
+        return HB_MC_NOIMPL;
+}
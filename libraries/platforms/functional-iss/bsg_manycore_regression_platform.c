@@ -0,0 +1,61 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <stdint.h>
+#include <unistd.h>
+#include <bsg_manycore_regression.h>
+#include <dlfcn.h>
+
+// This function is main for the functional ISS
+int main(int argc, char **argv) {
+
+        // As on the Verilator platform, the executable is compiled
+        // once per machine and the program is loaded as a shared
+        // object file. This shared object is passed as the string
+        // sopath and _must_ define a method vcs_main that can be
+        // called as the main function of the program
+        char *sopath = argv[1];
+        void *handle = dlopen(sopath, RTLD_LAZY | RTLD_DEEPBIND);
+        if (handle == NULL) {
+                bsg_pr_err("Error when loading %s: %s\n", sopath, dlerror());
+                return HB_MC_FAIL;
+        }
+
+        int (*vcs_main)(int , char **) = (int (*)(int, char **)) dlsym(handle, "vcs_main");
+        if (vcs_main == NULL) {
+                bsg_pr_err("Error when finding dynamically loaded symbol vcs_main: %s\n", dlerror());
+                dlclose(handle);
+                return HB_MC_FAIL;
+        }
+
+        argv[1] = argv[0];
+        int rc = (*vcs_main)(argc-1, &argv[1]);
+
+        dlclose(handle);
+        bsg_pr_test_pass_fail(rc == HB_MC_SUCCESS);
+        return rc;
+}
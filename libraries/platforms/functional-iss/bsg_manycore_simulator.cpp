@@ -0,0 +1,86 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file implements the SimulationWrapper object for the
+// functional ISS. There is no RTL: eval() advances the instruction
+// set simulator by one quantum.
+
+#include <bsg_manycore_simulator.hpp>
+#include <bsg_manycore_errno.h>
+#include <bsg_manycore_iss.hpp>
+#include <bsg_manycore_printing.h>
+
+#include <cstdlib>
+
+SimulationWrapper::SimulationWrapper(){
+        const char *rom = getenv("BSG_ISS_CONFIG_ROM");
+        IssMachine *iss = new IssMachine(rom ? rom : "bsg_bladerunner_configuration.rom");
+
+        root = new std::string("functional_iss");
+        top = iss;
+        hb_mc_iss_register(*root, iss);
+}
+
+// Does nothing. There are no assertions to turn on or off.
+void SimulationWrapper::assertOn(bool val){
+
+}
+
+std::string SimulationWrapper::getRoot(){
+        return *root;
+}
+
+void SimulationWrapper::eval(){
+        reinterpret_cast<IssMachine *>(top)->eval();
+}
+
+uint64_t SimulationWrapper::idle(uint64_t cycles){
+        IssMachine *iss = reinterpret_cast<IssMachine *>(top);
+        uint64_t start = iss->get_cycle();
+
+        do {
+                iss->eval();
+        } while (iss->get_cycle() - start < cycles && !iss->host_pending());
+
+        return iss->get_cycle() - start;
+}
+
+// Checkpointing is not supported by the functional model.
+int SimulationWrapper::save(const std::string &path){
+        return HB_MC_NOIMPL;
+}
+
+int SimulationWrapper::restore(const std::string &path){
+        return HB_MC_NOIMPL;
+}
+
+SimulationWrapper::~SimulationWrapper(){
+        hb_mc_iss_unregister(*root);
+        delete reinterpret_cast<IssMachine *>(top);
+        delete root;
+        this->top = nullptr;
+}
@@ -0,0 +1,56 @@
+# Copyright (c) 2019, University of Washington All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# Redistributions of source code must retain the above copyright notice, this list
+# of conditions and the following disclaimer.
+#
+# Redistributions in binary form must reproduce the above copyright notice, this
+# list of conditions and the following disclaimer in the documentation and/or
+# other materials provided with the distribution.
+#
+# Neither the name of the copyright holder nor the names of its contributors may
+# be used to endorse or promote products derived from this software without
+# specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+# ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# execution.mk: Platform-specific execution rules.
+#
+# The ISS reads the machine's configuration ROM at startup.
+# BSG_ISS_THREADS sets the number of host threads (default: one per
+# host CPU). BSG_ISS_QUANTUM sets how many cycles each core runs
+# between synchronizations (default: 1000).
+
+.PRECIOUS: exec.log serial.log
+.PHONY: platform.execution.clean
+
+exec.log serial.log: $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/exec/simsc
+
+serial.log: export BSG_ISS_THREADS = 1
+
+%.log: main.so $(BSG_MANYCORE_KERNELS)
+	BSG_ISS_CONFIG_ROM=$(BSG_MACHINE_PATH)/bsg_bladerunner_configuration.rom \
+	$(filter %/simsc, $^) $(CURDIR)/main.so $(C_ARGS) 2>&1 | tee $@
+
+platform.execution.clean:
+	rm -rf exec.log serial.log
+
+execution.clean: platform.execution.clean
+
+help:
+	@echo "Usage:"
+	@echo "make {clean | exec.log | serial.log }"
+	@echo "      exec.log: Run program on the functional ISS, one host thread per CPU"
+	@echo "      serial.log: Run program on the functional ISS with one host thread (deterministic)"
+	@echo "      clean: Remove all subdirectory-specific outputs"
@@ -0,0 +1,353 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <bsg_manycore_loopback.hpp>
+#include <bsg_manycore_loopback.h>
+#include <bsg_manycore_printing.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+/**
+ * Key of the word that holds an EPA in the sparse store
+ */
+static inline uint64_t loopback_key(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa)
+{
+        return (uint64_t(x) << 48) | (uint64_t(y) << 32) | (epa & ~3u);
+}
+
+/**
+ * Bits of a word written by a packet store mask
+ */
+static inline uint32_t loopback_mask_bits(uint8_t mask)
+{
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++)
+                if (mask & (1 << i))
+                        bits |= 0xFFu << (8 * i);
+        return bits;
+}
+
+static inline uint32_t loopback_amo_compute(hb_mc_packet_op_t op, uint32_t old, uint32_t v)
+{
+        switch (op) {
+        case HB_MC_PACKET_OP_REMOTE_AMOSWAP: return v;
+        case HB_MC_PACKET_OP_REMOTE_AMOADD:  return old + v;
+        case HB_MC_PACKET_OP_REMOTE_AMOXOR:  return old ^ v;
+        case HB_MC_PACKET_OP_REMOTE_AMOAND:  return old & v;
+        case HB_MC_PACKET_OP_REMOTE_AMOOR:   return old | v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMIN:  return (int32_t)old < (int32_t)v ? old : v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMAX:  return (int32_t)old > (int32_t)v ? old : v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMINU: return old < v ? old : v;
+        case HB_MC_PACKET_OP_REMOTE_AMOMAXU: return old > v ? old : v;
+        default:                             return old;
+        }
+}
+
+/******************************************************************************/
+/* Construction                                                               */
+/******************************************************************************/
+
+static bool loopback_read_rom(const std::string &path, hb_mc_config_raw_t *rom)
+{
+        std::ifstream in(path);
+        if (!in) {
+                bsg_pr_err("Loopback: could not open configuration ROM '%s'\n", path.c_str());
+                return false;
+        }
+
+        std::string line;
+        unsigned idx = 0;
+        while (idx < HB_MC_CONFIG_MAX && std::getline(in, line)) {
+                if (line.empty())
+                        continue;
+                rom[idx++] = static_cast<hb_mc_config_raw_t>(strtoul(line.c_str(), nullptr, 2));
+        }
+
+        if (idx < HB_MC_CONFIG_MAX) {
+                bsg_pr_err("Loopback: configuration ROM '%s' has %u of %d entries\n",
+                           path.c_str(), idx, HB_MC_CONFIG_MAX);
+                return false;
+        }
+        return true;
+}
+
+LoopbackMachine::LoopbackMachine(const std::string &rom_path)
+{
+        if (!loopback_read_rom(rom_path, rom))
+                return;
+
+        if (hb_mc_config_init(rom, &cfg) != HB_MC_SUCCESS) {
+                bsg_pr_err("Loopback: failed to parse configuration ROM '%s'\n", rom_path.c_str());
+                return;
+        }
+
+        rom_valid = true;
+}
+
+/******************************************************************************/
+/* Memory                                                                     */
+/******************************************************************************/
+
+bool LoopbackMachine::is_dram(hb_mc_idx_t x, hb_mc_idx_t y) const
+{
+        return hb_mc_config_is_dram(&cfg, hb_mc_coordinate(x, y));
+}
+
+bool LoopbackMachine::is_endpoint(hb_mc_idx_t x, hb_mc_idx_t y) const
+{
+        hb_mc_coordinate_t co = hb_mc_coordinate(x, y);
+        return hb_mc_config_is_vanilla_core(&cfg, co) || hb_mc_config_is_dram(&cfg, co);
+}
+
+uint32_t &LoopbackMachine::word(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa)
+{
+        return mem[loopback_key(x, y, epa)];
+}
+
+uint32_t LoopbackMachine::peek(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa) const
+{
+        auto it = mem.find(loopback_key(x, y, epa));
+        return it == mem.end() ? 0 : it->second;
+}
+
+/******************************************************************************/
+/* Host Interface                                                             */
+/******************************************************************************/
+
+bool LoopbackMachine::host_request(const hb_mc_request_packet_t *rqst)
+{
+        hb_mc_idx_t x = hb_mc_request_packet_get_x_dst(rqst);
+        hb_mc_idx_t y = hb_mc_request_packet_get_y_dst(rqst);
+        hb_mc_epa_t epa = hb_mc_request_packet_get_epa(rqst);
+        hb_mc_packet_op_t op = static_cast<hb_mc_packet_op_t>(hb_mc_request_packet_get_op(rqst));
+        uint32_t data = hb_mc_request_packet_get_data(rqst);
+        bool ok = is_endpoint(x, y), respond = false;
+
+        switch (op) {
+        case HB_MC_PACKET_OP_REMOTE_LOAD: {
+                hb_mc_request_packet_load_info_t info = hb_mc_request_packet_get_load_info(rqst);
+                uint32_t w = ok ? peek(x, y, epa) >> (8 * info.part_sel) : 0;
+                if (info.is_byte_op)
+                        data = info.is_unsigned_op ? (w & 0xFF) : (uint32_t)(int8_t)w;
+                else if (info.is_hex_op)
+                        data = info.is_unsigned_op ? (w & 0xFFFF) : (uint32_t)(int16_t)w;
+                else
+                        data = w;
+                respond = true;
+                break;
+        }
+        case HB_MC_PACKET_OP_REMOTE_STORE:
+                if (ok) {
+                        uint32_t bits = loopback_mask_bits(hb_mc_request_packet_get_mask(rqst));
+                        uint32_t &w = word(x, y, epa);
+                        w = (w & ~bits) | (data & bits);
+                }
+                break;
+        case HB_MC_PACKET_OP_REMOTE_SW:
+                if (ok)
+                        word(x, y, epa) = data;
+                break;
+        case HB_MC_PACKET_OP_CACHE_OP:
+                // There are no caches to maintain
+                break;
+        default:
+                if (op >= HB_MC_PACKET_OP_REMOTE_AMOSWAP && op <= HB_MC_PACKET_OP_REMOTE_AMOMAXU) {
+                        uint32_t old = 0;
+                        if (ok) {
+                                uint32_t &w = word(x, y, epa);
+                                old = w;
+                                w = loopback_amo_compute(op, old, data);
+                        }
+                        data = old;
+                        respond = true;
+                } else {
+                        ok = false;
+                }
+                break;
+        }
+
+        // A dropped load or AMO still gets a response, so that the
+        // host does not wait for it forever.
+        if (!ok) {
+                char buf[256];
+                bsg_pr_err("Loopback: dropped host request %s\n",
+                           hb_mc_request_packet_to_string(rqst, buf, sizeof(buf)));
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        cycle++;
+        if (!respond)
+                return ok;
+
+        hb_mc_packet_t rsp = {};
+        hb_mc_response_packet_set_x_dst(&rsp.response, hb_mc_request_packet_get_x_src(rqst));
+        hb_mc_response_packet_set_y_dst(&rsp.response, hb_mc_request_packet_get_y_src(rqst));
+        hb_mc_response_packet_set_load_id(&rsp.response, hb_mc_request_packet_get_load_id(rqst));
+        hb_mc_response_packet_set_data(&rsp.response, data);
+        hb_mc_response_packet_set_op(&rsp.response, op);
+        rx_rsp.push_back(rsp);
+        return ok;
+}
+
+bool LoopbackMachine::host_receive(hb_mc_fifo_rx_t type, hb_mc_packet_t *packet, long timeout)
+{
+        std::unique_lock<std::mutex> guard(lock);
+        std::deque<hb_mc_packet_t> &q = (type == HB_MC_FIFO_RX_REQ) ? rx_req : rx_rsp;
+
+        if (timeout == -1)
+                rx_cv.wait(guard, [&q] { return !q.empty(); });
+
+        if (q.empty())
+                return false;
+
+        *packet = q.front();
+        q.pop_front();
+        cycle++;
+        return true;
+}
+
+bool LoopbackMachine::tile_request(const hb_mc_request_packet_t *rqst)
+{
+        hb_mc_coordinate_t dst = hb_mc_coordinate(hb_mc_request_packet_get_x_dst(rqst),
+                                                  hb_mc_request_packet_get_y_dst(rqst));
+        if (!hb_mc_config_is_host(&cfg, dst))
+                return false;
+
+        hb_mc_packet_t pkt = {};
+        pkt.request = *rqst;
+
+        std::lock_guard<std::mutex> guard(lock);
+        rx_req.push_back(pkt);
+        rx_cv.notify_all();
+        return true;
+}
+
+bool LoopbackMachine::dram_write(const hb_mc_npa_t *npa, const void *data, size_t sz)
+{
+        hb_mc_idx_t x = hb_mc_npa_get_x(npa), y = hb_mc_npa_get_y(npa);
+        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+        if (!is_dram(x, y))
+                return false;
+
+        while (sz > 0) {
+                unsigned off = epa & 3;
+                unsigned n = std::min<size_t>(4 - off, sz);
+                uint32_t v = 0, bits = 0;
+                for (unsigned i = 0; i < n; i++) {
+                        v |= uint32_t(src[i]) << (8 * (off + i));
+                        bits |= 0xFFu << (8 * (off + i));
+                }
+                uint32_t &w = word(x, y, epa);
+                w = (w & ~bits) | v;
+                src += n;
+                epa += n;
+                sz -= n;
+        }
+        return true;
+}
+
+bool LoopbackMachine::dram_read(const hb_mc_npa_t *npa, void *data, size_t sz)
+{
+        hb_mc_idx_t x = hb_mc_npa_get_x(npa), y = hb_mc_npa_get_y(npa);
+        hb_mc_epa_t epa = hb_mc_npa_get_epa(npa);
+        uint8_t *dst = reinterpret_cast<uint8_t *>(data);
+        if (!is_dram(x, y))
+                return false;
+
+        while (sz > 0) {
+                unsigned off = epa & 3;
+                unsigned n = std::min<size_t>(4 - off, sz);
+                uint32_t v = peek(x, y, epa);
+                for (unsigned i = 0; i < n; i++)
+                        dst[i] = v >> (8 * (off + i));
+                dst += n;
+                epa += n;
+                sz -= n;
+        }
+        return true;
+}
+
+uint64_t LoopbackMachine::get_cycle()
+{
+        std::lock_guard<std::mutex> guard(lock);
+        return cycle;
+}
+
+/******************************************************************************/
+/* Fake Tiles                                                                 */
+/******************************************************************************/
+
+/**
+ * Send a request packet to the host as if a tile had sent it
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] rqst  A request packet whose destination is the host interface
+ * @return HB_MC_SUCCESS on success. HB_MC_INVALID if the destination is not the host.
+ */
+int hb_mc_loopback_tile_send(hb_mc_manycore_t *mc, const hb_mc_request_packet_t *rqst)
+{
+        LoopbackMachine *lb = hb_mc_platform_get_loopback(mc);
+        if (lb == nullptr)
+                return HB_MC_UNINITIALIZED;
+
+        if (!lb->tile_request(rqst)) {
+                char buf[256];
+                bsg_pr_err("%s: %s is not addressed to the host\n", __func__,
+                           hb_mc_request_packet_to_string(rqst, buf, sizeof(buf)));
+                return HB_MC_INVALID;
+        }
+
+        return HB_MC_SUCCESS;
+}
+
+/**
+ * Send a word store from a tile to the host, e.g. a finish packet
+ * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+ * @param[in] tile  The coordinate of the tile that sends the store
+ * @param[in] epa   The host EPA to store to
+ * @param[in] data  The word to store
+ * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+ */
+int hb_mc_loopback_tile_store(hb_mc_manycore_t *mc, hb_mc_coordinate_t tile,
+                              hb_mc_epa_t epa, uint32_t data)
+{
+        const hb_mc_config_t *cfg = hb_mc_manycore_get_config(mc);
+        hb_mc_coordinate_t host = hb_mc_config_get_host_interface(cfg);
+        hb_mc_request_packet_t rqst = {};
+
+        hb_mc_request_packet_set_x_dst(&rqst, host.x);
+        hb_mc_request_packet_set_y_dst(&rqst, host.y);
+        hb_mc_request_packet_set_x_src(&rqst, tile.x);
+        hb_mc_request_packet_set_y_src(&rqst, tile.y);
+        hb_mc_request_packet_set_epa(&rqst, epa);
+        hb_mc_request_packet_set_data(&rqst, data);
+        hb_mc_request_packet_set_op(&rqst, HB_MC_PACKET_OP_REMOTE_SW);
+
+        return hb_mc_loopback_tile_send(mc, &rqst);
+}
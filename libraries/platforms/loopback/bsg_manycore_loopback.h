@@ -0,0 +1,68 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Host-side fake tiles for the loopback platform. There are no cores
+// behind the loopback model, so a test that waits for a packet from
+// the manycore (e.g. a finish packet) sends it with these functions,
+// from the same thread or from another one.
+
+#ifndef __BSG_MANYCORE_LOOPBACK_H
+#define __BSG_MANYCORE_LOOPBACK_H
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_coordinate.h>
+#include <bsg_manycore_epa.h>
+#include <bsg_manycore_request_packet.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+        /**
+         * Send a request packet to the host as if a tile had sent it
+         * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] rqst  A request packet whose destination is the host interface
+         * @return HB_MC_SUCCESS on success. HB_MC_INVALID if the destination is not the host.
+         */
+        int hb_mc_loopback_tile_send(hb_mc_manycore_t *mc, const hb_mc_request_packet_t *rqst);
+
+        /**
+         * Send a word store from a tile to the host, e.g. a finish packet
+         * @param[in] mc    A manycore instance initialized with hb_mc_manycore_init()
+         * @param[in] tile  The coordinate of the tile that sends the store
+         * @param[in] epa   The host EPA to store to
+         * @param[in] data  The word to store
+         * @return HB_MC_SUCCESS on success. Otherwise an error code defined in bsg_manycore_errno.h.
+         */
+        int hb_mc_loopback_tile_store(hb_mc_manycore_t *mc, hb_mc_coordinate_t tile,
+                                      hb_mc_epa_t epa, uint32_t data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BSG_MANYCORE_LOOPBACK_H
@@ -0,0 +1,106 @@
+// Copyright (c) 2021, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// LoopbackMachine is an in-memory stand-in for HammerBlade hardware.
+// It keeps a sparse word store for every tile and vcache endpoint,
+// answers host loads and AMOs immediately, and queues requests that
+// a host-side fake tile sends to the host. There are no cores: it is
+// meant for measuring and testing the host runtime by itself.
+
+#ifndef __BSG_MANYCORE_LOOPBACK_HPP
+#define __BSG_MANYCORE_LOOPBACK_HPP
+
+#include <bsg_manycore.h>
+#include <bsg_manycore_config.h>
+#include <bsg_manycore_fifo.h>
+#include <bsg_manycore_npa.h>
+#include <bsg_manycore_packet.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class LoopbackMachine {
+public:
+        // Reads the configuration ROM at rom_path (ASCII, one
+        // 32-bit binary word per line).
+        LoopbackMachine(const std::string &rom_path);
+
+        // True if the configuration ROM was read and parsed
+        bool valid() const { return rom_valid; }
+
+        // Raw configuration ROM word at idx
+        hb_mc_config_raw_t config_at(unsigned idx) const { return rom[idx]; }
+
+        // Apply a request from the host to its destination. Loads
+        // and AMOs queue a response for host_receive(). Returns
+        // false if the request was dropped.
+        bool host_request(const hb_mc_request_packet_t *rqst);
+
+        // Pop the next packet for the host from the request or
+        // response queue. With a timeout of -1, waits for a fake
+        // tile on another thread; otherwise returns at once.
+        bool host_receive(hb_mc_fifo_rx_t type, hb_mc_packet_t *packet, long timeout);
+
+        // Queue a request from a tile to the host, e.g. a finish
+        // packet. The destination must be the host interface.
+        bool tile_request(const hb_mc_request_packet_t *rqst);
+
+        // DMA backdoor into a vcache endpoint
+        bool dram_write(const hb_mc_npa_t *npa, const void *data, size_t sz);
+        bool dram_read(const hb_mc_npa_t *npa, void *data, size_t sz);
+
+        // One cycle per packet that crossed the host interface
+        uint64_t get_cycle();
+
+private:
+        bool is_endpoint(hb_mc_idx_t x, hb_mc_idx_t y) const;
+        bool is_dram(hb_mc_idx_t x, hb_mc_idx_t y) const;
+        uint32_t &word(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa);
+        uint32_t peek(hb_mc_idx_t x, hb_mc_idx_t y, hb_mc_epa_t epa) const;
+
+        hb_mc_config_raw_t rom[HB_MC_CONFIG_MAX] = {};
+        hb_mc_config_t cfg = {};
+        bool rom_valid = false;
+
+        // Sparse NPA -> word store, keyed by loopback_key()
+        std::unordered_map<uint64_t, uint32_t> mem;
+
+        std::mutex lock;
+        std::condition_variable rx_cv;
+        std::deque<hb_mc_packet_t> rx_req;
+        std::deque<hb_mc_packet_t> rx_rsp;
+        uint64_t cycle = 0;
+};
+
+// The machine behind a manycore instance (defined by the platform)
+LoopbackMachine *hb_mc_platform_get_loopback(hb_mc_manycore_t *mc);
+
+#endif // __BSG_MANYCORE_LOOPBACK_HPP
@@ -0,0 +1,56 @@
+// Copyright (c) 2020, University of Washington All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+// Redistributions of source code must retain the above copyright notice, this list
+// of conditions and the following disclaimer.
+//
+// Redistributions in binary form must reproduce the above copyright notice, this
+// list of conditions and the following disclaimer in the documentation and/or
+// other materials provided with the distribution.
+//
+// Neither the name of the copyright holder nor the names of its contributors may
+// be used to endorse or promote products derived from this software without
+// specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+// ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+// ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// To make your program HammerBlade cross-platform compatible,
+// define a function with the signature of "main", and then
+// use this macro to mark it as the entry point of your program
+//
+// Example:
+//
+//    int MyMain(int argc, char *argv[]) {
+//        /* your code here */
+//    }
+//    declare_program_main("The name of your test", MyMain)
+//
+#define declare_program_main(test_name, name)                   \
+    int vcs_main(int argc, char *argv[]) {                      \
+        bsg_pr_test_info("Regression Test: %s\n", test_name);   \
+        int rc = name(argc, argv);                              \
+        bsg_pr_test_pass_fail(rc == HB_MC_SUCCESS);             \
+        return rc;                                              \
+    }
+
+extern int vcs_main(int argc, char *argv[]);
+
+#ifdef __cplusplus
+}
+#endif
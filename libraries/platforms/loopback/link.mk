@@ -0,0 +1,71 @@
+# Copyright (c) 2019, University of Washington All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without modification,
+# are permitted provided that the following conditions are met:
+#
+# Redistributions of source code must retain the above copyright notice, this list
+# of conditions and the following disclaimer.
+#
+# Redistributions in binary form must reproduce the above copyright notice, this
+# list of conditions and the following disclaimer in the documentation and/or
+# other materials provided with the distribution.
+#
+# Neither the name of the copyright holder nor the names of its contributors may
+# be used to endorse or promote products derived from this software without
+# specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+# ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+# ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# link.mk: Platform-specific link rules.
+#
+# The loopback model is linked into the runtime library, so the
+# executable is just the regression main.
+
+ORANGE=\033[0;33m
+RED=\033[0;31m
+NC=\033[0m
+
+ifndef BSG_PLATFORM_PATH
+$(error $(shell echo -e "$(RED)BSG MAKE ERROR: BSG_PLATFORM_PATH is not defined$(NC)"))
+endif
+
+include $(HARDWARE_PATH)/hardware.mk
+
+include $(LIBRARIES_PATH)/libraries.mk
+
+$(BSG_MACHINExPLATFORM_PATH)/exec:
+	mkdir -p $@
+
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: LD = $(CXX)
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: LDFLAGS  = -L$(BSG_PLATFORM_PATH) -Wl,-rpath=$(BSG_PLATFORM_PATH) -lbsg_manycore_regression -lbsg_manycore_runtime
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: LDFLAGS += -lm
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: LDFLAGS += -ldl
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: LDFLAGS += -lpthread
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: $(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: $(BSG_PLATFORM_PATH)/libbsgmc_cuda_legacy_pod_repl.so
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: $(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: $(BSG_MACHINE_PATH)/bsg_bladerunner_configuration.rom
+$(BSG_MACHINExPLATFORM_PATH)/exec/simsc: | $(BSG_MACHINExPLATFORM_PATH)/exec
+	$(LD) -o $@ $(LDFLAGS)
+
+.PRECIOUS: $(BSG_MACHINExPLATFORM_PATH)/exec/simsc
+
+REGRESSION_PREBUILD += $(BSG_MACHINExPLATFORM_PATH)/exec/simsc
+REGRESSION_PREBUILD += $(BSG_PLATFORM_PATH)/libbsgmc_cuda_legacy_pod_repl.so
+REGRESSION_PREBUILD += $(BSG_PLATFORM_PATH)/libbsg_manycore_runtime.so
+REGRESSION_PREBUILD += $(BSG_PLATFORM_PATH)/libbsg_manycore_regression.so
+
+.PHONY: platform.link.clean
+platform.link.clean:
+	rm -rf $(BSG_MACHINE_PATH)/$(BSG_PLATFORM)/
+
+link.clean: platform.link.clean ;
@@ -29,6 +29,7 @@
 // differences in simulators.
 
 #include <bsg_manycore_simulator.hpp>
+#include <bsg_manycore_errno.h>
 #include <svdpi.h>
 
 extern "C" {
@@ -59,6 +60,22 @@ void SimulationWrapper::eval(){
         svSetScope(prev);
 }
 
+// This testbench does not export a probe of the host link, so the
+// host cannot tell when to stop early. Advance one cycle.
+uint64_t SimulationWrapper::idle(uint64_t cycles){
+        eval();
+        return 1;
+}
+
+// Checkpointing is not supported by VCS from DPI.
+int SimulationWrapper::save(const std::string &path){
+        return HB_MC_NOIMPL;
+}
+
+int SimulationWrapper::restore(const std::string &path){
+        return HB_MC_NOIMPL;
+}
+
 SimulationWrapper::~SimulationWrapper(){
         this->top = nullptr;
 }